@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+/*!\file
+ * \brief Provides a pool of threads shared by several codec instances.
+ */
+#ifndef AOM_AOM_AOM_THREAD_POOL_H_
+#define AOM_AOM_AOM_THREAD_POOL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\brief Opaque pool of threads. */
+typedef struct aom_thread_pool aom_thread_pool_t;
+
+/*!\brief Creates a pool of threads.
+ *
+ * Encoder and decoder instances attached to the pool with the
+ * AV1E_SET_THREAD_POOL and AV1D_SET_THREAD_POOL controls run the jobs of
+ * their worker threads on the threads of the pool instead of starting threads
+ * of their own. Each instance still runs at most as many jobs at once as its
+ * configured number of threads, so that the total number of threads of a
+ * process running many instances can match the number of cores.
+ *
+ * \param[in] num_threads  Number of threads of the pool.
+ *
+ * \return The pool, or NULL if it could not be created or the library was
+ *         built without multithreading.
+ */
+aom_thread_pool_t *aom_thread_pool_create(int num_threads);
+
+/*!\brief Destroys a pool created with aom_thread_pool_create().
+ *
+ * Every codec instance attached to the pool must have been destroyed first.
+ *
+ * \param[in] pool  Pool to destroy. May be NULL.
+ */
+void aom_thread_pool_destroy(aom_thread_pool_t *pool);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AOM_AOM_THREAD_POOL_H_
@@ -18,6 +18,7 @@
  */
 #include "aom/aom.h"
 #include "aom/aom_encoder.h"
+#include "aom/aom_thread_pool.h"
 
 /*!\file
  * \brief Provides definitions for using AOM or AV1 encoder algorithm within the
@@ -1164,7 +1165,17 @@ enum aome_enc_control_id {
   /*!\brief Codec control function to set reference frame config:
    * the ref_idx and the refresh flags for each buffer slot.
    */
-  AV1E_SET_SVC_REF_FRAME_CONFIG = 152
+  AV1E_SET_SVC_REF_FRAME_CONFIG = 152,
+
+  /*!\brief Codec control function to run the worker threads of the encoder
+   * on the threads of an aom_thread_pool_t shared with other codec instances.
+   *
+   * The encoder still runs at most as many jobs at once as its configured
+   * number of threads. Must be called before the first frame is encoded, and
+   * the pool must outlive the encoder. Pass NULL (the default) for the
+   * encoder to start its own threads.
+   */
+  AV1E_SET_THREAD_POOL = 153
 };
 
 /*!\brief aom 1-D scaling mode
@@ -1646,6 +1657,9 @@ AOM_CTRL_USE_TYPE(AV1E_SET_SVC_PARAMS, aom_svc_params_t *)
 AOM_CTRL_USE_TYPE(AV1E_SET_SVC_REF_FRAME_CONFIG, aom_svc_ref_frame_config_t *)
 #define AOME_CTRL_AV1E_SET_SVC_REF_FRAME_CONFIG
 
+AOM_CTRL_USE_TYPE(AV1E_SET_THREAD_POOL, aom_thread_pool_t *)
+#define AOM_CTRL_AV1E_SET_THREAD_POOL
+
 /*!\endcond */
 /*! @} - end defgroup aom_encoder */
 #ifdef __cplusplus
@@ -27,6 +27,7 @@ extern "C" {
 
 /* Include controls common to both the encoder and decoder */
 #include "aom/aom.h"
+#include "aom/aom_thread_pool.h"
 
 /*!\name Algorithm interface for AV1
  *
@@ -76,6 +77,91 @@ typedef struct {
   int show_existing;
 } Av1DecodeReturn;
 
+/*!\brief Callback that reports rows of a frame which are final.
+ *
+ * \p img describes the frame being decoded. Luma rows \p start_row to
+ * \p end_row - 1 of \p img are fully reconstructed and post-filtered and will
+ * not be modified any more while the frame is decoded. Film grain, if any, is
+ * not applied to \p img. The ranges reported for a frame are contiguous,
+ * increasing and together cover the whole frame. The callback may be invoked
+ * from a tile worker thread, but never concurrently for the same decoder.
+ */
+typedef void (*aom_row_progress_cb)(void *ctx, const aom_image_t *img,
+                                    int start_row, int end_row);
+
+/*!\brief Structure to hold the row progress callback and context.
+ *
+ * Defines a structure to hold the row progress callback function and calling
+ * context.
+ */
+typedef struct aom_row_progress_init {
+  /*! Row progress callback. */
+  aom_row_progress_cb row_progress_cb;
+
+  /*! Row progress context. */
+  void *row_progress_ctx;
+} aom_row_progress_init;
+
+/*!\brief Frames whose reconstruction is skipped by AV1D_SET_SKIP_FRAMES. */
+typedef enum aom_skip_frames {
+  /*! Decode every frame. */
+  AOM_SKIP_FRAMES_NONE = 0,
+  /*! Skip frames that are not used as a reference by any later frame. */
+  AOM_SKIP_FRAMES_NON_REFERENCE = 1,
+  /*! Skip every frame that is not a key frame. */
+  AOM_SKIP_FRAMES_NON_KEY = 2,
+} aom_skip_frames_t;
+
+/*!\brief Number of 32-bit words in an aom_tile_mask_t. */
+#define AOM_TILE_MASK_WORDS 16
+
+/*!\brief Structure to hold the set of tiles decoded with AV1D_SET_TILE_MASK.
+ *
+ * Tiles are numbered in raster order, as tile_row * tile_cols + tile_col.
+ * Tile i is decoded when bit (i % 32) of mask[i / 32] is set.
+ */
+typedef struct aom_tile_mask {
+  /*! Bitmask of the tiles to decode. */
+  uint32_t mask[AOM_TILE_MASK_WORDS];
+} aom_tile_mask_t;
+
+/*!\brief Decoding stages timed by AV1D_SET_DECODE_TIMING. */
+typedef enum aom_decode_stage {
+  /*! Sequence and frame header parsing and frame setup. */
+  AOM_DECODE_STAGE_HEADER,
+  /*! Entropy decoding and reconstruction of the tiles. */
+  AOM_DECODE_STAGE_TILES,
+  /*! Deblocking loop filter. */
+  AOM_DECODE_STAGE_LOOP_FILTER,
+  /*! Constrained directional enhancement filter. */
+  AOM_DECODE_STAGE_CDEF,
+  /*! Superres upscaling. */
+  AOM_DECODE_STAGE_SUPERRES,
+  /*! Loop restoration. */
+  AOM_DECODE_STAGE_LOOP_RESTORATION,
+  /*! Film grain synthesis, done when the frame is output. */
+  AOM_DECODE_STAGE_FILM_GRAIN,
+  /*! Number of stages. */
+  AOM_DECODE_STAGES
+} aom_decode_stage_t;
+
+/*!\brief Structure to hold the time spent in each decoding stage.
+ *
+ * Times are in microseconds and cover the last call to aom_codec_decode(),
+ * plus the film grain synthesis of the frames it output.
+ */
+typedef struct aom_decode_timing {
+  /*! Wall clock time of each stage, indexed by aom_decode_stage_t. */
+  int64_t wall_us[AOM_DECODE_STAGES];
+  /*! CPU time of each stage. This is the CPU time of the calling thread,
+   * plus that of the tile workers for AOM_DECODE_STAGE_TILES. It is 0 where
+   * the platform does not report the CPU time of a thread. */
+  int64_t cpu_us[AOM_DECODE_STAGES];
+  /*! Total time the tile workers spent without a job while the tiles were
+   * decoded, waiting for a thread or for a row to become available. */
+  int64_t worker_idle_us;
+} aom_decode_timing_t;
+
 /*!\brief Structure to hold a tile's start address and size in the bitstream.
  *
  * Defines a structure to hold a tile's start address and size in the bitstream.
@@ -252,6 +338,111 @@ enum aom_dec_control_id {
    */
   AV1D_SET_SKIP_FILM_GRAIN,
 
+  /** control function to set an aom_row_progress_cb callback that is invoked
+   * as superblock rows of a frame become final, i.e. after all post-filters
+   * that affect them have run. When the frame has no loop filter, CDEF,
+   * superres or loop restoration, rows are reported as soon as they have been
+   * decoded in every tile column. Otherwise, with several threads, the rows
+   * are reported as the loop filter or the loop restoration finishes them,
+   * whichever runs last. Rows of frames whose last post-filter is CDEF or
+   * superres, or that are decoded on one thread, are reported once the frame
+   * is done. Pass a NULL callback to disable reporting.
+   */
+  AV1D_SET_ROW_PROGRESS_CALLBACK,
+
+  /** control function to allow a temporal unit to be passed to
+   * aom_codec_decode() in several pieces, e.g. one OBU or tile group at a
+   * time as it arrives from the network. Each piece must end on an OBU
+   * boundary. Tile groups are decoded as soon as they are received, and a
+   * frame is output once its last tile group has been decoded. Valid values
+   * are 0 (disabled, the default) and 1. This has no effect on Annex-B
+   * streams.
+   */
+  AV1D_SET_INCREMENTAL_DECODE,
+
+  /** control function to skip the reconstruction of some frames, e.g. to
+   * build thumbnails or a scene index. The value is one of aom_skip_frames_t.
+   * The headers of skipped frames are still parsed so that the decoder state
+   * stays correct, but their tiles are not decoded and they are not output,
+   * either directly or through show_existing_frame. A new value takes effect
+   * at the next key frame. The default is AOM_SKIP_FRAMES_NONE.
+   */
+  AV1D_SET_SKIP_FRAMES,
+
+  /** control function to skip the loop filter, CDEF and loop restoration on
+   * frames that are shown but never used as a reference. Only the output of
+   * these frames is affected, so no artifacts accumulate. Valid values are 0
+   * (disabled, the default) and 1.
+   */
+  AV1D_SET_SKIP_OUTPUT_ONLY_FILTERS,
+
+  /** control function to reconstruct only the luma plane. Chroma
+   * coefficients are still parsed, but chroma prediction, inverse transforms,
+   * CFL and the chroma planes of the loop filter, CDEF and loop restoration
+   * are skipped, and frames are output as monochrome images. A new value
+   * takes effect at the next key frame. Valid values are 0 (disabled, the
+   * default) and 1.
+   */
+  AV1D_SET_LUMA_ONLY,
+
+  /** control function to decode only a subset of the tiles of each frame,
+   * e.g. the viewport of a 360 degree video. The argument is a pointer to an
+   * aom_tile_mask_t, or NULL to decode every tile (the default). Tiles that
+   * are not selected are neither parsed nor reconstructed, and the loop
+   * filter, CDEF and loop restoration only run on the selected tiles, so the
+   * rest of the output frame is left untouched. The tile the frame context is
+   * updated from is still parsed, but not reconstructed. Pixels near the edge
+   * of the selected area depend on the unselected neighbours and so are not
+   * exact, and inter prediction and motion vector prediction from outside the
+   * selected area use stale data: the stream must be encoded with motion
+   * constrained tiles for the result to be exact. Frames that use superres
+   * are still upscaled as a whole. Row based multithreading is not used while
+   * a mask is set. This has no effect in large scale tile mode.
+   */
+  AV1D_SET_TILE_MASK,
+
+  /** control function to run the worker threads of the decoder on the
+   * threads of an aom_thread_pool_t shared with other codec instances. The
+   * decoder still runs at most as many jobs at once as its configured number
+   * of threads. Must be called before the first frame is decoded, and the
+   * pool must outlive the decoder. Pass NULL (the default) for the decoder to
+   * start its own threads.
+   */
+  AV1D_SET_THREAD_POOL,
+
+  /** control function to time the decoding stages, retrieved with
+   * AV1D_GET_DECODE_TIMING. Valid values are 0 (disabled, the default) and 1.
+   * Timing adds a few clock reads per stage and tile worker to each frame.
+   */
+  AV1D_SET_DECODE_TIMING,
+
+  /** control function to get the time spent in each decoding stage by the
+   * last call to aom_codec_decode(). The argument is a pointer to an
+   * aom_decode_timing_t. Returns AOM_CODEC_ERROR if timing is not enabled
+   * with AV1D_SET_DECODE_TIMING or no frame has been decoded.
+   */
+  AV1D_GET_DECODE_TIMING,
+
+  /** control function to get an estimate in bytes of the memory used by the
+   * decoder, including its worker threads and the frame buffers it allocated
+   * itself. Frame buffers returned by an external frame buffer callback are
+   * not included. The argument is a pointer to a size_t. The buffers of the
+   * decoder are sized for the superblock size, chroma subsampling and bit
+   * depth of the stream and the number of worker threads actually used, so
+   * the value grows as frames are decoded.
+   */
+  AV1D_GET_MEMORY_USAGE,
+
+  /** control function to prepare the decoder for a new stream, as if it had
+   * been destroyed and initialized again with the same configuration and
+   * controls. Pending output frames and reference frames are released, and
+   * the next frame must be a key frame preceded by a sequence header. The
+   * worker threads, frame buffers and other allocations of the decoder are
+   * kept and reused, and are only reallocated if the new stream needs larger
+   * or differently shaped ones. The argument is ignored.
+   */
+  AV1D_RESET_STREAM,
+
   AOM_DECODER_CTRL_ID_MAX,
 };
 
@@ -313,6 +504,28 @@ AOM_CTRL_USE_TYPE(AV1D_SET_OUTPUT_ALL_LAYERS, int)
 #define AOM_CTRL_AV1D_SET_OUTPUT_ALL_LAYERS
 AOM_CTRL_USE_TYPE(AV1_SET_INSPECTION_CALLBACK, aom_inspect_init *)
 #define AOM_CTRL_AV1_SET_INSPECTION_CALLBACK
+AOM_CTRL_USE_TYPE(AV1D_SET_ROW_PROGRESS_CALLBACK, aom_row_progress_init *)
+#define AOM_CTRL_AV1D_SET_ROW_PROGRESS_CALLBACK
+AOM_CTRL_USE_TYPE(AV1D_SET_INCREMENTAL_DECODE, int)
+#define AOM_CTRL_AV1D_SET_INCREMENTAL_DECODE
+AOM_CTRL_USE_TYPE(AV1D_SET_SKIP_FRAMES, int)
+#define AOM_CTRL_AV1D_SET_SKIP_FRAMES
+AOM_CTRL_USE_TYPE(AV1D_SET_SKIP_OUTPUT_ONLY_FILTERS, int)
+#define AOM_CTRL_AV1D_SET_SKIP_OUTPUT_ONLY_FILTERS
+AOM_CTRL_USE_TYPE(AV1D_SET_LUMA_ONLY, int)
+#define AOM_CTRL_AV1D_SET_LUMA_ONLY
+AOM_CTRL_USE_TYPE(AV1D_SET_TILE_MASK, const aom_tile_mask_t *)
+#define AOM_CTRL_AV1D_SET_TILE_MASK
+AOM_CTRL_USE_TYPE(AV1D_SET_THREAD_POOL, aom_thread_pool_t *)
+#define AOM_CTRL_AV1D_SET_THREAD_POOL
+AOM_CTRL_USE_TYPE(AV1D_SET_DECODE_TIMING, int)
+#define AOM_CTRL_AV1D_SET_DECODE_TIMING
+AOM_CTRL_USE_TYPE(AV1D_GET_DECODE_TIMING, aom_decode_timing_t *)
+#define AOM_CTRL_AV1D_GET_DECODE_TIMING
+AOM_CTRL_USE_TYPE(AV1D_GET_MEMORY_USAGE, size_t *)
+#define AOM_CTRL_AV1D_GET_MEMORY_USAGE
+AOM_CTRL_USE_TYPE(AV1D_RESET_STREAM, int)
+#define AOM_CTRL_AV1D_RESET_STREAM
 /*!\endcond */
 /*! @} - end defgroup aom_decoder */
 
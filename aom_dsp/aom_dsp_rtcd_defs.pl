@@ -957,6 +957,9 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   specialize qw/aom_mse8x16           sse2           msa/;
   specialize qw/aom_mse8x8            sse2           msa/;
 
+  add_proto qw/uint64_t aom_mse_wxh_16bit/, "const uint16_t *dst, int dstride, const uint16_t *src, int sstride, int w, int h";
+  specialize qw/aom_mse_wxh_16bit     sse2 avx2/;
+
   if (aom_config("CONFIG_AV1_HIGHBITDEPTH") eq "yes") {
     foreach $bd (8, 10, 12) {
       add_proto qw/void/, "aom_highbd_${bd}_get16x16var", "const uint8_t *src_ptr, int source_stride, const uint8_t *ref_ptr, int ref_stride, unsigned int *sse, int *sum";
@@ -20,8 +20,8 @@
 #define EC_PROB_SHIFT 6
 #define EC_MIN_PROB 4  // must be <= (1<<EC_PROB_SHIFT)/16
 
-/*OPT: od_ec_window must be at least 32 bits, but if you have fast arithmetic
-   on a larger type, you can speed up the decoder by using it here.*/
+/*OPT: od_ec_window must be at least 32 bits.
+  The decoder uses its own, wider window type (see od_ec_dec_window).*/
 typedef uint32_t od_ec_window;
 
 /*The size in bits of od_ec_window.*/
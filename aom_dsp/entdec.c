@@ -73,11 +73,19 @@
   Even relatively modest values like 100 would work fine.*/
 #define OD_EC_LOTS_OF_BITS (0x4000)
 
+/*Reads 8 bytes from buf as a big-endian value.*/
+static INLINE od_ec_dec_window od_ec_dec_load_be64(const unsigned char *buf) {
+  return (od_ec_dec_window)buf[0] << 56 | (od_ec_dec_window)buf[1] << 48 |
+         (od_ec_dec_window)buf[2] << 40 | (od_ec_dec_window)buf[3] << 32 |
+         (od_ec_dec_window)buf[4] << 24 | (od_ec_dec_window)buf[5] << 16 |
+         (od_ec_dec_window)buf[6] << 8 | (od_ec_dec_window)buf[7];
+}
+
 /*The return value of od_ec_dec_tell does not change across an od_ec_dec_refill
    call.*/
 static void od_ec_dec_refill(od_ec_dec *dec) {
   int s;
-  od_ec_window dif;
+  od_ec_dec_window dif;
   int16_t cnt;
   const unsigned char *bptr;
   const unsigned char *end;
@@ -85,13 +93,25 @@ static void od_ec_dec_refill(od_ec_dec *dec) {
   cnt = dec->cnt;
   bptr = dec->bptr;
   end = dec->end;
-  s = OD_EC_WINDOW_SIZE - 9 - (cnt + 15);
+  s = OD_EC_DEC_WINDOW_SIZE - 9 - (cnt + 15);
+  if (s >= 0 && end - bptr >= 8) {
+    /*Insert all the bytes that fit into the window at once. The 8 bytes are
+       loaded big-endian so that the first one lands in the most significant
+       position; only the first n of them are consumed.*/
+    const int n = (s >> 3) + 1;
+    assert(n < 8);
+    dif ^= (od_ec_dec_load_be64(bptr) >> (OD_EC_DEC_WINDOW_SIZE - 8 * n))
+           << (s & 7);
+    bptr += n;
+    cnt += 8 * n;
+    s -= 8 * n;
+  }
   for (; s >= 0 && bptr < end; s -= 8, bptr++) {
     /*Each time a byte is inserted into the window (dif), bptr advances and cnt
        is incremented by 8, so the total number of consumed bits (the return
        value of od_ec_dec_tell) does not change.*/
-    assert(s <= OD_EC_WINDOW_SIZE - 8);
-    dif ^= (od_ec_window)bptr[0] << s;
+    assert(s <= OD_EC_DEC_WINDOW_SIZE - 8);
+    dif ^= (od_ec_dec_window)bptr[0] << s;
     cnt += 8;
   }
   if (bptr >= end) {
@@ -122,8 +142,8 @@ static void od_ec_dec_refill(od_ec_dec *dec) {
   ret: The value to return.
   Return: ret.
           This allows the compiler to jump to this function via a tail-call.*/
-static int od_ec_dec_normalize(od_ec_dec *dec, od_ec_window dif, unsigned rng,
-                               int ret) {
+static int od_ec_dec_normalize(od_ec_dec *dec, od_ec_dec_window dif,
+                               unsigned rng, int ret) {
   int d;
   assert(rng <= 65535U);
   /*The number of leading zeros in the 16-bit binary representation of rng.*/
@@ -143,10 +163,13 @@ static int od_ec_dec_normalize(od_ec_dec *dec, od_ec_window dif, unsigned rng,
 void od_ec_dec_init(od_ec_dec *dec, const unsigned char *buf,
                     uint32_t storage) {
   dec->buf = buf;
-  dec->tell_offs = 10 - (OD_EC_WINDOW_SIZE - 8);
+  /*Every byte od_ec_dec_refill() inserts advances bptr and cnt together, so
+     starting from cnt = -15 this makes od_ec_dec_tell() return 1, as
+     od_ec_enc_tell() does, whatever the window size.*/
+  dec->tell_offs = -14;
   dec->end = buf + storage;
   dec->bptr = buf;
-  dec->dif = ((od_ec_window)1 << (OD_EC_WINDOW_SIZE - 1)) - 1;
+  dec->dif = ((od_ec_dec_window)1 << (OD_EC_DEC_WINDOW_SIZE - 1)) - 1;
   dec->rng = 0x8000;
   dec->cnt = -15;
   od_ec_dec_refill(dec);
@@ -156,8 +179,8 @@ void od_ec_dec_init(od_ec_dec *dec, const unsigned char *buf,
   f: The probability that the bit is one, scaled by 32768.
   Return: The value decoded (0 or 1).*/
 int od_ec_decode_bool_q15(od_ec_dec *dec, unsigned f) {
-  od_ec_window dif;
-  od_ec_window vw;
+  od_ec_dec_window dif;
+  od_ec_dec_window vw;
   unsigned r;
   unsigned r_new;
   unsigned v;
@@ -166,11 +189,11 @@ int od_ec_decode_bool_q15(od_ec_dec *dec, unsigned f) {
   assert(f < 32768U);
   dif = dec->dif;
   r = dec->rng;
-  assert(dif >> (OD_EC_WINDOW_SIZE - 16) < r);
+  assert(dif >> (OD_EC_DEC_WINDOW_SIZE - 16) < r);
   assert(32768U <= r);
   v = ((r >> 8) * (uint32_t)(f >> EC_PROB_SHIFT) >> (7 - EC_PROB_SHIFT));
   v += EC_MIN_PROB;
-  vw = (od_ec_window)v << (OD_EC_WINDOW_SIZE - 16);
+  vw = (od_ec_dec_window)v << (OD_EC_DEC_WINDOW_SIZE - 16);
   ret = 1;
   r_new = v;
   if (dif >= vw) {
@@ -191,7 +214,7 @@ int od_ec_decode_bool_q15(od_ec_dec *dec, unsigned f) {
          This should be at most 16.
   Return: The decoded symbol s.*/
 int od_ec_decode_cdf_q15(od_ec_dec *dec, const uint16_t *icdf, int nsyms) {
-  od_ec_window dif;
+  od_ec_dec_window dif;
   unsigned r;
   unsigned c;
   unsigned u;
@@ -202,11 +225,11 @@ int od_ec_decode_cdf_q15(od_ec_dec *dec, const uint16_t *icdf, int nsyms) {
   r = dec->rng;
   const int N = nsyms - 1;
 
-  assert(dif >> (OD_EC_WINDOW_SIZE - 16) < r);
+  assert(dif >> (OD_EC_DEC_WINDOW_SIZE - 16) < r);
   assert(icdf[nsyms - 1] == OD_ICDF(CDF_PROB_TOP));
   assert(32768U <= r);
   assert(7 - EC_PROB_SHIFT - CDF_SHIFT >= 0);
-  c = (unsigned)(dif >> (OD_EC_WINDOW_SIZE - 16));
+  c = (unsigned)(dif >> (OD_EC_DEC_WINDOW_SIZE - 16));
   v = r;
   ret = -1;
   do {
@@ -218,7 +241,7 @@ int od_ec_decode_cdf_q15(od_ec_dec *dec, const uint16_t *icdf, int nsyms) {
   assert(v < u);
   assert(u <= r);
   r = u - v;
-  dif -= (od_ec_window)v << (OD_EC_WINDOW_SIZE - 16);
+  dif -= (od_ec_dec_window)v << (OD_EC_DEC_WINDOW_SIZE - 16);
   return od_ec_dec_normalize(dec, dif, r, ret);
 }
 
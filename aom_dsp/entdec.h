@@ -20,6 +20,14 @@ extern "C" {
 
 typedef struct od_ec_dec od_ec_dec;
 
+/*The decoder window is wider than the encoder's od_ec_window: a 64-bit window
+   needs to be refilled less often and lets od_ec_dec_refill() insert several
+   bytes with a single load.*/
+typedef uint64_t od_ec_dec_window;
+
+/*The size in bits of od_ec_dec_window.*/
+#define OD_EC_DEC_WINDOW_SIZE ((int)sizeof(od_ec_dec_window) * CHAR_BIT)
+
 #if defined(OD_ACCOUNTING) && OD_ACCOUNTING
 #define OD_ACC_STR , char *acc_str
 #define od_ec_dec_bits(dec, ftb, str) od_ec_dec_bits_(dec, ftb, str)
@@ -43,12 +51,12 @@ struct od_ec_dec {
   const unsigned char *bptr;
   /*The difference between the high end of the current range, (low + rng), and
      the coded value, minus 1.
-    This stores up to OD_EC_WINDOW_SIZE bits of that difference, but the
+    This stores up to OD_EC_DEC_WINDOW_SIZE bits of that difference, but the
      decoder only uses the top 16 bits of the window to decode the next symbol.
     As we shift up during renormalization, if we don't have enough bits left in
      the window to fill the top 16, we'll read in more bits of the coded
      value.*/
-  od_ec_window dif;
+  od_ec_dec_window dif;
   /*The number of values in the current range.*/
   uint16_t rng;
   /*The number of bits of data in the current value.*/
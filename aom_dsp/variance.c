@@ -264,6 +264,18 @@ MSE(16, 8)
 MSE(8, 16)
 MSE(8, 8)
 
+uint64_t aom_mse_wxh_16bit_c(const uint16_t *dst, int dstride,
+                             const uint16_t *src, int sstride, int w, int h) {
+  uint64_t sum = 0;
+  for (int i = 0; i < h; i++) {
+    for (int j = 0; j < w; j++) {
+      const int e = dst[i * dstride + j] - src[i * sstride + j];
+      sum += e * e;
+    }
+  }
+  return sum;
+}
+
 void aom_comp_avg_pred_c(uint8_t *comp_pred, const uint8_t *pred, int width,
                          int height, const uint8_t *ref, int ref_stride) {
   int i, j;
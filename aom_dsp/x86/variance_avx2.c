@@ -9,11 +9,14 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <assert.h>
 #include <immintrin.h>
 
 #include "config/aom_dsp_rtcd.h"
 
 #include "aom_dsp/x86/masked_variance_intrin_ssse3.h"
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
 
 static INLINE __m128i mm256_add_hi_lo_epi16(const __m256i val) {
   return _mm_add_epi16(_mm256_castsi256_si128(val),
@@ -230,6 +233,48 @@ unsigned int aom_mse16x16_avx2(const uint8_t *src, int src_stride,
   return *sse;
 }
 
+// The pixels have at most 12 bits, so their differences fit in 16 bits, and
+// the sums of 8 squared differences of each lane fit in 32 bits.
+uint64_t aom_mse_wxh_16bit_avx2(const uint16_t *dst, int dstride,
+                                const uint16_t *src, int sstride, int w,
+                                int h) {
+  __m256i sum = _mm256_setzero_si256();
+  uint64_t sse;
+  assert((w == 8 || w == 4) && (h == 8 || h == 4));
+  if (w == 8) {
+    for (int i = 0; i < h; i += 2) {
+      const uint16_t *const d0 = dst + i * dstride;
+      const uint16_t *const s0 = src + i * sstride;
+      const __m256i d = yy_loadu2_128(d0 + dstride, d0);
+      const __m256i s = yy_loadu2_128(s0 + sstride, s0);
+      const __m256i e = _mm256_sub_epi16(d, s);
+      sum = _mm256_add_epi32(sum, _mm256_madd_epi16(e, e));
+    }
+  } else {
+    for (int i = 0; i < h; i += 4) {
+      const uint16_t *const d0 = dst + i * dstride;
+      const uint16_t *const s0 = src + i * sstride;
+      const __m256i d = yy_set_m128i(
+          _mm_unpacklo_epi64(xx_loadl_64(d0 + 2 * dstride),
+                             xx_loadl_64(d0 + 3 * dstride)),
+          _mm_unpacklo_epi64(xx_loadl_64(d0), xx_loadl_64(d0 + dstride)));
+      const __m256i s = yy_set_m128i(
+          _mm_unpacklo_epi64(xx_loadl_64(s0 + 2 * sstride),
+                             xx_loadl_64(s0 + 3 * sstride)),
+          _mm_unpacklo_epi64(xx_loadl_64(s0), xx_loadl_64(s0 + sstride)));
+      const __m256i e = _mm256_sub_epi16(d, s);
+      sum = _mm256_add_epi32(sum, _mm256_madd_epi16(e, e));
+    }
+  }
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sum_128 = mm256_add_hi_lo_epi32(sum);
+  sum_128 = _mm_add_epi64(_mm_unpacklo_epi32(sum_128, zero),
+                          _mm_unpackhi_epi32(sum_128, zero));
+  sum_128 = _mm_add_epi64(sum_128, _mm_srli_si128(sum_128, 8));
+  xx_storel_64(&sse, sum_128);
+  return sse;
+}
+
 unsigned int aom_sub_pixel_variance32xh_avx2(const uint8_t *src, int src_stride,
                                              int x_offset, int y_offset,
                                              const uint8_t *dst, int dst_stride,
@@ -337,6 +337,41 @@ unsigned int aom_mse16x16_sse2(const uint8_t *src, int src_stride,
   return *sse;
 }
 
+// The pixels have at most 12 bits, so their differences fit in 16 bits, and
+// the sums of 16 squared differences of each lane fit in 32 bits.
+uint64_t aom_mse_wxh_16bit_sse2(const uint16_t *dst, int dstride,
+                                const uint16_t *src, int sstride, int w,
+                                int h) {
+  __m128i sum = _mm_setzero_si128();
+  uint64_t sse;
+  assert((w == 8 || w == 4) && (h == 8 || h == 4));
+  if (w == 8) {
+    for (int i = 0; i < h; i++) {
+      const __m128i d = xx_loadu_128(dst + i * dstride);
+      const __m128i s = xx_loadu_128(src + i * sstride);
+      const __m128i e = _mm_sub_epi16(d, s);
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(e, e));
+    }
+  } else {
+    for (int i = 0; i < h; i += 2) {
+      const uint16_t *const d0 = dst + i * dstride;
+      const uint16_t *const s0 = src + i * sstride;
+      const __m128i d =
+          _mm_unpacklo_epi64(xx_loadl_64(d0), xx_loadl_64(d0 + dstride));
+      const __m128i s =
+          _mm_unpacklo_epi64(xx_loadl_64(s0), xx_loadl_64(s0 + sstride));
+      const __m128i e = _mm_sub_epi16(d, s);
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(e, e));
+    }
+  }
+  const __m128i zero = _mm_setzero_si128();
+  sum = _mm_add_epi64(_mm_unpacklo_epi32(sum, zero),
+                      _mm_unpackhi_epi32(sum, zero));
+  sum = _mm_add_epi64(sum, _mm_srli_si128(sum, 8));
+  xx_storel_64(&sse, sum);
+  return sse;
+}
+
 // The 2 unused parameters are place holders for PIC enabled build.
 // These definitions are for functions defined in subpel_variance.asm
 #define DECL(w, opt)                                                           \
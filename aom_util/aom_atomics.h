@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AOM_UTIL_AOM_ATOMICS_H_
+#define AOM_AOM_UTIL_AOM_ATOMICS_H_
+
+#include "config/aom_config.h"
+
+#include "aom_ports/mem.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+#if CONFIG_MULTITHREAD
+
+// Look for built-in atomic support. We cannot use <stdatomic.h> or <atomic>
+// as the former is unavailable in MSVC and the latter is C++ only.
+#if defined(__has_builtin) && !defined(__ATOMIC_RELAXED)
+#if __has_builtin(__atomic_load_n) && __has_builtin(__atomic_store_n) && \
+    __has_builtin(__atomic_fetch_add)
+#define __ATOMIC_RELAXED 0
+#define __ATOMIC_ACQUIRE 2
+#define __ATOMIC_RELEASE 3
+#define __ATOMIC_ACQ_REL 4
+#define __ATOMIC_SEQ_CST 5
+#endif
+#endif
+
+#if defined(__ATOMIC_RELAXED)
+#define AOM_USE_ATOMIC_BUILTINS 1
+#elif defined(_MSC_VER)
+#include <intrin.h>  // NOLINT
+#if defined(_M_IX86) || defined(_M_X64)
+#define AOM_USE_INTERLOCKED 1
+// On x86 aligned 32-bit loads have acquire and stores have release semantics,
+// so a compiler barrier is enough.
+#define aom_atomic_memory_barrier() _ReadWriteBarrier()
+#else
+#define AOM_USE_INTERLOCKED 1
+#define aom_atomic_memory_barrier() __dmb(_ARM_BARRIER_ISH)
+#endif
+#else
+#error Atomic builtins are required when CONFIG_MULTITHREAD is enabled.
+#endif
+
+#endif  // CONFIG_MULTITHREAD
+
+// An int that is read and written by several threads without a lock.
+typedef struct {
+  volatile int value;
+} aom_atomic_int;
+
+static INLINE void aom_atomic_init(aom_atomic_int *atomic, int value) {
+  atomic->value = value;
+}
+
+// Loads the value. Later reads and writes of the calling thread are not
+// reordered before the load.
+static INLINE int aom_atomic_load_acquire(const aom_atomic_int *atomic) {
+#if CONFIG_MULTITHREAD && AOM_USE_ATOMIC_BUILTINS
+  return __atomic_load_n(&atomic->value, __ATOMIC_ACQUIRE);
+#elif CONFIG_MULTITHREAD && AOM_USE_INTERLOCKED
+  const int value = atomic->value;
+  aom_atomic_memory_barrier();
+  return value;
+#else
+  return atomic->value;
+#endif
+}
+
+// Stores the value. Earlier reads and writes of the calling thread are not
+// reordered after the store.
+static INLINE void aom_atomic_store_release(aom_atomic_int *atomic, int value) {
+#if CONFIG_MULTITHREAD && AOM_USE_ATOMIC_BUILTINS
+  __atomic_store_n(&atomic->value, value, __ATOMIC_RELEASE);
+#elif CONFIG_MULTITHREAD && AOM_USE_INTERLOCKED
+  aom_atomic_memory_barrier();
+  atomic->value = value;
+#else
+  atomic->value = value;
+#endif
+}
+
+// Adds 'delta' to the value as a single atomic operation and returns the
+// previous value.
+static INLINE int aom_atomic_fetch_add(aom_atomic_int *atomic, int delta) {
+#if CONFIG_MULTITHREAD && AOM_USE_ATOMIC_BUILTINS
+  return __atomic_fetch_add(&atomic->value, delta, __ATOMIC_ACQ_REL);
+#elif CONFIG_MULTITHREAD && AOM_USE_INTERLOCKED
+  return _InterlockedExchangeAdd((volatile long *)&atomic->value, delta);
+#else
+  const int value = atomic->value;
+  atomic->value += delta;
+  return value;
+#endif
+}
+
+#if CONFIG_MULTITHREAD
+// Tells the CPU that the caller is polling a value written by another thread,
+// so that the poll loop yields to a sibling hardware thread and does not stall
+// on a memory order violation when the value changes.
+static INLINE void aom_cpu_relax(void) {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+  _mm_pause();
+#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+  __yield();
+#elif defined(__i386__) || defined(__x86_64__)
+  __asm__ __volatile__("pause");
+#elif defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+  __asm__ __volatile__("yield");
+#endif
+}
+#endif  // CONFIG_MULTITHREAD
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // AOM_AOM_UTIL_AOM_ATOMICS_H_
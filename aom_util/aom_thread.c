@@ -22,6 +22,10 @@
 
 #include <assert.h>
 #include <string.h>  // for memset()
+#include <time.h>
+#if defined(_WIN32)
+#include <windows.h>  // NOLINT
+#endif
 
 #include "aom_mem/aom_mem.h"
 #include "aom_util/aom_thread.h"
@@ -32,6 +36,19 @@ struct AVxWorkerImpl {
   pthread_mutex_t mutex_;
   pthread_cond_t condition_;
   pthread_t thread_;
+  // Next worker in the queue of the pool the worker is attached to.
+  AVxWorker *next_;
+};
+
+struct aom_thread_pool {
+  pthread_mutex_t mutex_;
+  pthread_cond_t condition_;
+  pthread_t *threads_;
+  int num_threads_;
+  // Launched workers waiting for a thread, in launch order.
+  AVxWorker *head_;
+  AVxWorker *tail_;
+  int shutdown_;
 };
 
 //------------------------------------------------------------------------------
@@ -82,6 +99,47 @@ static THREADFN thread_loop(void *ptr) {
 }
 
 // main thread state control
+static THREADFN pool_thread_loop(void *ptr) {
+  AVxThreadPool *const pool = (AVxThreadPool *)ptr;
+  pthread_mutex_lock(&pool->mutex_);
+  while (1) {
+    while (pool->head_ == NULL && !pool->shutdown_) {
+      pthread_cond_wait(&pool->condition_, &pool->mutex_);
+    }
+    if (pool->head_ == NULL) break;  // shutdown_ is set
+    AVxWorker *const worker = pool->head_;
+    pool->head_ = worker->impl_->next_;
+    if (pool->head_ == NULL) pool->tail_ = NULL;
+    pthread_mutex_unlock(&pool->mutex_);
+
+    execute(worker);
+    // The worker may be ended as soon as its status is OK, so it must not be
+    // accessed after the mutex is released.
+    pthread_mutex_lock(&worker->impl_->mutex_);
+    worker->status_ = OK;
+    pthread_cond_signal(&worker->impl_->condition_);
+    pthread_mutex_unlock(&worker->impl_->mutex_);
+
+    pthread_mutex_lock(&pool->mutex_);
+  }
+  pthread_mutex_unlock(&pool->mutex_);
+  return THREAD_RETURN(NULL);
+}
+
+// Queues a worker whose status has been set to WORK for a thread of its pool.
+static void pool_enqueue(AVxThreadPool *const pool, AVxWorker *const worker) {
+  worker->impl_->next_ = NULL;
+  pthread_mutex_lock(&pool->mutex_);
+  if (pool->tail_ != NULL) {
+    pool->tail_->impl_->next_ = worker;
+  } else {
+    pool->head_ = worker;
+  }
+  pool->tail_ = worker;
+  pthread_cond_signal(&pool->condition_);
+  pthread_mutex_unlock(&pool->mutex_);
+}
+
 static void change_state(AVxWorker *const worker, AVxWorkerStatus new_status) {
   // No-op when attempting to change state on a thread that didn't come up.
   // Checking status_ without acquiring the lock first would result in a data
@@ -137,7 +195,9 @@ static int reset(AVxWorker *const worker) {
       goto Error;
     }
     pthread_mutex_lock(&worker->impl_->mutex_);
-    ok = !pthread_create(&worker->impl_->thread_, NULL, thread_loop, worker);
+    // Workers attached to a pool have no thread of their own.
+    ok = worker->pool != NULL ||
+         !pthread_create(&worker->impl_->thread_, NULL, thread_loop, worker);
     if (ok) worker->status_ = OK;
     pthread_mutex_unlock(&worker->impl_->mutex_);
     if (!ok) {
@@ -167,6 +227,8 @@ static void execute(AVxWorker *const worker) {
 static void launch(AVxWorker *const worker) {
 #if CONFIG_MULTITHREAD
   change_state(worker, WORK);
+  if (worker->pool != NULL && worker->impl_ != NULL)
+    pool_enqueue(worker->pool, worker);
 #else
   execute(worker);
 #endif
@@ -176,7 +238,7 @@ static void end(AVxWorker *const worker) {
 #if CONFIG_MULTITHREAD
   if (worker->impl_ != NULL) {
     change_state(worker, NOT_OK);
-    pthread_join(worker->impl_->thread_, NULL);
+    if (worker->pool == NULL) pthread_join(worker->impl_->thread_, NULL);
     pthread_mutex_destroy(&worker->impl_->mutex_);
     pthread_cond_destroy(&worker->impl_->condition_);
     aom_free(worker->impl_);
@@ -209,4 +271,80 @@ const AVxWorkerInterface *aom_get_worker_interface(void) {
   return &g_worker_interface;
 }
 
+int64_t aom_thread_cpu_usec(void) {
+#if defined(_WIN32)
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time,
+                      &kernel_time, &user_time))
+    return 0;
+  // FILETIME counts 100 nanosecond intervals.
+  const uint64_t kernel = ((uint64_t)kernel_time.dwHighDateTime << 32) |
+                          kernel_time.dwLowDateTime;
+  const uint64_t user =
+      ((uint64_t)user_time.dwHighDateTime << 32) | user_time.dwLowDateTime;
+  return (int64_t)((kernel + user) / 10);
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)) return 0;
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+  return 0;
+#endif
+}
+
 //------------------------------------------------------------------------------
+
+AVxThreadPool *aom_thread_pool_create(int num_threads) {
+#if CONFIG_MULTITHREAD
+  if (num_threads < 1) return NULL;
+  AVxThreadPool *const pool = (AVxThreadPool *)aom_calloc(1, sizeof(*pool));
+  if (pool == NULL) return NULL;
+  pool->threads_ =
+      (pthread_t *)aom_calloc(num_threads, sizeof(*pool->threads_));
+  if (pool->threads_ == NULL) {
+    aom_free(pool);
+    return NULL;
+  }
+  if (pthread_mutex_init(&pool->mutex_, NULL)) {
+    aom_free(pool->threads_);
+    aom_free(pool);
+    return NULL;
+  }
+  if (pthread_cond_init(&pool->condition_, NULL)) {
+    pthread_mutex_destroy(&pool->mutex_);
+    aom_free(pool->threads_);
+    aom_free(pool);
+    return NULL;
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    if (pthread_create(&pool->threads_[i], NULL, pool_thread_loop, pool)) {
+      aom_thread_pool_destroy(pool);
+      return NULL;
+    }
+    ++pool->num_threads_;
+  }
+  return pool;
+#else
+  (void)num_threads;
+  return NULL;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void aom_thread_pool_destroy(AVxThreadPool *pool) {
+#if CONFIG_MULTITHREAD
+  if (pool == NULL) return;
+  pthread_mutex_lock(&pool->mutex_);
+  pool->shutdown_ = 1;
+  pthread_cond_broadcast(&pool->condition_);
+  pthread_mutex_unlock(&pool->mutex_);
+  for (int i = 0; i < pool->num_threads_; ++i) {
+    pthread_join(pool->threads_[i], NULL);
+  }
+  pthread_mutex_destroy(&pool->mutex_);
+  pthread_cond_destroy(&pool->condition_);
+  aom_free(pool->threads_);
+  aom_free(pool);
+#else
+  (void)pool;
+#endif  // CONFIG_MULTITHREAD
+}
@@ -19,6 +19,9 @@
 
 #include "config/aom_config.h"
 
+#include "aom/aom_integer.h"
+#include "aom/aom_thread_pool.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -377,6 +380,10 @@ typedef int (*AVxWorkerHook)(void *, void *);
 // Platform-dependent implementation details for the worker.
 typedef struct AVxWorkerImpl AVxWorkerImpl;
 
+// Pool of threads that run the hooks of the workers attached to it, so that
+// the workers of several encoder and decoder instances share their threads.
+typedef struct aom_thread_pool AVxThreadPool;
+
 // Synchronization object used to launch job in the worker thread
 typedef struct {
   AVxWorkerImpl *impl_;
@@ -389,6 +396,9 @@ typedef struct {
   void *data1;         // first argument passed to 'hook'
   void *data2;         // second argument passed to 'hook'
   int had_error;       // true if a call to 'hook' returned false
+  // If not NULL, 'hook' is called by a thread of this pool instead of a thread
+  // owned by the worker. Must be set before the first call to reset().
+  AVxThreadPool *pool;
 } AVxWorker;
 
 // The interface for all thread-worker related functions. All these functions
@@ -426,6 +436,10 @@ int aom_set_worker_interface(const AVxWorkerInterface *const winterface);
 // Retrieve the currently set thread worker interface.
 const AVxWorkerInterface *aom_get_worker_interface(void);
 
+// Returns the CPU time used so far by the calling thread in microseconds, or 0
+// if the platform does not report it.
+int64_t aom_thread_cpu_usec(void);
+
 //------------------------------------------------------------------------------
 
 #ifdef __cplusplus
@@ -30,10 +30,14 @@
 #include "aom/aomdx.h"
 #include "aom_ports/aom_timer.h"
 #include "aom_ports/mem_ops.h"
+#if CONFIG_MULTITHREAD
+#include "aom_util/aom_thread.h"
+#endif
 #include "common/args.h"
 #include "common/ivfdec.h"
 #include "common/md5_utils.h"
 #include "common/obudec.h"
+#include "common/seek_index.h"
 #include "common/tools_common.h"
 
 #if CONFIG_WEBM_IO
@@ -106,6 +110,18 @@ static const arg_def_t outallarg = ARG_DEF(
     NULL, "all-layers", 0, "Output all decoded frames of a scalable bitstream");
 static const arg_def_t skipfilmgrain =
     ARG_DEF(NULL, "skip-film-grain", 0, "Skip film grain application");
+static const arg_def_t seekarg =
+    ARG_DEF(NULL, "seek", 1,
+            "Start decoding at the last key frame with a sequence header at "
+            "or before this pts (frame number for OBU input)");
+static const arg_def_t seekindexarg =
+    ARG_DEF(NULL, "seek-index", 1,
+            "Seek index of the input, written by scanning the input if it "
+            "is missing or stale");
+static const arg_def_t pipelinearg =
+    ARG_DEF(NULL, "pipeline", 1,
+            "Read, decode and output frames on separate threads, queuing up "
+            "to arg frames between them");
 
 static const arg_def_t *all_args[] = {
   &help,           &codecarg,   &use_yv12,      &use_i420,
@@ -114,7 +130,8 @@ static const arg_def_t *all_args[] = {
   &outputfile,     &threadsarg, &verbosearg,    &scalearg,
   &fb_arg,         &md5arg,     &framestatsarg, &continuearg,
   &outbitdeptharg, &isannexb,   &oppointarg,    &outallarg,
-  &skipfilmgrain,  NULL
+  &skipfilmgrain,  &seekarg,     &seekindexarg,  &pipelinearg,
+  NULL
 };
 
 #if CONFIG_LIBYUV
@@ -247,6 +264,105 @@ static int read_frame(struct AvxDecInputContext *input, uint8_t **buf,
   }
 }
 
+// Returns the offset in the input file of the next frame, or -1 if the input
+// type does not support seeking.
+static int64_t tell_input(struct AvxDecInputContext *input) {
+  switch (input->aom_input_ctx->file_type) {
+    case FILE_TYPE_IVF: return (int64_t)ftello(input->aom_input_ctx->file);
+    case FILE_TYPE_OBU: return obudec_tell_temporal_unit(input->obu_ctx);
+    default: return -1;
+  }
+}
+
+// Makes the frame at 'offset', a value returned by tell_input(), the next
+// one read. Returns 0 on success.
+static int seek_input(struct AvxDecInputContext *input, int64_t offset) {
+  switch (input->aom_input_ctx->file_type) {
+    case FILE_TYPE_IVF:
+      return fseeko(input->aom_input_ctx->file, (FileOffset)offset, SEEK_SET);
+    case FILE_TYPE_OBU:
+      return obudec_seek_temporal_unit(input->obu_ctx, offset);
+    default: return -1;
+  }
+}
+
+// Adds the random access points of the input to 'index', reading the frames
+// from the current position without decoding them. Returns 0 on success.
+static int scan_seek_index(struct AvxDecInputContext *input, int is_annexb,
+                           SeekIndex *index, uint8_t **buf,
+                           size_t *buffer_size) {
+  for (int64_t frame = 0;; ++frame) {
+    const int64_t offset = tell_input(input);
+    size_t bytes_in_buffer = 0;
+    // OBU files have no timestamps, so they are indexed by frame number.
+    aom_codec_pts_t pts = frame;
+    int end;
+    if (offset < 0) return -1;
+    if (input->aom_input_ctx->file_type == FILE_TYPE_IVF) {
+      end = ivf_read_frame(input->aom_input_ctx->file, buf, &bytes_in_buffer,
+                           buffer_size, &pts);
+    } else {
+      end = read_frame(input, buf, &bytes_in_buffer, buffer_size);
+    }
+    if (end) return 0;
+    if (seek_index_is_random_access_point(*buf, bytes_in_buffer, is_annexb) &&
+        seek_index_add(index, pts, offset)) {
+      return -1;
+    }
+  }
+}
+
+// Reads the seek index of the input from 'seek_index_fn'. If there is no
+// such file, or it indexes a file of another size, builds the index by
+// scanning the input and writes it to 'seek_index_fn'. Then moves the input
+// to the last random access point at or before 'seek_pts' if 'seek' is set,
+// or back to the current position otherwise. Returns 0 on success.
+static int seek_to_pts(struct AvxDecInputContext *input, int is_annexb,
+                       const char *seek_index_fn, int seek, int64_t seek_pts,
+                       uint8_t **buf, size_t *buffer_size) {
+  FILE *const infile = input->aom_input_ctx->file;
+  const int64_t start = tell_input(input);
+  SeekIndex index;
+  int64_t file_size = -1;
+  int ret = -1;
+
+  memset(&index, 0, sizeof(index));
+  if (start < 0 || fseeko(infile, 0, SEEK_END) != 0 ||
+      (file_size = (int64_t)ftello(infile)) < 0 || seek_input(input, start)) {
+    fprintf(stderr, "Seeking requires an IVF or OBU input file.\n");
+    return -1;
+  }
+
+  if (!seek_index_fn || seek_index_read(&index, seek_index_fn) ||
+      index.file_size != file_size) {
+    index.num_entries = 0;
+    if (scan_seek_index(input, is_annexb, &index, buf, buffer_size)) {
+      fprintf(stderr, "Failed to scan the input for the seek index.\n");
+      goto done;
+    }
+    index.file_size = file_size;
+    if (seek_index_fn && seek_index_write(&index, seek_index_fn))
+      warn("Failed to write seek index %s", seek_index_fn);
+  }
+
+  const SeekIndexEntry *const entry =
+      seek ? seek_index_find(&index, seek_pts) : NULL;
+  if (seek && !entry) {
+    fprintf(stderr, "No key frame at or before pts %" PRId64 ".\n", seek_pts);
+    goto done;
+  }
+  if (seek_input(input, entry ? entry->offset : start)) {
+    fprintf(stderr, "Failed to seek the input.\n");
+    goto done;
+  }
+  if (entry) fprintf(stderr, "Seeking to pts %" PRId64 ".\n", entry->pts);
+  ret = 0;
+
+done:
+  seek_index_free(&index);
+  return ret;
+}
+
 static int file_is_raw(struct AvxInputContext *input) {
   uint8_t buf[32];
   int is_raw = 0;
@@ -288,13 +404,38 @@ struct ExternalFrameBuffer {
   uint8_t *data;
   size_t size;
   int in_use;
+  // Number of frames waiting for the output thread that use the buffer. The
+  // buffer is not handed back to the decoder until they are written.
+  int queued;
 };
 
 struct ExternalFrameBufferList {
   int num_external_frame_buffers;
   struct ExternalFrameBuffer *ext_fb;
+#if CONFIG_MULTITHREAD
+  // Set when frames are written on an output thread, which updates 'queued'
+  // under this mutex and signals 'cond' when it does.
+  pthread_mutex_t *mutex;
+  pthread_cond_t *cond;
+#endif
 };
 
+static void lock_frame_buffers(struct ExternalFrameBufferList *ext_fb_list) {
+#if CONFIG_MULTITHREAD
+  if (ext_fb_list->mutex) pthread_mutex_lock(ext_fb_list->mutex);
+#else
+  (void)ext_fb_list;
+#endif
+}
+
+static void unlock_frame_buffers(struct ExternalFrameBufferList *ext_fb_list) {
+#if CONFIG_MULTITHREAD
+  if (ext_fb_list->mutex) pthread_mutex_unlock(ext_fb_list->mutex);
+#else
+  (void)ext_fb_list;
+#endif
+}
+
 // Callback used by libaom to request an external frame buffer. |cb_priv|
 // Application private data passed into the set function. |min_size| is the
 // minimum size in bytes needed to decode the next frame. |fb| pointer to the
@@ -306,17 +447,34 @@ static int get_av1_frame_buffer(void *cb_priv, size_t min_size,
       (struct ExternalFrameBufferList *)cb_priv;
   if (ext_fb_list == NULL) return -1;
 
-  // Find a free frame buffer.
-  for (i = 0; i < ext_fb_list->num_external_frame_buffers; ++i) {
-    if (!ext_fb_list->ext_fb[i].in_use) break;
+  lock_frame_buffers(ext_fb_list);
+  // Find a free frame buffer. If the decoder holds all the buffers not used
+  // by queued frames, wait for the output thread to write one of them.
+  for (;;) {
+    int num_queued = 0;
+    for (i = 0; i < ext_fb_list->num_external_frame_buffers; ++i) {
+      if (!ext_fb_list->ext_fb[i].in_use && !ext_fb_list->ext_fb[i].queued)
+        break;
+      num_queued += ext_fb_list->ext_fb[i].queued;
+    }
+    if (i < ext_fb_list->num_external_frame_buffers || num_queued == 0) break;
+#if CONFIG_MULTITHREAD
+    pthread_cond_wait(ext_fb_list->cond, ext_fb_list->mutex);
+#endif
   }
 
-  if (i == ext_fb_list->num_external_frame_buffers) return -1;
+  if (i == ext_fb_list->num_external_frame_buffers) {
+    unlock_frame_buffers(ext_fb_list);
+    return -1;
+  }
 
   if (ext_fb_list->ext_fb[i].size < min_size) {
     free(ext_fb_list->ext_fb[i].data);
     ext_fb_list->ext_fb[i].data = (uint8_t *)calloc(min_size, sizeof(uint8_t));
-    if (!ext_fb_list->ext_fb[i].data) return -1;
+    if (!ext_fb_list->ext_fb[i].data) {
+      unlock_frame_buffers(ext_fb_list);
+      return -1;
+    }
 
     ext_fb_list->ext_fb[i].size = min_size;
   }
@@ -324,6 +482,7 @@ static int get_av1_frame_buffer(void *cb_priv, size_t min_size,
   fb->data = ext_fb_list->ext_fb[i].data;
   fb->size = ext_fb_list->ext_fb[i].size;
   ext_fb_list->ext_fb[i].in_use = 1;
+  unlock_frame_buffers(ext_fb_list);
 
   // Set the frame buffer's private data to point at the external frame buffer.
   fb->priv = &ext_fb_list->ext_fb[i];
@@ -335,10 +494,13 @@ static int get_av1_frame_buffer(void *cb_priv, size_t min_size,
 // to the frame buffer.
 static int release_av1_frame_buffer(void *cb_priv,
                                     aom_codec_frame_buffer_t *fb) {
+  struct ExternalFrameBufferList *const ext_fb_list =
+      (struct ExternalFrameBufferList *)cb_priv;
   struct ExternalFrameBuffer *const ext_fb =
       (struct ExternalFrameBuffer *)fb->priv;
-  (void)cb_priv;
+  lock_frame_buffers(ext_fb_list);
   ext_fb->in_use = 0;
+  unlock_frame_buffers(ext_fb_list);
   return 0;
 }
 
@@ -427,6 +589,477 @@ static FILE *open_outfile(const char *name) {
   }
 }
 
+// State of the output stage, which writes the decoded frames to the output
+// file(s) or adds them to the MD5 sum.
+struct OutputContext {
+  int do_md5;
+  int do_scale;
+  int flipuv;
+  int single_file;
+  int use_y4m;
+  int opt_i420;
+  int opt_yv12;
+  int opt_raw;
+  unsigned int fixed_output_bit_depth;
+  const char *outfile_pattern;
+  char outfile_name[PATH_MAX];
+  FILE *outfile;
+  MD5Context md5_ctx;
+  struct AvxInputContext *aom_input_ctx;
+  // Size the frames are scaled to with --scale.
+  int render_width;
+  int render_height;
+  aom_image_t *scaled_img;
+  aom_image_t *img_shifted;
+  int frame_out;
+};
+
+// Returns the size the output frames are scaled to with --scale. If the size
+// in the container is 0, uses the display size set in the first frame header.
+// If that is unavailable, uses the size of the first decoded frame 'img'.
+static void get_render_size(aom_codec_ctx_t *decoder, const aom_image_t *img,
+                            const struct AvxInputContext *aom_input_ctx,
+                            int *render_width, int *render_height) {
+  *render_width = aom_input_ctx->width;
+  *render_height = aom_input_ctx->height;
+  if (!*render_width || !*render_height) {
+    int render_size[2];
+    if (aom_codec_control(decoder, AV1D_GET_DISPLAY_SIZE, render_size)) {
+      // As last resort use size of first frame as display size.
+      *render_width = img->d_w;
+      *render_height = img->d_h;
+    } else {
+      *render_width = render_size[0];
+      *render_height = render_size[1];
+    }
+  }
+}
+
+// Writes 'img', decoded from compressed frame number 'frame_in', or adds it
+// to the MD5 sum. Returns 0 on success.
+static int write_image(struct OutputContext *out, aom_image_t *img,
+                       int frame_in) {
+  const int PLANES_YUV[] = { AOM_PLANE_Y, AOM_PLANE_U, AOM_PLANE_V };
+  const int PLANES_YVU[] = { AOM_PLANE_Y, AOM_PLANE_V, AOM_PLANE_U };
+  const int *planes = out->flipuv ? PLANES_YVU : PLANES_YUV;
+  struct AvxInputContext *const aom_input_ctx = out->aom_input_ctx;
+
+  ++out->frame_out;
+  if (out->do_scale) {
+    if (out->frame_out == 1) {
+      out->scaled_img = aom_img_alloc(NULL, img->fmt, out->render_width,
+                                      out->render_height, 16);
+      out->scaled_img->bit_depth = img->bit_depth;
+      out->scaled_img->monochrome = img->monochrome;
+      out->scaled_img->csp = img->csp;
+    }
+
+    if (img->d_w != out->scaled_img->d_w || img->d_h != out->scaled_img->d_h) {
+#if CONFIG_LIBYUV
+      libyuv_scale(img, out->scaled_img, kFilterBox);
+      img = out->scaled_img;
+#else
+      fprintf(stderr,
+              "Failed to scale output frame.\n"
+              "libyuv is required for scaling but is currently disabled.\n"
+              "Be sure to specify -DCONFIG_LIBYUV=1 when running cmake.\n");
+      return -1;
+#endif
+    }
+  }
+  // Default to codec bit depth if output bit depth not set
+  unsigned int output_bit_depth;
+  if (!out->fixed_output_bit_depth && out->single_file) {
+    output_bit_depth = img->bit_depth;
+  } else {
+    output_bit_depth = out->fixed_output_bit_depth;
+  }
+  // Shift up or down if necessary
+  if (output_bit_depth != 0)
+    aom_shift_img(output_bit_depth, &img, &out->img_shifted);
+
+  aom_input_ctx->width = img->d_w;
+  aom_input_ctx->height = img->d_h;
+
+  int num_planes = (out->opt_raw && img->monochrome) ? 1 : 3;
+  if (out->single_file) {
+    if (out->use_y4m) {
+      char y4m_buf[Y4M_BUFFER_SIZE] = { 0 };
+      size_t len = 0;
+      if (out->frame_out == 1) {
+        // Y4M file header
+        len = y4m_write_file_header(
+            y4m_buf, sizeof(y4m_buf), aom_input_ctx->width,
+            aom_input_ctx->height, &aom_input_ctx->framerate, img->monochrome,
+            img->csp, img->fmt, img->bit_depth);
+        if (img->csp == AOM_CSP_COLOCATED) {
+          fprintf(stderr,
+                  "Warning: Y4M lacks a colorspace for colocated "
+                  "chroma. Using a placeholder.\n");
+        }
+        if (out->do_md5) {
+          MD5Update(&out->md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
+        } else {
+          fputs(y4m_buf, out->outfile);
+        }
+      }
+
+      // Y4M frame header
+      len = y4m_write_frame_header(y4m_buf, sizeof(y4m_buf));
+      if (out->do_md5) {
+        MD5Update(&out->md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
+        y4m_update_image_md5(img, planes, &out->md5_ctx);
+      } else {
+        fputs(y4m_buf, out->outfile);
+        y4m_write_image_file(img, planes, out->outfile);
+      }
+    } else {
+      if (out->frame_out == 1) {
+        // Check if --yv12 or --i420 options are consistent with the
+        // bit-stream decoded
+        if (out->opt_i420) {
+          if (img->fmt != AOM_IMG_FMT_I420 && img->fmt != AOM_IMG_FMT_I42016) {
+            fprintf(stderr, "Cannot produce i420 output for bit-stream.\n");
+            return -1;
+          }
+        }
+        if (out->opt_yv12) {
+          if ((img->fmt != AOM_IMG_FMT_I420 && img->fmt != AOM_IMG_FMT_YV12) ||
+              img->bit_depth != 8) {
+            fprintf(stderr, "Cannot produce yv12 output for bit-stream.\n");
+            return -1;
+          }
+        }
+      }
+      if (out->do_md5) {
+        raw_update_image_md5(img, planes, num_planes, &out->md5_ctx);
+      } else {
+        raw_write_image_file(img, planes, num_planes, out->outfile);
+      }
+    }
+  } else {
+    generate_filename(out->outfile_pattern, out->outfile_name, PATH_MAX,
+                      img->d_w, img->d_h, frame_in);
+    if (out->do_md5) {
+      unsigned char md5_digest[16];
+      MD5Init(&out->md5_ctx);
+      if (out->use_y4m) {
+        y4m_update_image_md5(img, planes, &out->md5_ctx);
+      } else {
+        raw_update_image_md5(img, planes, num_planes, &out->md5_ctx);
+      }
+      MD5Final(md5_digest, &out->md5_ctx);
+      print_md5(md5_digest, out->outfile_name);
+    } else {
+      out->outfile = open_outfile(out->outfile_name);
+      if (out->use_y4m) {
+        y4m_write_image_file(img, planes, out->outfile);
+      } else {
+        raw_write_image_file(img, planes, num_planes, out->outfile);
+      }
+      fclose(out->outfile);
+    }
+  }
+  return 0;
+}
+
+#if CONFIG_MULTITHREAD
+// With --pipeline, compressed frames are read on an input thread and decoded
+// frames are written on an output thread, so that both overlap with decoding.
+// Each thread exchanges frames with the decoding thread through a queue of up
+// to 'queue_size' frames. Decoded frames are queued without a copy: the
+// decoder uses the external frame buffers, and a buffer is not handed back to
+// the decoder while a queued frame uses it.
+
+// A compressed frame read by the input thread.
+struct InputFrame {
+  uint8_t *data;
+  size_t size;
+  size_t capacity;
+};
+
+// A decoded frame waiting for the output thread.
+struct OutputFrame {
+  aom_image_t img;
+  int frame_in;
+};
+
+struct Pipeline {
+  pthread_mutex_t mutex;
+  // Broadcast whenever a queue or the use of a frame buffer changes.
+  pthread_cond_t cond;
+  int queue_size;
+  // Makes the threads exit without finishing their queues.
+  int stop;
+
+  // Input thread. It reads with the 'buf' and 'buffer_size' of main_loop() and
+  // copies the frames to 'input_frames'.
+  struct AvxDecInputContext *input;
+  uint8_t **buf;
+  size_t *buffer_size;
+  int stop_after;
+  struct InputFrame *input_frames;
+  int input_start;
+  int input_count;
+  // The first queued frame is being decoded.
+  int input_held;
+  int input_done;
+  pthread_t input_thread;
+  int input_running;
+
+  // Output thread.
+  struct OutputContext *output;
+  struct ExternalFrameBufferList *ext_fb_list;
+  struct OutputFrame *output_frames;
+  int output_start;
+  int output_count;
+  int output_done;
+  int output_error;
+  pthread_t output_thread;
+  int output_running;
+};
+
+static THREADFN input_thread_hook(void *arg) {
+  struct Pipeline *const pipeline = (struct Pipeline *)arg;
+  size_t bytes_in_buffer = 0;
+  int frames_read = 0;
+
+  while (!pipeline->stop_after || frames_read < pipeline->stop_after) {
+    if (read_frame(pipeline->input, pipeline->buf, &bytes_in_buffer,
+                   pipeline->buffer_size)) {
+      break;
+    }
+    ++frames_read;
+
+    pthread_mutex_lock(&pipeline->mutex);
+    while (pipeline->input_count == pipeline->queue_size && !pipeline->stop)
+      pthread_cond_wait(&pipeline->cond, &pipeline->mutex);
+    const int stop = pipeline->stop;
+    const int index = (pipeline->input_start + pipeline->input_count) %
+                      pipeline->queue_size;
+    pthread_mutex_unlock(&pipeline->mutex);
+    if (stop) break;
+
+    // The frame at 'index' is not queued, so the decoding thread does not
+    // read it.
+    struct InputFrame *const frame = &pipeline->input_frames[index];
+    if (frame->capacity < bytes_in_buffer) {
+      uint8_t *const data = (uint8_t *)realloc(frame->data, bytes_in_buffer);
+      if (!data) {
+        warn("Failed to allocate compressed data buffer\n");
+        break;
+      }
+      frame->data = data;
+      frame->capacity = bytes_in_buffer;
+    }
+    if (bytes_in_buffer > 0)
+      memcpy(frame->data, *pipeline->buf, bytes_in_buffer);
+    frame->size = bytes_in_buffer;
+
+    pthread_mutex_lock(&pipeline->mutex);
+    ++pipeline->input_count;
+    pthread_cond_broadcast(&pipeline->cond);
+    pthread_mutex_unlock(&pipeline->mutex);
+  }
+
+  pthread_mutex_lock(&pipeline->mutex);
+  pipeline->input_done = 1;
+  pthread_cond_broadcast(&pipeline->cond);
+  pthread_mutex_unlock(&pipeline->mutex);
+  return THREAD_RETURN(NULL);
+}
+
+// Removes the first frame from the output queue and hands its frame buffer
+// back to the decoder. Must be called with the mutex held.
+static void pop_output_frame(struct Pipeline *pipeline) {
+  struct OutputFrame *const frame =
+      &pipeline->output_frames[pipeline->output_start];
+  --((struct ExternalFrameBuffer *)frame->img.fb_priv)->queued;
+  pipeline->output_start = (pipeline->output_start + 1) % pipeline->queue_size;
+  --pipeline->output_count;
+  pthread_cond_broadcast(&pipeline->cond);
+}
+
+static THREADFN output_thread_hook(void *arg) {
+  struct Pipeline *const pipeline = (struct Pipeline *)arg;
+
+  pthread_mutex_lock(&pipeline->mutex);
+  for (;;) {
+    while (pipeline->output_count == 0 && !pipeline->output_done &&
+           !pipeline->stop) {
+      pthread_cond_wait(&pipeline->cond, &pipeline->mutex);
+    }
+    if (pipeline->stop || pipeline->output_count == 0) break;
+
+    struct OutputFrame *const frame =
+        &pipeline->output_frames[pipeline->output_start];
+    pthread_mutex_unlock(&pipeline->mutex);
+    const int error =
+        write_image(pipeline->output, &frame->img, frame->frame_in);
+    pthread_mutex_lock(&pipeline->mutex);
+    pop_output_frame(pipeline);
+    if (error) {
+      pipeline->output_error = 1;
+      break;
+    }
+  }
+  // Hand back the frame buffers of the frames that are not written.
+  while (pipeline->output_count > 0) pop_output_frame(pipeline);
+  pthread_cond_broadcast(&pipeline->cond);
+  pthread_mutex_unlock(&pipeline->mutex);
+  return THREAD_RETURN(NULL);
+}
+
+// Stops the threads without finishing their queues and frees the pipeline.
+static void destroy_pipeline(struct Pipeline *pipeline) {
+  pthread_mutex_lock(&pipeline->mutex);
+  pipeline->stop = 1;
+  pthread_cond_broadcast(&pipeline->cond);
+  pthread_mutex_unlock(&pipeline->mutex);
+  if (pipeline->input_running) pthread_join(pipeline->input_thread, NULL);
+  if (pipeline->output_running) pthread_join(pipeline->output_thread, NULL);
+
+  pipeline->ext_fb_list->mutex = NULL;
+  pipeline->ext_fb_list->cond = NULL;
+  pthread_cond_destroy(&pipeline->cond);
+  pthread_mutex_destroy(&pipeline->mutex);
+  for (int i = 0; i < pipeline->queue_size; ++i)
+    free(pipeline->input_frames[i].data);
+  free(pipeline->input_frames);
+  free(pipeline->output_frames);
+  free(pipeline);
+}
+
+// Starts the input and output threads. The input thread reads up to
+// 'stop_after' frames, or all the frames if 'stop_after' is 0. Returns NULL
+// on failure.
+static struct Pipeline *create_pipeline(
+    int queue_size, struct AvxDecInputContext *input, uint8_t **buf,
+    size_t *buffer_size, int stop_after, struct OutputContext *output,
+    struct ExternalFrameBufferList *ext_fb_list) {
+  struct Pipeline *const pipeline =
+      (struct Pipeline *)calloc(1, sizeof(*pipeline));
+  if (!pipeline) return NULL;
+  pipeline->queue_size = queue_size;
+  pipeline->input = input;
+  pipeline->buf = buf;
+  pipeline->buffer_size = buffer_size;
+  pipeline->stop_after = stop_after;
+  pipeline->output = output;
+  pipeline->ext_fb_list = ext_fb_list;
+  pipeline->input_frames = (struct InputFrame *)calloc(
+      queue_size, sizeof(*pipeline->input_frames));
+  pipeline->output_frames = (struct OutputFrame *)calloc(
+      queue_size, sizeof(*pipeline->output_frames));
+  if (!pipeline->input_frames || !pipeline->output_frames ||
+      pthread_mutex_init(&pipeline->mutex, NULL)) {
+    free(pipeline->input_frames);
+    free(pipeline->output_frames);
+    free(pipeline);
+    return NULL;
+  }
+  if (pthread_cond_init(&pipeline->cond, NULL)) {
+    pthread_mutex_destroy(&pipeline->mutex);
+    free(pipeline->input_frames);
+    free(pipeline->output_frames);
+    free(pipeline);
+    return NULL;
+  }
+  ext_fb_list->mutex = &pipeline->mutex;
+  ext_fb_list->cond = &pipeline->cond;
+
+  pipeline->output_running = !pthread_create(
+      &pipeline->output_thread, NULL, output_thread_hook, pipeline);
+  pipeline->input_running = !pthread_create(
+      &pipeline->input_thread, NULL, input_thread_hook, pipeline);
+  if (!pipeline->output_running || !pipeline->input_running) {
+    destroy_pipeline(pipeline);
+    return NULL;
+  }
+  return pipeline;
+}
+
+// Waits for the output thread to write the queued frames, then stops the
+// threads and frees the pipeline. Returns nonzero if a frame was not written.
+static int finish_pipeline(struct Pipeline *pipeline) {
+  pthread_mutex_lock(&pipeline->mutex);
+  pipeline->output_done = 1;
+  pthread_cond_broadcast(&pipeline->cond);
+  pthread_mutex_unlock(&pipeline->mutex);
+  pthread_join(pipeline->output_thread, NULL);
+  pipeline->output_running = 0;
+
+  const int error = pipeline->output_error;
+  destroy_pipeline(pipeline);
+  return error;
+}
+
+// Returns the next frame of the input thread in 'buf' and 'bytes_in_buffer'.
+// The previous frame is handed back to the input thread, so it must have been
+// decoded. Returns nonzero at the end of the input.
+static int pipeline_read_frame(struct Pipeline *pipeline, uint8_t **buf,
+                               size_t *bytes_in_buffer) {
+  pthread_mutex_lock(&pipeline->mutex);
+  if (pipeline->input_held) {
+    pipeline->input_start = (pipeline->input_start + 1) % pipeline->queue_size;
+    --pipeline->input_count;
+    pipeline->input_held = 0;
+    pthread_cond_broadcast(&pipeline->cond);
+  }
+  while (pipeline->input_count == 0 && !pipeline->input_done)
+    pthread_cond_wait(&pipeline->cond, &pipeline->mutex);
+  const int end = pipeline->input_count == 0;
+  if (!end) {
+    const struct InputFrame *const frame =
+        &pipeline->input_frames[pipeline->input_start];
+    *buf = frame->data;
+    *bytes_in_buffer = frame->size;
+    pipeline->input_held = 1;
+  }
+  pthread_mutex_unlock(&pipeline->mutex);
+  return end;
+}
+
+// Queues 'img', decoded from compressed frame number 'frame_in', for the
+// output thread. Returns nonzero if the output thread failed to write a frame.
+static int pipeline_write_image(struct Pipeline *pipeline, aom_image_t *img,
+                                int frame_in) {
+  struct ExternalFrameBuffer *const ext_fb =
+      (struct ExternalFrameBuffer *)img->fb_priv;
+  int error;
+
+  pthread_mutex_lock(&pipeline->mutex);
+  if (ext_fb == NULL) {
+    // The image is not in an external frame buffer, so it is written before
+    // the decoder reuses its memory, once the queued frames are written.
+    while (pipeline->output_count > 0 && !pipeline->output_error)
+      pthread_cond_wait(&pipeline->cond, &pipeline->mutex);
+    error = pipeline->output_error;
+    pthread_mutex_unlock(&pipeline->mutex);
+    return error || write_image(pipeline->output, img, frame_in);
+  }
+
+  while (pipeline->output_count == pipeline->queue_size &&
+         !pipeline->output_error) {
+    pthread_cond_wait(&pipeline->cond, &pipeline->mutex);
+  }
+  error = pipeline->output_error;
+  if (!error) {
+    struct OutputFrame *const frame =
+        &pipeline->output_frames[(pipeline->output_start +
+                                  pipeline->output_count) %
+                                 pipeline->queue_size];
+    frame->img = *img;
+    frame->frame_in = frame_in;
+    ++ext_fb->queued;
+    ++pipeline->output_count;
+    pthread_cond_broadcast(&pipeline->cond);
+  }
+  pthread_mutex_unlock(&pipeline->mutex);
+  return error;
+}
+#endif  // CONFIG_MULTITHREAD
+
 static int main_loop(int argc, const char **argv_) {
   aom_codec_ctx_t decoder;
   char *fn = NULL;
@@ -440,6 +1073,10 @@ static int main_loop(int argc, const char **argv_) {
   int stop_after = 0, postproc = 0, summary = 0, quiet = 1;
   int arg_skip = 0;
   int keep_going = 0;
+  int queue_size = 0;
+  int seek = 0;
+  int64_t seek_pts = 0;
+  const char *seek_index_fn = NULL;
   const AvxInterface *interface = NULL;
   const AvxInterface *fourcc_interface = NULL;
   uint64_t dx_time = 0;
@@ -460,19 +1097,20 @@ static int main_loop(int argc, const char **argv_) {
   int operating_point = 0;
   int output_all_layers = 0;
   int skip_film_grain = 0;
-  aom_image_t *scaled_img = NULL;
-  aom_image_t *img_shifted = NULL;
   int frame_avail, got_data, flush_decoder = 0;
   int num_external_frame_buffers = 0;
-  struct ExternalFrameBufferList ext_fb_list = { 0, NULL };
+  struct ExternalFrameBufferList ext_fb_list;
+  memset(&ext_fb_list, 0, sizeof(ext_fb_list));
+#if CONFIG_MULTITHREAD
+  struct Pipeline *pipeline = NULL;
+#endif
 
   const char *outfile_pattern = NULL;
-  char outfile_name[PATH_MAX] = { 0 };
-  FILE *outfile = NULL;
+  struct OutputContext output;
+  memset(&output, 0, sizeof(output));
 
   FILE *framestats_file = NULL;
 
-  MD5Context md5_ctx;
   unsigned char md5_digest[16];
 
   struct AvxDecInputContext input = { NULL, NULL, NULL };
@@ -576,6 +1214,20 @@ static int main_loop(int argc, const char **argv_) {
       output_all_layers = 1;
     } else if (arg_match(&arg, &skipfilmgrain, argi)) {
       skip_film_grain = 1;
+    } else if (arg_match(&arg, &seekarg, argi)) {
+      seek = 1;
+      seek_pts = arg_parse_int64(&arg);
+    } else if (arg_match(&arg, &seekindexarg, argi)) {
+      seek_index_fn = arg.val;
+    } else if (arg_match(&arg, &pipelinearg, argi)) {
+      queue_size = arg_parse_uint(&arg);
+#if !CONFIG_MULTITHREAD
+      if (queue_size > 0) {
+        die("Error: --pipeline=%d is not supported when CONFIG_MULTITHREAD = "
+            "0.\n",
+            queue_size);
+      }
+#endif
     } else {
       argj++;
     }
@@ -635,12 +1287,12 @@ static int main_loop(int argc, const char **argv_) {
   single_file = is_single_file(outfile_pattern);
 
   if (!noblit && single_file) {
-    generate_filename(outfile_pattern, outfile_name, PATH_MAX,
+    generate_filename(outfile_pattern, output.outfile_name, PATH_MAX,
                       aom_input_ctx.width, aom_input_ctx.height, 0);
     if (do_md5)
-      MD5Init(&md5_ctx);
+      MD5Init(&output.md5_ctx);
     else
-      outfile = open_outfile(outfile_name);
+      output.outfile = open_outfile(output.outfile_name);
   }
 
   if (use_y4m && !noblit) {
@@ -709,12 +1361,24 @@ static int main_loop(int argc, const char **argv_) {
     goto fail;
   }
 
+  if ((seek || seek_index_fn) &&
+      seek_to_pts(&input, is_annexb, seek_index_fn, seek, seek_pts, &buf,
+                  &buffer_size)) {
+    goto fail;
+  }
+
   if (arg_skip) fprintf(stderr, "Skipping first %d frames.\n", arg_skip);
   while (arg_skip) {
     if (read_frame(&input, &buf, &bytes_in_buffer, &buffer_size)) break;
     arg_skip--;
   }
 
+  // Queued frames keep their frame buffers, in addition to the ones the
+  // decoder may use.
+  if (queue_size > 0 && num_external_frame_buffers == 0) {
+    num_external_frame_buffers =
+        AOM_MAXIMUM_WORK_BUFFERS + AOM_MAXIMUM_REF_BUFFERS + queue_size;
+  }
   if (num_external_frame_buffers > 0) {
     ext_fb_list.num_external_frame_buffers = num_external_frame_buffers;
     ext_fb_list.ext_fb = (struct ExternalFrameBuffer *)calloc(
@@ -728,6 +1392,29 @@ static int main_loop(int argc, const char **argv_) {
     }
   }
 
+  output.do_md5 = do_md5;
+  output.do_scale = do_scale;
+  output.flipuv = flipuv;
+  output.single_file = single_file;
+  output.use_y4m = use_y4m;
+  output.opt_i420 = opt_i420;
+  output.opt_yv12 = opt_yv12;
+  output.opt_raw = opt_raw;
+  output.fixed_output_bit_depth = fixed_output_bit_depth;
+  output.outfile_pattern = outfile_pattern;
+  output.aom_input_ctx = &aom_input_ctx;
+
+#if CONFIG_MULTITHREAD
+  if (queue_size > 0) {
+    pipeline = create_pipeline(queue_size, &input, &buf, &buffer_size,
+                               stop_after, &output, &ext_fb_list);
+    if (!pipeline) {
+      fprintf(stderr, "Failed to start the pipeline threads.\n");
+      goto fail;
+    }
+  }
+#endif
+
   frame_avail = 1;
   got_data = 0;
 
@@ -742,13 +1429,26 @@ static int main_loop(int argc, const char **argv_) {
 
     frame_avail = 0;
     if (!stop_after || frame_in < stop_after) {
-      if (!read_frame(&input, &buf, &bytes_in_buffer, &buffer_size)) {
+      // In pipeline mode 'buf' belongs to the input thread.
+      uint8_t *frame_data;
+      int end_of_input;
+#if CONFIG_MULTITHREAD
+      if (pipeline) {
+        end_of_input =
+            pipeline_read_frame(pipeline, &frame_data, &bytes_in_buffer);
+      } else
+#endif
+      {
+        end_of_input = read_frame(&input, &buf, &bytes_in_buffer, &buffer_size);
+        frame_data = buf;
+      }
+      if (!end_of_input) {
         frame_avail = 1;
         frame_in++;
 
         aom_usec_timer_start(&timer);
 
-        if (aom_codec_decode(&decoder, buf, bytes_in_buffer, NULL)) {
+        if (aom_codec_decode(&decoder, frame_data, bytes_in_buffer, NULL)) {
           const char *detail = aom_codec_error_detail(&decoder);
           warn("Failed to decode frame %d: %s", frame_in,
                aom_codec_error(&decoder));
@@ -802,153 +1502,30 @@ static int main_loop(int argc, const char **argv_) {
       if (progress) show_progress(frame_in, frame_out, dx_time);
 
       if (!noblit) {
-        const int PLANES_YUV[] = { AOM_PLANE_Y, AOM_PLANE_U, AOM_PLANE_V };
-        const int PLANES_YVU[] = { AOM_PLANE_Y, AOM_PLANE_V, AOM_PLANE_U };
-        const int *planes = flipuv ? PLANES_YVU : PLANES_YUV;
-
-        if (do_scale) {
-          if (frame_out == 1) {
-            // If the output frames are to be scaled to a fixed display size
-            // then use the width and height specified in the container. If
-            // either of these is set to 0, use the display size set in the
-            // first frame header. If that is unavailable, use the raw decoded
-            // size of the first decoded frame.
-            int render_width = aom_input_ctx.width;
-            int render_height = aom_input_ctx.height;
-            if (!render_width || !render_height) {
-              int render_size[2];
-              if (aom_codec_control(&decoder, AV1D_GET_DISPLAY_SIZE,
-                                    render_size)) {
-                // As last resort use size of first frame as display size.
-                render_width = img->d_w;
-                render_height = img->d_h;
-              } else {
-                render_width = render_size[0];
-                render_height = render_size[1];
-              }
-            }
-            scaled_img =
-                aom_img_alloc(NULL, img->fmt, render_width, render_height, 16);
-            scaled_img->bit_depth = img->bit_depth;
-            scaled_img->monochrome = img->monochrome;
-            scaled_img->csp = img->csp;
-          }
-
-          if (img->d_w != scaled_img->d_w || img->d_h != scaled_img->d_h) {
-#if CONFIG_LIBYUV
-            libyuv_scale(img, scaled_img, kFilterBox);
-            img = scaled_img;
-#else
-            fprintf(
-                stderr,
-                "Failed to scale output frame: %s.\n"
-                "libyuv is required for scaling but is currently disabled.\n"
-                "Be sure to specify -DCONFIG_LIBYUV=1 when running cmake.\n",
-                aom_codec_error(&decoder));
-            goto fail;
-#endif
-          }
+        if (do_scale && frame_out == 1) {
+          get_render_size(&decoder, img, &aom_input_ctx, &output.render_width,
+                          &output.render_height);
         }
-        // Default to codec bit depth if output bit depth not set
-        unsigned int output_bit_depth;
-        if (!fixed_output_bit_depth && single_file) {
-          output_bit_depth = img->bit_depth;
-        } else {
-          output_bit_depth = fixed_output_bit_depth;
-        }
-        // Shift up or down if necessary
-        if (output_bit_depth != 0)
-          aom_shift_img(output_bit_depth, &img, &img_shifted);
-
-        aom_input_ctx.width = img->d_w;
-        aom_input_ctx.height = img->d_h;
-
-        int num_planes = (opt_raw && img->monochrome) ? 1 : 3;
-        if (single_file) {
-          if (use_y4m) {
-            char y4m_buf[Y4M_BUFFER_SIZE] = { 0 };
-            size_t len = 0;
-            if (frame_out == 1) {
-              // Y4M file header
-              len = y4m_write_file_header(
-                  y4m_buf, sizeof(y4m_buf), aom_input_ctx.width,
-                  aom_input_ctx.height, &aom_input_ctx.framerate,
-                  img->monochrome, img->csp, img->fmt, img->bit_depth);
-              if (img->csp == AOM_CSP_COLOCATED) {
-                fprintf(stderr,
-                        "Warning: Y4M lacks a colorspace for colocated "
-                        "chroma. Using a placeholder.\n");
-              }
-              if (do_md5) {
-                MD5Update(&md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
-              } else {
-                fputs(y4m_buf, outfile);
-              }
-            }
-
-            // Y4M frame header
-            len = y4m_write_frame_header(y4m_buf, sizeof(y4m_buf));
-            if (do_md5) {
-              MD5Update(&md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
-              y4m_update_image_md5(img, planes, &md5_ctx);
-            } else {
-              fputs(y4m_buf, outfile);
-              y4m_write_image_file(img, planes, outfile);
-            }
-          } else {
-            if (frame_out == 1) {
-              // Check if --yv12 or --i420 options are consistent with the
-              // bit-stream decoded
-              if (opt_i420) {
-                if (img->fmt != AOM_IMG_FMT_I420 &&
-                    img->fmt != AOM_IMG_FMT_I42016) {
-                  fprintf(stderr,
-                          "Cannot produce i420 output for bit-stream.\n");
-                  goto fail;
-                }
-              }
-              if (opt_yv12) {
-                if ((img->fmt != AOM_IMG_FMT_I420 &&
-                     img->fmt != AOM_IMG_FMT_YV12) ||
-                    img->bit_depth != 8) {
-                  fprintf(stderr,
-                          "Cannot produce yv12 output for bit-stream.\n");
-                  goto fail;
-                }
-              }
-            }
-            if (do_md5) {
-              raw_update_image_md5(img, planes, num_planes, &md5_ctx);
-            } else {
-              raw_write_image_file(img, planes, num_planes, outfile);
-            }
-          }
-        } else {
-          generate_filename(outfile_pattern, outfile_name, PATH_MAX, img->d_w,
-                            img->d_h, frame_in);
-          if (do_md5) {
-            MD5Init(&md5_ctx);
-            if (use_y4m) {
-              y4m_update_image_md5(img, planes, &md5_ctx);
-            } else {
-              raw_update_image_md5(img, planes, num_planes, &md5_ctx);
-            }
-            MD5Final(md5_digest, &md5_ctx);
-            print_md5(md5_digest, outfile_name);
-          } else {
-            outfile = open_outfile(outfile_name);
-            if (use_y4m) {
-              y4m_write_image_file(img, planes, outfile);
-            } else {
-              raw_write_image_file(img, planes, num_planes, outfile);
-            }
-            fclose(outfile);
-          }
+#if CONFIG_MULTITHREAD
+        if (pipeline) {
+          if (pipeline_write_image(pipeline, img, frame_in)) goto fail;
+        } else
+#endif
+        {
+          if (write_image(&output, img, frame_in)) goto fail;
         }
       }
     }
   }
 
+#if CONFIG_MULTITHREAD
+  if (pipeline) {
+    const int error = finish_pipeline(pipeline);
+    pipeline = NULL;
+    if (error) goto fail;
+  }
+#endif
+
   if (summary || progress) {
     show_progress(frame_in, frame_out, dx_time);
     fprintf(stderr, "\n");
@@ -962,6 +1539,10 @@ static int main_loop(int argc, const char **argv_) {
 
 fail:
 
+#if CONFIG_MULTITHREAD
+  if (pipeline) destroy_pipeline(pipeline);
+#endif
+
   if (aom_codec_destroy(&decoder)) {
     fprintf(stderr, "Failed to destroy decoder: %s\n",
             aom_codec_error(&decoder));
@@ -971,10 +1552,10 @@ fail2:
 
   if (!noblit && single_file) {
     if (do_md5) {
-      MD5Final(md5_digest, &md5_ctx);
-      print_md5(md5_digest, outfile_name);
+      MD5Final(md5_digest, &output.md5_ctx);
+      print_md5(md5_digest, output.outfile_name);
     } else {
-      fclose(outfile);
+      fclose(output.outfile);
     }
   }
 
@@ -987,8 +1568,8 @@ fail2:
 
   if (input.aom_input_ctx->file_type != FILE_TYPE_WEBM) free(buf);
 
-  if (scaled_img) aom_img_free(scaled_img);
-  if (img_shifted) aom_img_free(img_shifted);
+  if (output.scaled_img) aom_img_free(output.scaled_img);
+  if (output.img_shifted) aom_img_free(output.img_shifted);
 
   for (i = 0; i < ext_fb_list.num_external_frame_buffers; ++i) {
     free(ext_fb_list.ext_fb[i].data);
@@ -34,6 +34,7 @@
 #include "aom_ports/mem_ops.h"
 #include "common/args.h"
 #include "common/ivfenc.h"
+#include "common/seek_index.h"
 #include "common/tools_common.h"
 #include "common/warnings.h"
 
@@ -178,6 +179,9 @@ static const arg_def_t use_webm =
     ARG_DEF(NULL, "webm", 0, "Output WebM (default when WebM IO is enabled)");
 static const arg_def_t use_ivf = ARG_DEF(NULL, "ivf", 0, "Output IVF");
 static const arg_def_t use_obu = ARG_DEF(NULL, "obu", 0, "Output OBU");
+static const arg_def_t seek_index_arg =
+    ARG_DEF(NULL, "seek-index", 1,
+            "Write a seek index of the IVF or OBU output to this file");
 static const arg_def_t q_hist_n =
     ARG_DEF(NULL, "q-hist", 1, "Show quantizer histogram (n-buckets)");
 static const arg_def_t rate_hist_n =
@@ -224,6 +228,7 @@ static const arg_def_t *main_args[] = { &help,
                                         &use_webm,
                                         &use_ivf,
                                         &use_obu,
+                                        &seek_index_arg,
                                         &q_hist_n,
                                         &rate_hist_n,
                                         &disable_warnings,
@@ -1080,6 +1085,7 @@ struct stream_config {
   int write_webm;
   const char *film_grain_filename;
   int write_ivf;
+  const char *seek_index_fn;
   // whether to use 16bit internal buffers
   int use_16bit_internal;
 };
@@ -1106,6 +1112,7 @@ struct stream_state {
   int mismatch_seen;
   unsigned int chroma_subsampling_x;
   unsigned int chroma_subsampling_y;
+  SeekIndex seek_index;
 };
 
 static void validate_positive_rational(const char *msg,
@@ -1463,6 +1470,8 @@ static int parse_stream_params(struct AvxEncoderConfig *global,
     } else if (arg_match(&arg, &use_obu, argi)) {
       config->write_webm = 0;
       config->write_ivf = 0;
+    } else if (arg_match(&arg, &seek_index_arg, argi)) {
+      config->seek_index_fn = arg.val;
     } else if (arg_match(&arg, &threads, argi)) {
       config->cfg.g_threads = arg_parse_uint(&arg);
     } else if (arg_match(&arg, &profile, argi)) {
@@ -1761,6 +1770,14 @@ static void open_output_file(struct stream_state *stream,
   if (stream->config.write_webm && fseek(stream->file, 0, SEEK_CUR))
     fatal("WebM output to pipes not supported.");
 
+  if (stream->config.seek_index_fn) {
+    if (stream->config.write_webm)
+      fatal("--seek-index requires IVF or OBU output.");
+    if (fseek(stream->file, 0, SEEK_CUR))
+      fatal("--seek-index does not support output to pipes.");
+    stream->seek_index.num_entries = 0;
+  }
+
 #if CONFIG_WEBM_IO
   if (stream->config.write_webm) {
     stream->webm_ctx.stream = stream->file;
@@ -1799,6 +1816,14 @@ static void close_output_file(struct stream_state *stream,
                             stream->frames_out);
   }
 
+  if (stream->config.seek_index_fn) {
+    if (fseeko(stream->file, 0, SEEK_END) == 0)
+      stream->seek_index.file_size = (int64_t)ftello(stream->file);
+    if (seek_index_write(&stream->seek_index, stream->config.seek_index_fn))
+      fatal("Failed to write seek index %s", stream->config.seek_index_fn);
+    seek_index_free(&stream->seek_index);
+  }
+
   fclose(stream->file);
 }
 
@@ -2003,6 +2028,19 @@ static void get_cx_data(struct stream_state *stream,
         }
 #endif
         if (!stream->config.write_webm) {
+          // OBU files have no timestamps, so they are indexed by frame
+          // number.
+          if (stream->config.seek_index_fn &&
+              pkt->data.frame.partition_id <= 0 &&
+              seek_index_is_random_access_point(pkt->data.frame.buf,
+                                                pkt->data.frame.sz,
+                                                cfg->save_as_annexb) &&
+              seek_index_add(&stream->seek_index,
+                             stream->config.write_ivf ? pkt->data.frame.pts
+                                                      : stream->frames_out - 1,
+                             (int64_t)ftello(stream->file))) {
+            fatal("Failed to allocate the seek index");
+          }
           if (stream->config.write_ivf) {
             if (pkt->data.frame.partition_id <= 0) {
               ivf_header_pos = ftello(stream->file);
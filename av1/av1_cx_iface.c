@@ -2251,6 +2251,15 @@ static aom_codec_err_t ctrl_set_svc_ref_frame_config(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_thread_pool(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  AV1_COMP *const cpi = ctx->cpi;
+  // The workers are attached to the pool when they are created.
+  if (cpi->num_workers > 0) return AOM_CODEC_ERROR;
+  cpi->thread_pool = va_arg(args, aom_thread_pool_t *);
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t ctrl_set_tune_content(aom_codec_alg_priv_t *ctx,
                                              va_list args) {
   struct av1_extracfg extra_cfg = ctx->extra_cfg;
@@ -2462,6 +2471,7 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1E_SET_SVC_LAYER_ID, ctrl_set_layer_id },
   { AV1E_SET_SVC_PARAMS, ctrl_set_svc_params },
   { AV1E_SET_SVC_REF_FRAME_CONFIG, ctrl_set_svc_ref_frame_config },
+  { AV1E_SET_THREAD_POOL, ctrl_set_thread_pool },
 
   // Getters
   { AOME_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -59,6 +59,14 @@ struct aom_codec_alg_priv {
   unsigned int is_annexb;
   int operating_point;
   int output_all_layers;
+  int incremental_decode;
+  int skip_frames;
+  int skip_output_only_filters;
+  int luma_only;
+  int tile_mask_enabled;
+  aom_tile_mask_t tile_mask;
+  aom_thread_pool_t *thread_pool;
+  int decode_timing;
 
   // TODO(wtc): This can be simplified. num_frame_workers is always 1, and
   // next_output_worker_id is always 0. The frame_workers array of size 1 can
@@ -83,6 +91,8 @@ struct aom_codec_alg_priv {
   aom_inspect_cb inspect_cb;
   void *inspect_ctx;
 #endif
+  aom_row_progress_cb row_progress_cb;
+  void *row_progress_ctx;
 };
 
 static aom_codec_err_t decoder_init(aom_codec_ctx_t *ctx,
@@ -495,6 +505,7 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
     // If decoding in serial mode, FrameWorker thread could create tile worker
     // thread or loopfilter thread.
     frame_worker_data->pbi->max_threads = ctx->cfg.threads;
+    frame_worker_data->pbi->thread_pool = ctx->thread_pool;
     frame_worker_data->pbi->inv_tile_order = ctx->invert_tile_order;
     frame_worker_data->pbi->common.large_scale_tile = ctx->tile_mode;
     frame_worker_data->pbi->common.is_annexb = ctx->is_annexb;
@@ -531,6 +542,19 @@ static INLINE void check_resync(aom_codec_alg_priv_t *const ctx,
     ctx->need_resync = 0;
 }
 
+// Forwards the rows of the frame being decoded that are final to the
+// application's row progress callback.
+static void decoder_row_progress(void *priv, int start_row, int end_row) {
+  aom_codec_alg_priv_t *const ctx = (aom_codec_alg_priv_t *)priv;
+  FrameWorkerData *const frame_worker_data =
+      (FrameWorkerData *)ctx->frame_workers[0].data1;
+  AV1_COMMON *const cm = &frame_worker_data->pbi->common;
+  aom_image_t img;
+
+  yuvconfig2image(&img, &cm->cur_frame->buf, frame_worker_data->user_priv);
+  ctx->row_progress_cb(ctx->row_progress_ctx, &img, start_row, end_row);
+}
+
 static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
                                   const uint8_t **data, size_t data_sz,
                                   void *user_priv) {
@@ -544,9 +568,17 @@ static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
     ctx->si.is_annexb = ctx->is_annexb;
     const aom_codec_err_t res =
         decoder_peek_si_internal(*data, data_sz, &ctx->si, &is_intra_only);
-    if (res != AOM_CODEC_OK) return res;
+    if (ctx->incremental_decode && !ctx->is_annexb) {
+      // The sequence header and the first frame header may arrive in separate
+      // pieces. Peek again at the next piece and let the decoder itself wait
+      // for a key frame.
+      if (res != AOM_CODEC_OK || (!ctx->si.is_kf && !is_intra_only))
+        ctx->si.h = 0;
+    } else {
+      if (res != AOM_CODEC_OK) return res;
 
-    if (!ctx->si.is_kf && !is_intra_only) return AOM_CODEC_ERROR;
+      if (!ctx->si.is_kf && !is_intra_only) return AOM_CODEC_ERROR;
+    }
   }
 
   AVxWorker *const worker = ctx->frame_workers;
@@ -562,6 +594,21 @@ static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
   frame_worker_data->pbi->ext_tile_debug = ctx->ext_tile_debug;
   frame_worker_data->pbi->row_mt = ctx->row_mt;
   frame_worker_data->pbi->ext_refs = ctx->ext_refs;
+  frame_worker_data->pbi->incremental_decode =
+      ctx->incremental_decode && !ctx->is_annexb;
+  frame_worker_data->pbi->row_progress_cb =
+      ctx->row_progress_cb != NULL ? decoder_row_progress : NULL;
+  frame_worker_data->pbi->row_progress_priv = ctx;
+  frame_worker_data->pbi->skip_frames_request = ctx->skip_frames;
+  frame_worker_data->pbi->skip_output_only_filters =
+      ctx->skip_output_only_filters;
+  frame_worker_data->pbi->luma_only_request = ctx->luma_only;
+  frame_worker_data->pbi->tile_mask_enabled = ctx->tile_mask_enabled;
+  // Fails to compile if aom_tile_mask_t cannot select every tile.
+  (void)sizeof(char[AOM_TILE_MASK_WORDS * 32 >= MAX_TILES ? 1 : -1]);
+  memcpy(frame_worker_data->pbi->tile_mask, ctx->tile_mask.mask,
+         sizeof(frame_worker_data->pbi->tile_mask));
+  frame_worker_data->pbi->timing_enabled = ctx->decode_timing;
 
   frame_worker_data->pbi->common.is_annexb = ctx->is_annexb;
 
@@ -621,6 +668,29 @@ static aom_codec_err_t decoder_inspect(aom_codec_alg_priv_t *ctx,
 }
 #endif
 
+// Releases the output frames of the previous decoder_decode call.
+static void release_pending_output_frames(aom_codec_alg_priv_t *ctx) {
+  BufferPool *const pool = ctx->buffer_pool;
+  lock_buffer_pool(pool);
+  for (int i = 0; i < ctx->num_frame_workers; ++i) {
+    AVxWorker *const worker = &ctx->frame_workers[i];
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    struct AV1Decoder *pbi = frame_worker_data->pbi;
+    for (size_t j = 0; j < pbi->num_output_frames; j++) {
+      decrease_ref_count(pbi->output_frames[j], pool);
+    }
+    pbi->num_output_frames = 0;
+  }
+  unlock_buffer_pool(pool);
+  for (size_t j = 0; j < ctx->num_grain_image_frame_buffers; j++) {
+    pool->release_fb_cb(pool->cb_priv, &ctx->grain_image_frame_buffers[j]);
+    ctx->grain_image_frame_buffers[j].data = NULL;
+    ctx->grain_image_frame_buffers[j].size = 0;
+    ctx->grain_image_frame_buffers[j].priv = NULL;
+  }
+  ctx->num_grain_image_frame_buffers = 0;
+}
+
 static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
                                       const uint8_t *data, size_t data_sz,
                                       void *user_priv) {
@@ -634,28 +704,7 @@ static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
   // Release any pending output frames from the previous decoder_decode call.
   // We need to do this even if the decoder is being flushed or the input
   // arguments are invalid.
-  if (ctx->frame_workers) {
-    BufferPool *const pool = ctx->buffer_pool;
-    lock_buffer_pool(pool);
-    for (int i = 0; i < ctx->num_frame_workers; ++i) {
-      AVxWorker *const worker = &ctx->frame_workers[i];
-      FrameWorkerData *const frame_worker_data =
-          (FrameWorkerData *)worker->data1;
-      struct AV1Decoder *pbi = frame_worker_data->pbi;
-      for (size_t j = 0; j < pbi->num_output_frames; j++) {
-        decrease_ref_count(pbi->output_frames[j], pool);
-      }
-      pbi->num_output_frames = 0;
-    }
-    unlock_buffer_pool(pool);
-    for (size_t j = 0; j < ctx->num_grain_image_frame_buffers; j++) {
-      pool->release_fb_cb(pool->cb_priv, &ctx->grain_image_frame_buffers[j]);
-      ctx->grain_image_frame_buffers[j].data = NULL;
-      ctx->grain_image_frame_buffers[j].size = 0;
-      ctx->grain_image_frame_buffers[j].priv = NULL;
-    }
-    ctx->num_grain_image_frame_buffers = 0;
-  }
+  if (ctx->frame_workers) release_pending_output_frames(ctx);
 
   /* Sanity checks */
   /* NULL data ptr allowed if data_sz is 0 too */
@@ -674,6 +723,12 @@ static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
     if (res != AOM_CODEC_OK) return res;
   }
 
+  if (ctx->decode_timing) {
+    FrameWorkerData *const frame_worker_data =
+        (FrameWorkerData *)ctx->frame_workers->data1;
+    av1_zero(frame_worker_data->pbi->timing);
+  }
+
   const uint8_t *data_start = data;
   const uint8_t *data_end = data + data_sz;
 
@@ -861,8 +916,12 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
           img->temporal_id = cm->temporal_layer_id;
           img->spatial_id = cm->spatial_layer_id;
           if (cm->skip_film_grain) grain_params->apply_grain = 0;
+          if (grain_params->apply_grain)
+            start_dec_timing(pbi, AOM_DECODE_STAGE_FILM_GRAIN);
           aom_image_t *res = add_grain_if_needed(
               ctx, img, &ctx->image_with_grain, grain_params);
+          if (grain_params->apply_grain)
+            end_dec_timing(pbi, AOM_DECODE_STAGE_FILM_GRAIN);
           if (!res) {
             aom_internal_error(&pbi->common.error, AOM_CODEC_CORRUPT_FRAME,
                                "Grain systhesis failed\n");
@@ -1358,6 +1417,110 @@ static aom_codec_err_t ctrl_set_output_all_layers(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_incremental_decode(aom_codec_alg_priv_t *ctx,
+                                                   va_list args) {
+  ctx->incremental_decode = va_arg(args, int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_skip_frames(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  const int skip_frames = va_arg(args, int);
+  if (skip_frames < AOM_SKIP_FRAMES_NONE ||
+      skip_frames > AOM_SKIP_FRAMES_NON_KEY)
+    return AOM_CODEC_INVALID_PARAM;
+  ctx->skip_frames = skip_frames;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_skip_output_only_filters(
+    aom_codec_alg_priv_t *ctx, va_list args) {
+  ctx->skip_output_only_filters = va_arg(args, int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_luma_only(aom_codec_alg_priv_t *ctx,
+                                          va_list args) {
+  ctx->luma_only = va_arg(args, int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_tile_mask(aom_codec_alg_priv_t *ctx,
+                                          va_list args) {
+  const aom_tile_mask_t *const tile_mask =
+      va_arg(args, const aom_tile_mask_t *);
+  ctx->tile_mask_enabled = tile_mask != NULL;
+  if (tile_mask != NULL) ctx->tile_mask = *tile_mask;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_thread_pool(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  // The tile workers are attached to the pool when they are created.
+  if (ctx->frame_workers != NULL) return AOM_CODEC_ERROR;
+  ctx->thread_pool = va_arg(args, aom_thread_pool_t *);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_decode_timing(aom_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  ctx->decode_timing = va_arg(args, int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_decode_timing(aom_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  aom_decode_timing_t *const timing = va_arg(args, aom_decode_timing_t *);
+
+  if (timing == NULL) return AOM_CODEC_INVALID_PARAM;
+  if (!ctx->decode_timing || ctx->frame_workers == NULL)
+    return AOM_CODEC_ERROR;
+  const FrameWorkerData *const frame_worker_data =
+      (FrameWorkerData *)ctx->frame_workers->data1;
+  *timing = frame_worker_data->pbi->timing;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_reset_stream(aom_codec_alg_priv_t *ctx,
+                                         va_list args) {
+  (void)args;
+  // The decoder has not been initialized yet, so there is nothing to reset.
+  if (ctx->frame_workers == NULL) return AOM_CODEC_OK;
+
+  release_pending_output_frames(ctx);
+  for (int i = 0; i < ctx->num_frame_workers; ++i) {
+    FrameWorkerData *const frame_worker_data =
+        (FrameWorkerData *)ctx->frame_workers[i].data1;
+    av1_decoder_reset(frame_worker_data->pbi);
+    frame_worker_data->received_frame = 0;
+  }
+  av1_zero(ctx->si);
+  ctx->last_show_frame = NULL;
+  ctx->next_output_worker_id = 0;
+  ctx->need_resync = 1;
+  ctx->flushed = 0;
+  ctx->img_avail = 0;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_memory_usage(aom_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  size_t *const usage = va_arg(args, size_t *);
+
+  if (usage == NULL) return AOM_CODEC_INVALID_PARAM;
+  *usage = sizeof(*ctx);
+  if (ctx->frame_workers != NULL) {
+    *usage += sizeof(*ctx->buffer_pool);
+    for (int i = 0; i < ctx->num_frame_workers; ++i) {
+      const FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)ctx->frame_workers[i].data1;
+      *usage += sizeof(ctx->frame_workers[i]) + sizeof(*frame_worker_data) +
+                av1_dec_get_memory_usage(frame_worker_data->pbi);
+    }
+  }
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t ctrl_set_inspection_callback(aom_codec_alg_priv_t *ctx,
                                                     va_list args) {
 #if !CONFIG_INSPECTION
@@ -1372,6 +1535,15 @@ static aom_codec_err_t ctrl_set_inspection_callback(aom_codec_alg_priv_t *ctx,
 #endif
 }
 
+static aom_codec_err_t ctrl_set_row_progress_callback(
+    aom_codec_alg_priv_t *ctx, va_list args) {
+  aom_row_progress_init *init = va_arg(args, aom_row_progress_init *);
+  if (init == NULL) return AOM_CODEC_INVALID_PARAM;
+  ctx->row_progress_cb = init->row_progress_cb;
+  ctx->row_progress_ctx = init->row_progress_ctx;
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t ctrl_ext_tile_debug(aom_codec_alg_priv_t *ctx,
                                            va_list args) {
   ctx->ext_tile_debug = va_arg(args, int);
@@ -1408,6 +1580,15 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1D_SET_ROW_MT, ctrl_set_row_mt },
   { AV1D_SET_EXT_REF_PTR, ctrl_set_ext_ref_ptr },
   { AV1D_SET_SKIP_FILM_GRAIN, ctrl_set_skip_film_grain },
+  { AV1D_SET_ROW_PROGRESS_CALLBACK, ctrl_set_row_progress_callback },
+  { AV1D_SET_INCREMENTAL_DECODE, ctrl_set_incremental_decode },
+  { AV1D_SET_SKIP_FRAMES, ctrl_set_skip_frames },
+  { AV1D_SET_SKIP_OUTPUT_ONLY_FILTERS, ctrl_set_skip_output_only_filters },
+  { AV1D_SET_LUMA_ONLY, ctrl_set_luma_only },
+  { AV1D_SET_TILE_MASK, ctrl_set_tile_mask },
+  { AV1D_SET_THREAD_POOL, ctrl_set_thread_pool },
+  { AV1D_SET_DECODE_TIMING, ctrl_set_decode_timing },
+  { AV1D_RESET_STREAM, ctrl_reset_stream },
 
   // Getters
   { AOMD_GET_FRAME_CORRUPTED, ctrl_get_frame_corrupted },
@@ -1425,6 +1606,8 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1_GET_REFERENCE, ctrl_get_reference },
   { AV1D_GET_FRAME_HEADER_INFO, ctrl_get_frame_header_info },
   { AV1D_GET_TILE_DATA, ctrl_get_tile_data },
+  { AV1D_GET_DECODE_TIMING, ctrl_get_decode_timing },
+  { AV1D_GET_MEMORY_USAGE, ctrl_get_memory_usage },
 
   { -1, NULL },
 };
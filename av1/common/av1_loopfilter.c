@@ -721,12 +721,17 @@ static void loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, AV1_COMMON *cm,
       for (mi_row = start; mi_row < stop; mi_row += MAX_MIB_SIZE) {
         for (mi_col = col_start; mi_col < col_end; mi_col += MAX_MIB_SIZE) {
           // filter vertical edges
-          av1_setup_dst_planes(pd, cm->seq_params.sb_size, frame_buffer, mi_row,
-                               mi_col, plane, plane + 1);
-          av1_filter_block_plane_vert(cm, xd, plane, &pd[plane], mi_row,
-                                      mi_col);
+          if (av1_is_area_decoded(cm, mi_row, mi_col, MAX_MIB_SIZE,
+                                  MAX_MIB_SIZE)) {
+            av1_setup_dst_planes(pd, cm->seq_params.sb_size, frame_buffer,
+                                 mi_row, mi_col, plane, plane + 1);
+            av1_filter_block_plane_vert(cm, xd, plane, &pd[plane], mi_row,
+                                        mi_col);
+          }
           // filter horizontal edges
-          if (mi_col - MAX_MIB_SIZE >= 0) {
+          if (mi_col - MAX_MIB_SIZE >= 0 &&
+              av1_is_area_decoded(cm, mi_row, mi_col - MAX_MIB_SIZE,
+                                  MAX_MIB_SIZE, MAX_MIB_SIZE)) {
             av1_setup_dst_planes(pd, cm->seq_params.sb_size, frame_buffer,
                                  mi_row, mi_col - MAX_MIB_SIZE, plane,
                                  plane + 1);
@@ -735,15 +740,21 @@ static void loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, AV1_COMMON *cm,
           }
         }
         // filter horizontal edges
-        av1_setup_dst_planes(pd, cm->seq_params.sb_size, frame_buffer, mi_row,
-                             mi_col - MAX_MIB_SIZE, plane, plane + 1);
-        av1_filter_block_plane_horz(cm, xd, plane, &pd[plane], mi_row,
-                                    mi_col - MAX_MIB_SIZE);
+        if (av1_is_area_decoded(cm, mi_row, mi_col - MAX_MIB_SIZE, MAX_MIB_SIZE,
+                                MAX_MIB_SIZE)) {
+          av1_setup_dst_planes(pd, cm->seq_params.sb_size, frame_buffer,
+                               mi_row, mi_col - MAX_MIB_SIZE, plane, plane + 1);
+          av1_filter_block_plane_horz(cm, xd, plane, &pd[plane], mi_row,
+                                      mi_col - MAX_MIB_SIZE);
+        }
       }
     } else {
       // filter all vertical edges in every 128x128 super block
       for (mi_row = start; mi_row < stop; mi_row += MAX_MIB_SIZE) {
         for (mi_col = col_start; mi_col < col_end; mi_col += MAX_MIB_SIZE) {
+          if (!av1_is_area_decoded(cm, mi_row, mi_col, MAX_MIB_SIZE,
+                                   MAX_MIB_SIZE))
+            continue;
           av1_setup_dst_planes(pd, cm->seq_params.sb_size, frame_buffer, mi_row,
                                mi_col, plane, plane + 1);
           av1_filter_block_plane_vert(cm, xd, plane, &pd[plane], mi_row,
@@ -754,6 +765,9 @@ static void loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, AV1_COMMON *cm,
       // filter all horizontal edges in every 128x128 super block
       for (mi_row = start; mi_row < stop; mi_row += MAX_MIB_SIZE) {
         for (mi_col = col_start; mi_col < col_end; mi_col += MAX_MIB_SIZE) {
+          if (!av1_is_area_decoded(cm, mi_row, mi_col, MAX_MIB_SIZE,
+                                   MAX_MIB_SIZE))
+            continue;
           av1_setup_dst_planes(pd, cm->seq_params.sb_size, frame_buffer, mi_row,
                                mi_col, plane, plane + 1);
           av1_filter_block_plane_horz(cm, xd, plane, &pd[plane], mi_row,
@@ -764,22 +778,27 @@ static void loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, AV1_COMMON *cm,
   }
 }
 
+void av1_get_filter_mi_rows(const AV1_COMMON *cm, int partial_frame,
+                            int *start_mi_row, int *end_mi_row) {
+  int mi_rows_to_filter = cm->mi_rows;
+  *start_mi_row = 0;
+  if (partial_frame && cm->mi_rows > 8) {
+    *start_mi_row = cm->mi_rows >> 1;
+    *start_mi_row &= 0xfffffff8;
+    mi_rows_to_filter = AOMMAX(cm->mi_rows / 8, 8);
+  }
+  *end_mi_row = *start_mi_row + mi_rows_to_filter;
+}
+
 void av1_loop_filter_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
                            MACROBLOCKD *xd,
 #if CONFIG_LPF_MASK
                            int is_decoding,
 #endif
                            int plane_start, int plane_end, int partial_frame) {
-  int start_mi_row, end_mi_row, mi_rows_to_filter;
+  int start_mi_row, end_mi_row;
 
-  start_mi_row = 0;
-  mi_rows_to_filter = cm->mi_rows;
-  if (partial_frame && cm->mi_rows > 8) {
-    start_mi_row = cm->mi_rows >> 1;
-    start_mi_row &= 0xfffffff8;
-    mi_rows_to_filter = AOMMAX(cm->mi_rows / 8, 8);
-  }
-  end_mi_row = start_mi_row + mi_rows_to_filter;
+  av1_get_filter_mi_rows(cm, partial_frame, &start_mi_row, &end_mi_row);
   av1_loop_filter_frame_init(cm, plane_start, plane_end);
   loop_filter_rows(frame, cm, xd, start_mi_row, end_mi_row,
 #if CONFIG_LPF_MASK
@@ -128,6 +128,14 @@ void av1_loop_filter_init(struct AV1Common *cm);
 void av1_loop_filter_frame_init(struct AV1Common *cm, int plane_start,
                                 int plane_end);
 
+// Gets the mi rows filtered by av1_loop_filter_frame(). With 'partial_frame',
+// they are a band in the middle of the frame. The filter runs on whole
+// superblock rows from 'start_mi_row', so it can change the rows up to
+// 'end_mi_row' rounded up to the superblock size, and the rows just above
+// 'start_mi_row'.
+void av1_get_filter_mi_rows(const struct AV1Common *cm, int partial_frame,
+                            int *start_mi_row, int *end_mi_row);
+
 #if CONFIG_LPF_MASK
 void av1_loop_filter_frame(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
                            struct macroblockd *xd, int is_decoding,
@@ -379,11 +379,14 @@ typedef struct eob_info {
   uint16_t max_scan_line;
 } eob_info;
 
+// Coefficients, end of block info and palette color indices of one
+// superblock. The arrays point into memory owned by the decoder and hold as
+// many entries as the superblock size and chroma subsampling of the sequence
+// need.
 typedef struct {
-  DECLARE_ALIGNED(32, tran_low_t, dqcoeff[MAX_MB_PLANE][MAX_SB_SQUARE]);
-  eob_info eob_data[MAX_MB_PLANE]
-                   [MAX_SB_SQUARE / (TX_SIZE_W_MIN * TX_SIZE_H_MIN)];
-  DECLARE_ALIGNED(16, uint8_t, color_index_map[2][MAX_SB_SQUARE]);
+  tran_low_t *dqcoeff[MAX_MB_PLANE];
+  eob_info *eob_data[MAX_MB_PLANE];
+  uint8_t *color_index_map[2];
 } CB_BUFFER;
 
 typedef struct macroblockd_plane {
@@ -511,6 +514,11 @@ typedef struct macroblockd {
 
   /* pointer to current frame */
   const YV12_BUFFER_CONFIG *cur_buf;
+  // Position, in mi units, of the top-left corner of cur_buf in the frame.
+  // Nonzero only when the decoder reconstructs a tile into its slot of a tile
+  // list output frame.
+  int cur_buf_mi_row;
+  int cur_buf_mi_col;
 
   ENTROPY_CONTEXT *above_context[MAX_MB_PLANE];
   ENTROPY_CONTEXT left_context[MAX_MB_PLANE][MAX_MIB_SIZE];
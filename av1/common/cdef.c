@@ -119,7 +119,7 @@ static INLINE void copy_rect(uint16_t *dst, int dstride, const uint16_t *src,
 void av1_cdef_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
                     MACROBLOCKD *xd) {
   const CdefInfo *const cdef_info = &cm->cdef_info;
-  const int num_planes = av1_num_planes(cm);
+  const int num_planes = av1_num_recon_planes(cm);
   DECLARE_ALIGNED(16, uint16_t, src[CDEF_INBUF_SIZE]);
   uint16_t *linebuf[3];
   uint16_t *colbuf[3];
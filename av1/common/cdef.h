@@ -41,10 +41,6 @@ int av1_cdef_compute_sb_list(const AV1_COMMON *const cm, int mi_row, int mi_col,
                              cdef_list *dlist, BLOCK_SIZE bsize);
 void av1_cdef_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm, MACROBLOCKD *xd);
 
-void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
-                     AV1_COMMON *cm, MACROBLOCKD *xd, int pick_method,
-                     int rdmult);
-
 #ifdef __cplusplus
 }  // extern "C"
 #endif
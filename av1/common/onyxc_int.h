@@ -525,6 +525,13 @@ typedef struct AV1Common {
   int byte_alignment;
   int skip_loop_filter;
   int skip_film_grain;
+  // Boolean: whether only the luma plane is reconstructed and post-filtered.
+  // Chroma coefficients are still parsed.
+  int luma_only;
+  // Boolean: whether only some of the tiles of the current frame are
+  // reconstructed. The mode info of the other tiles is left NULL, and the post
+  // filters skip them.
+  int partial_tile_decode;
 
   // External BufferPool passed from outside.
   BufferPool *buffer_pool;
@@ -760,6 +767,27 @@ static INLINE int av1_num_planes(const AV1_COMMON *cm) {
   return cm->seq_params.monochrome ? 1 : MAX_MB_PLANE;
 }
 
+// Returns the number of planes that are reconstructed and post-filtered.
+static INLINE int av1_num_recon_planes(const AV1_COMMON *cm) {
+  return cm->luma_only ? 1 : av1_num_planes(cm);
+}
+
+// Returns 1 if a superblock overlapping the mi_high x mi_wide area at
+// (mi_row, mi_col) has been reconstructed in the current frame.
+static INLINE int av1_is_area_decoded(const AV1_COMMON *cm, int mi_row,
+                                      int mi_col, int mi_high, int mi_wide) {
+  if (!cm->partial_tile_decode) return 1;
+  const int sb_mask = ~(cm->seq_params.mib_size - 1);
+  const int row_end = AOMMIN(mi_row + mi_high, cm->mi_rows);
+  const int col_end = AOMMIN(mi_col + mi_wide, cm->mi_cols);
+  for (int r = mi_row & sb_mask; r < row_end; r += cm->seq_params.mib_size) {
+    for (int c = mi_col & sb_mask; c < col_end; c += cm->seq_params.mib_size) {
+      if (cm->mi_grid_base[r * cm->mi_stride + c] != NULL) return 1;
+    }
+  }
+  return 0;
+}
+
 static INLINE void av1_init_above_context(AV1_COMMON *cm, MACROBLOCKD *xd,
                                           const int tile_row) {
   const int num_planes = av1_num_planes(cm);
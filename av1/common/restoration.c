@@ -1089,6 +1089,51 @@ void av1_loop_restoration_filter_unit(
   }
 }
 
+// Returns 1 if only some of the tiles of the frame have been reconstructed.
+// Superres frames are upscaled as a whole, so all their units are filtered.
+static int is_partial_frame(const AV1_COMMON *cm) {
+  return cm->partial_tile_decode && !av1_superres_scaled(cm);
+}
+
+// Returns 1 if the restoration unit overlaps the reconstructed area of a
+// partially decoded frame.
+static int is_rest_unit_decoded(const FilterFrameCtxt *ctxt,
+                                const RestorationTileLimits *limits) {
+  const int mi_row = (limits->v_start << ctxt->ss_y) >> MI_SIZE_LOG2;
+  const int mi_col = (limits->h_start << ctxt->ss_x) >> MI_SIZE_LOG2;
+  const int mi_row_end =
+      ((limits->v_end << ctxt->ss_y) + MI_SIZE - 1) >> MI_SIZE_LOG2;
+  const int mi_col_end =
+      ((limits->h_end << ctxt->ss_x) + MI_SIZE - 1) >> MI_SIZE_LOG2;
+  return av1_is_area_decoded(ctxt->cm, mi_row, mi_col, mi_row_end - mi_row,
+                             mi_col_end - mi_col);
+}
+
+// Copies the parts of the unit that lie in superblocks which were not
+// reconstructed from data8 to dst8, so that they are left unchanged when dst8
+// is copied back to the frame.
+static void keep_undecoded_area(const FilterFrameCtxt *ctxt,
+                                const RestorationTileLimits *limits) {
+  const AV1_COMMON *const cm = ctxt->cm;
+  const int sb_w = (cm->seq_params.mib_size << MI_SIZE_LOG2) >> ctxt->ss_x;
+  const int sb_h = (cm->seq_params.mib_size << MI_SIZE_LOG2) >> ctxt->ss_y;
+  for (int y = limits->v_start; y < limits->v_end;) {
+    const int y_end = AOMMIN((y / sb_h + 1) * sb_h, limits->v_end);
+    for (int x = limits->h_start; x < limits->h_end;) {
+      const int x_end = AOMMIN((x / sb_w + 1) * sb_w, limits->h_end);
+      if (!av1_is_area_decoded(cm, (y << ctxt->ss_y) >> MI_SIZE_LOG2,
+                               (x << ctxt->ss_x) >> MI_SIZE_LOG2, 1, 1)) {
+        copy_tile(x_end - x, y_end - y,
+                  ctxt->data8 + y * ctxt->data_stride + x, ctxt->data_stride,
+                  ctxt->dst8 + y * ctxt->dst_stride + x, ctxt->dst_stride,
+                  ctxt->highbd);
+      }
+      x = x_end;
+    }
+    y = y_end;
+  }
+}
+
 static void filter_frame_on_unit(const RestorationTileLimits *limits,
                                  const AV1PixelRect *tile_rect,
                                  int rest_unit_idx, void *priv, int32_t *tmpbuf,
@@ -1096,6 +1141,18 @@ static void filter_frame_on_unit(const RestorationTileLimits *limits,
   FilterFrameCtxt *ctxt = (FilterFrameCtxt *)priv;
   const RestorationInfo *rsi = ctxt->rsi;
 
+  if (is_partial_frame(ctxt->cm)) {
+    if (is_rest_unit_decoded(ctxt, limits)) {
+      av1_loop_restoration_filter_unit(
+          limits, &rsi->unit_info[rest_unit_idx], &rsi->boundaries, rlbs,
+          tile_rect, ctxt->tile_stripe0, ctxt->ss_x, ctxt->ss_y, ctxt->highbd,
+          ctxt->bit_depth, ctxt->data8, ctxt->data_stride, ctxt->dst8,
+          ctxt->dst_stride, tmpbuf, rsi->optimized_lr);
+    }
+    keep_undecoded_area(ctxt, limits);
+    return;
+  }
+
   av1_loop_restoration_filter_unit(
       limits, &rsi->unit_info[rest_unit_idx], &rsi->boundaries, rlbs, tile_rect,
       ctxt->tile_stripe0, ctxt->ss_x, ctxt->ss_y, ctxt->highbd, ctxt->bit_depth,
@@ -1141,6 +1198,7 @@ void av1_loop_restoration_filter_frame_init(AV1LrStruct *lr_ctxt,
                      frame->strides[is_uv], RESTORATION_BORDER,
                      RESTORATION_BORDER, highbd);
 
+    lr_plane_ctxt->cm = cm;
     lr_plane_ctxt->rsi = rsi;
     lr_plane_ctxt->ss_x = is_uv && seq_params->subsampling_x;
     lr_plane_ctxt->ss_y = is_uv && seq_params->subsampling_y;
@@ -1191,7 +1249,7 @@ void av1_loop_restoration_filter_frame(YV12_BUFFER_CONFIG *frame,
                                        AV1_COMMON *cm, int optimized_lr,
                                        void *lr_ctxt) {
   assert(!cm->all_lossless);
-  const int num_planes = av1_num_planes(cm);
+  const int num_planes = av1_num_recon_planes(cm);
 
   AV1LrStruct *loop_rest_ctxt = (AV1LrStruct *)lr_ctxt;
 
@@ -1558,7 +1616,7 @@ static void save_tile_row_boundary_lines(const YV12_BUFFER_CONFIG *frame,
 // lines are saved in rst_internal.stripe_boundary_lines
 void av1_loop_restoration_save_boundary_lines(const YV12_BUFFER_CONFIG *frame,
                                               AV1_COMMON *cm, int after_cdef) {
-  const int num_planes = av1_num_planes(cm);
+  const int num_planes = av1_num_recon_planes(cm);
   const int use_highbd = cm->seq_params.use_highbitdepth;
   for (int p = 0; p < num_planes; ++p) {
     save_tile_row_boundary_lines(frame, use_highbd, p, cm, after_cdef);
@@ -262,6 +262,7 @@ typedef void (*rest_unit_visitor_t)(const RestorationTileLimits *limits,
                                     RestorationLineBuffers *rlbs);
 
 typedef struct FilterFrameCtxt {
+  const struct AV1Common *cm;
   const RestorationInfo *rsi;
   int tile_stripe0;
   int ss_x, ss_y;
@@ -9,6 +9,8 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <limits.h>
+
 #include "config/aom_config.h"
 #include "config/aom_scale_rtcd.h"
 
@@ -77,10 +79,10 @@ static void loop_filter_alloc(AV1LfSync *lf_sync, AV1_COMMON *cm, int rows,
       }
     }
 
-    CHECK_MEM_ERROR(cm, lf_sync->job_mutex,
-                    aom_malloc(sizeof(*(lf_sync->job_mutex))));
-    if (lf_sync->job_mutex) {
-      pthread_mutex_init(lf_sync->job_mutex, NULL);
+    CHECK_MEM_ERROR(cm, lf_sync->rows_done_mutex,
+                    aom_malloc(sizeof(*(lf_sync->rows_done_mutex))));
+    if (lf_sync->rows_done_mutex) {
+      pthread_mutex_init(lf_sync->rows_done_mutex, NULL);
     }
   }
 #endif  // CONFIG_MULTITHREAD
@@ -95,6 +97,8 @@ static void loop_filter_alloc(AV1LfSync *lf_sync, AV1_COMMON *cm, int rows,
   CHECK_MEM_ERROR(
       cm, lf_sync->job_queue,
       aom_malloc(sizeof(*(lf_sync->job_queue)) * rows * MAX_MB_PLANE * 2));
+  CHECK_MEM_ERROR(cm, lf_sync->planes_done,
+                  aom_malloc(sizeof(*(lf_sync->planes_done)) * rows));
   // Set up nsync.
   lf_sync->sync_range = get_sync_range(width);
 }
@@ -119,9 +123,9 @@ void av1_loop_filter_dealloc(AV1LfSync *lf_sync) {
         aom_free(lf_sync->cond_[j]);
       }
     }
-    if (lf_sync->job_mutex != NULL) {
-      pthread_mutex_destroy(lf_sync->job_mutex);
-      aom_free(lf_sync->job_mutex);
+    if (lf_sync->rows_done_mutex != NULL) {
+      pthread_mutex_destroy(lf_sync->rows_done_mutex);
+      aom_free(lf_sync->rows_done_mutex);
     }
 #endif  // CONFIG_MULTITHREAD
     aom_free(lf_sync->lfdata);
@@ -130,6 +134,7 @@ void av1_loop_filter_dealloc(AV1LfSync *lf_sync) {
     }
 
     aom_free(lf_sync->job_queue);
+    aom_free(lf_sync->planes_done);
     // clear the structure as the source of this call may be a resize in which
     // case this call will be followed by an _alloc() which may fail.
     av1_zero(*lf_sync);
@@ -156,13 +161,9 @@ static INLINE void sync_read(AV1LfSync *const lf_sync, int r, int c,
   const int nsync = lf_sync->sync_range;
 
   if (r && !(c & (nsync - 1))) {
-    pthread_mutex_t *const mutex = &lf_sync->mutex_[plane][r - 1];
-    pthread_mutex_lock(mutex);
-
-    while (c > lf_sync->cur_sb_col[plane][r - 1] - nsync) {
-      pthread_cond_wait(&lf_sync->cond_[plane][r - 1], mutex);
-    }
-    pthread_mutex_unlock(mutex);
+    av1_sync_wait(&lf_sync->cur_sb_col[plane][r - 1], c + nsync,
+                  &lf_sync->mutex_[plane][r - 1],
+                  &lf_sync->cond_[plane][r - 1]);
   }
 #else
   (void)lf_sync;
@@ -188,10 +189,9 @@ static INLINE void sync_write(AV1LfSync *const lf_sync, int r, int c,
   }
 
   if (sig) {
-    pthread_mutex_lock(&lf_sync->mutex_[plane][r]);
-
-    lf_sync->cur_sb_col[plane][r] = cur;
+    aom_atomic_store_release(&lf_sync->cur_sb_col[plane][r], cur);
 
+    pthread_mutex_lock(&lf_sync->mutex_[plane][r]);
     pthread_cond_broadcast(&lf_sync->cond_[plane][r]);
     pthread_mutex_unlock(&lf_sync->mutex_[plane][r]);
   }
@@ -213,7 +213,8 @@ static void enqueue_lf_jobs(AV1LfSync *lf_sync, AV1_COMMON *cm, int start,
   int mi_row, plane, dir;
   AV1LfMTInfo *lf_job_queue = lf_sync->job_queue;
   lf_sync->jobs_enqueued = 0;
-  lf_sync->jobs_dequeued = 0;
+  lf_sync->num_filtered_planes = 0;
+  aom_atomic_init(&lf_sync->jobs_dequeued, 0);
 
   for (dir = 0; dir < 2; dir++) {
     for (plane = plane_start; plane < plane_end; plane++) {
@@ -223,6 +224,7 @@ static void enqueue_lf_jobs(AV1LfSync *lf_sync, AV1_COMMON *cm, int start,
         continue;
       else if (plane == 2 && !(cm->lf.filter_level_v))
         continue;
+      if (dir == 0) lf_sync->num_filtered_planes++;
 #if CONFIG_LPF_MASK
       int step = MAX_MIB_SIZE;
       if (is_decoding) {
@@ -247,14 +249,8 @@ static AV1LfMTInfo *get_lf_job_info(AV1LfSync *lf_sync) {
   AV1LfMTInfo *cur_job_info = NULL;
 
 #if CONFIG_MULTITHREAD
-  pthread_mutex_lock(lf_sync->job_mutex);
-
-  if (lf_sync->jobs_dequeued < lf_sync->jobs_enqueued) {
-    cur_job_info = lf_sync->job_queue + lf_sync->jobs_dequeued;
-    lf_sync->jobs_dequeued++;
-  }
-
-  pthread_mutex_unlock(lf_sync->job_mutex);
+  const int job = aom_atomic_fetch_add(&lf_sync->jobs_dequeued, 1);
+  if (job < lf_sync->jobs_enqueued) cur_job_info = lf_sync->job_queue + job;
 #else
   (void)lf_sync;
 #endif
@@ -262,6 +258,40 @@ static AV1LfMTInfo *get_lf_job_info(AV1LfSync *lf_sync) {
   return cur_job_info;
 }
 
+// Filtering the horizontal edges of a SB row modifies up to 6 luma rows, or 2
+// chroma rows, above the row.
+#define LF_ROWS_ABOVE_SB_ROW 8
+
+// Records that the horizontal edges of SB row 'r' of one plane are filtered,
+// and reports the rows that the filtering of the SB rows below will not
+// modify.
+static void lf_sync_row_done(AV1LfSync *const lf_sync, const AV1_COMMON *cm,
+                             int r) {
+#if CONFIG_MULTITHREAD
+  if (lf_sync->rows_done == NULL) return;
+  pthread_mutex_lock(lf_sync->rows_done_mutex);
+  ++lf_sync->planes_done[r];
+  const int sb_rows_done = lf_sync->sb_rows_done;
+  while (lf_sync->sb_rows_done < lf_sync->rows &&
+         lf_sync->planes_done[lf_sync->sb_rows_done] ==
+             lf_sync->num_filtered_planes)
+    ++lf_sync->sb_rows_done;
+  if (lf_sync->sb_rows_done > sb_rows_done) {
+    int rows = cm->height;
+    if (lf_sync->sb_rows_done < lf_sync->rows) {
+      rows = AOMMIN(rows, (lf_sync->sb_rows_done << lf_sync->sb_size_log2) -
+                              LF_ROWS_ABOVE_SB_ROW);
+    }
+    lf_sync->rows_done(lf_sync->rows_done_priv, rows);
+  }
+  pthread_mutex_unlock(lf_sync->rows_done_mutex);
+#else
+  (void)lf_sync;
+  (void)cm;
+  (void)r;
+#endif  // CONFIG_MULTITHREAD
+}
+
 // Implement row loopfiltering for each thread.
 static INLINE void thread_loop_filter_rows(
     const YV12_BUFFER_CONFIG *const frame_buffer, AV1_COMMON *const cm,
@@ -285,11 +315,13 @@ static INLINE void thread_loop_filter_rows(
         for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MAX_MIB_SIZE) {
           c = mi_col >> MAX_MIB_SIZE_LOG2;
 
-          av1_setup_dst_planes(planes, cm->seq_params.sb_size, frame_buffer,
-                               mi_row, mi_col, plane, plane + 1);
-
-          av1_filter_block_plane_vert(cm, xd, plane, &planes[plane], mi_row,
-                                      mi_col);
+          if (av1_is_area_decoded(cm, mi_row, mi_col, MAX_MIB_SIZE,
+                                  MAX_MIB_SIZE)) {
+            av1_setup_dst_planes(planes, cm->seq_params.sb_size, frame_buffer,
+                                 mi_row, mi_col, plane, plane + 1);
+            av1_filter_block_plane_vert(cm, xd, plane, &planes[plane], mi_row,
+                                        mi_col);
+          }
           sync_write(lf_sync, r, c, sb_cols, plane);
         }
       } else if (dir == 1) {
@@ -304,11 +336,15 @@ static INLINE void thread_loop_filter_rows(
           // completed
           sync_read(lf_sync, r + 1, c, plane);
 
+          if (!av1_is_area_decoded(cm, mi_row, mi_col, MAX_MIB_SIZE,
+                                   MAX_MIB_SIZE))
+            continue;
           av1_setup_dst_planes(planes, cm->seq_params.sb_size, frame_buffer,
                                mi_row, mi_col, plane, plane + 1);
           av1_filter_block_plane_horz(cm, xd, plane, &planes[plane], mi_row,
                                       mi_col);
         }
+        lf_sync_row_done(lf_sync, cm, r);
       }
     } else {
       break;
@@ -373,6 +409,7 @@ static INLINE void thread_loop_filter_bitmask_rows(
           av1_filter_block_plane_bitmask_horz(cm, &planes[plane], plane, mi_row,
                                               mi_col);
         }
+        lf_sync_row_done(lf_sync, cm, r);
       }
     } else {
       break;
@@ -397,21 +434,27 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
                                 int is_decoding,
 #endif
                                 AVxWorker *workers, int nworkers,
-                                AV1LfSync *lf_sync) {
+                                AV1LfSync *lf_sync,
+                                av1_rows_done_fn_t rows_done,
+                                void *rows_done_priv) {
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
 #if CONFIG_LPF_MASK
   int sb_rows;
+  int mib_size_log2;
   if (is_decoding) {
     sb_rows =
         ALIGN_POWER_OF_TWO(cm->mi_rows, MIN_MIB_SIZE_LOG2) >> MIN_MIB_SIZE_LOG2;
+    mib_size_log2 = MIN_MIB_SIZE_LOG2;
   } else {
     sb_rows =
         ALIGN_POWER_OF_TWO(cm->mi_rows, MAX_MIB_SIZE_LOG2) >> MAX_MIB_SIZE_LOG2;
+    mib_size_log2 = MAX_MIB_SIZE_LOG2;
   }
 #else
   // Number of superblock rows and cols
   const int sb_rows =
       ALIGN_POWER_OF_TWO(cm->mi_rows, MAX_MIB_SIZE_LOG2) >> MAX_MIB_SIZE_LOG2;
+  const int mib_size_log2 = MAX_MIB_SIZE_LOG2;
 #endif
   const int num_workers = nworkers;
   int i;
@@ -427,6 +470,16 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
     memset(lf_sync->cur_sb_col[i], -1,
            sizeof(*(lf_sync->cur_sb_col[i])) * sb_rows);
   }
+  // The SB rows above 'start' are not filtered, so mark them as done for the
+  // first filtered row not to wait for them.
+  const int sb_cols =
+      ALIGN_POWER_OF_TWO(cm->mi_cols, MAX_MIB_SIZE_LOG2) >> MAX_MIB_SIZE_LOG2;
+  for (i = 0; i < MAX_MB_PLANE; i++) {
+    for (int r = 0; r < (start >> MAX_MIB_SIZE_LOG2); r++) {
+      aom_atomic_init(&lf_sync->cur_sb_col[i][r],
+                      sb_cols + lf_sync->sync_range);
+    }
+  }
 
   enqueue_lf_jobs(lf_sync, cm, start, stop,
 #if CONFIG_LPF_MASK
@@ -434,6 +487,12 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
 #endif
                   plane_start, plane_end);
 
+  lf_sync->rows_done = rows_done;
+  lf_sync->rows_done_priv = rows_done_priv;
+  lf_sync->sb_size_log2 = mib_size_log2 + MI_SIZE_LOG2;
+  lf_sync->sb_rows_done = start >> mib_size_log2;
+  memset(lf_sync->planes_done, 0, sizeof(*(lf_sync->planes_done)) * sb_rows);
+
   // Set up loopfilter thread data.
   for (i = 0; i < num_workers; ++i) {
     AVxWorker *const worker = &workers[i];
@@ -475,17 +534,11 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
                               int is_decoding,
 #endif
                               AVxWorker *workers, int num_workers,
-                              AV1LfSync *lf_sync) {
-  int start_mi_row, end_mi_row, mi_rows_to_filter;
+                              AV1LfSync *lf_sync, av1_rows_done_fn_t rows_done,
+                              void *rows_done_priv) {
+  int start_mi_row, end_mi_row;
 
-  start_mi_row = 0;
-  mi_rows_to_filter = cm->mi_rows;
-  if (partial_frame && cm->mi_rows > 8) {
-    start_mi_row = cm->mi_rows >> 1;
-    start_mi_row &= 0xfffffff8;
-    mi_rows_to_filter = AOMMAX(cm->mi_rows / 8, 8);
-  }
-  end_mi_row = start_mi_row + mi_rows_to_filter;
+  av1_get_filter_mi_rows(cm, partial_frame, &start_mi_row, &end_mi_row);
   av1_loop_filter_frame_init(cm, plane_start, plane_end);
 
 #if CONFIG_LPF_MASK
@@ -510,14 +563,17 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
       av1_build_bitmask_horz_info(cm, &pd[plane], plane);
     }
     loop_filter_rows_mt(frame, cm, xd, start_mi_row, end_mi_row, plane_start,
-                        plane_end, 1, workers, num_workers, lf_sync);
+                        plane_end, 1, workers, num_workers, lf_sync, rows_done,
+                        rows_done_priv);
   } else {
     loop_filter_rows_mt(frame, cm, xd, start_mi_row, end_mi_row, plane_start,
-                        plane_end, 0, workers, num_workers, lf_sync);
+                        plane_end, 0, workers, num_workers, lf_sync, rows_done,
+                        rows_done_priv);
   }
 #else
   loop_filter_rows_mt(frame, cm, xd, start_mi_row, end_mi_row, plane_start,
-                      plane_end, workers, num_workers, lf_sync);
+                      plane_end, workers, num_workers, lf_sync, rows_done,
+                      rows_done_priv);
 #endif
 }
 
@@ -527,13 +583,9 @@ static INLINE void lr_sync_read(void *const lr_sync, int r, int c, int plane) {
   const int nsync = loop_res_sync->sync_range;
 
   if (r && !(c & (nsync - 1))) {
-    pthread_mutex_t *const mutex = &loop_res_sync->mutex_[plane][r - 1];
-    pthread_mutex_lock(mutex);
-
-    while (c > loop_res_sync->cur_sb_col[plane][r - 1] - nsync) {
-      pthread_cond_wait(&loop_res_sync->cond_[plane][r - 1], mutex);
-    }
-    pthread_mutex_unlock(mutex);
+    av1_sync_wait(&loop_res_sync->cur_sb_col[plane][r - 1], c + nsync,
+                  &loop_res_sync->mutex_[plane][r - 1],
+                  &loop_res_sync->cond_[plane][r - 1]);
   }
 #else
   (void)lr_sync;
@@ -560,10 +612,9 @@ static INLINE void lr_sync_write(void *const lr_sync, int r, int c,
   }
 
   if (sig) {
-    pthread_mutex_lock(&loop_res_sync->mutex_[plane][r]);
-
-    loop_res_sync->cur_sb_col[plane][r] = cur;
+    aom_atomic_store_release(&loop_res_sync->cur_sb_col[plane][r], cur);
 
+    pthread_mutex_lock(&loop_res_sync->mutex_[plane][r]);
     pthread_cond_broadcast(&loop_res_sync->cond_[plane][r]);
     pthread_mutex_unlock(&loop_res_sync->mutex_[plane][r]);
   }
@@ -604,10 +655,10 @@ static void loop_restoration_alloc(AV1LrSync *lr_sync, AV1_COMMON *cm,
       }
     }
 
-    CHECK_MEM_ERROR(cm, lr_sync->job_mutex,
-                    aom_malloc(sizeof(*(lr_sync->job_mutex))));
-    if (lr_sync->job_mutex) {
-      pthread_mutex_init(lr_sync->job_mutex, NULL);
+    CHECK_MEM_ERROR(cm, lr_sync->rows_done_mutex,
+                    aom_malloc(sizeof(*(lr_sync->rows_done_mutex))));
+    if (lr_sync->rows_done_mutex) {
+      pthread_mutex_init(lr_sync->rows_done_mutex, NULL);
     }
   }
 #endif  // CONFIG_MULTITHREAD
@@ -633,6 +684,9 @@ static void loop_restoration_alloc(AV1LrSync *lr_sync, AV1_COMMON *cm,
     CHECK_MEM_ERROR(
         cm, lr_sync->cur_sb_col[j],
         aom_malloc(sizeof(*(lr_sync->cur_sb_col[j])) * num_rows_lr));
+    CHECK_MEM_ERROR(
+        cm, lr_sync->copy_end[j],
+        aom_malloc(sizeof(*(lr_sync->copy_end[j])) * num_rows_lr));
   }
   CHECK_MEM_ERROR(
       cm, lr_sync->job_queue,
@@ -661,13 +715,14 @@ void av1_loop_restoration_dealloc(AV1LrSync *lr_sync, int num_workers) {
         aom_free(lr_sync->cond_[j]);
       }
     }
-    if (lr_sync->job_mutex != NULL) {
-      pthread_mutex_destroy(lr_sync->job_mutex);
-      aom_free(lr_sync->job_mutex);
+    if (lr_sync->rows_done_mutex != NULL) {
+      pthread_mutex_destroy(lr_sync->rows_done_mutex);
+      aom_free(lr_sync->rows_done_mutex);
     }
 #endif  // CONFIG_MULTITHREAD
     for (j = 0; j < MAX_MB_PLANE; j++) {
       aom_free(lr_sync->cur_sb_col[j]);
+      aom_free(lr_sync->copy_end[j]);
     }
 
     aom_free(lr_sync->job_queue);
@@ -693,11 +748,11 @@ static void enqueue_lr_jobs(AV1LrSync *lr_sync, AV1LrStruct *lr_ctxt,
                             AV1_COMMON *cm) {
   FilterFrameCtxt *ctxt = lr_ctxt->ctxt;
 
-  const int num_planes = av1_num_planes(cm);
+  const int num_planes = av1_num_recon_planes(cm);
   AV1LrMTInfo *lr_job_queue = lr_sync->job_queue;
   int32_t lr_job_counter[2], num_even_lr_jobs = 0;
   lr_sync->jobs_enqueued = 0;
-  lr_sync->jobs_dequeued = 0;
+  aom_atomic_init(&lr_sync->jobs_dequeued, 0);
 
   for (int plane = 0; plane < num_planes; plane++) {
     if (cm->rst_info[plane].frame_restoration_type == RESTORE_NONE) continue;
@@ -771,14 +826,8 @@ static AV1LrMTInfo *get_lr_job_info(AV1LrSync *lr_sync) {
   AV1LrMTInfo *cur_job_info = NULL;
 
 #if CONFIG_MULTITHREAD
-  pthread_mutex_lock(lr_sync->job_mutex);
-
-  if (lr_sync->jobs_dequeued < lr_sync->jobs_enqueued) {
-    cur_job_info = lr_sync->job_queue + lr_sync->jobs_dequeued;
-    lr_sync->jobs_dequeued++;
-  }
-
-  pthread_mutex_unlock(lr_sync->job_mutex);
+  const int job = aom_atomic_fetch_add(&lr_sync->jobs_dequeued, 1);
+  if (job < lr_sync->jobs_enqueued) cur_job_info = lr_sync->job_queue + job;
 #else
   (void)lr_sync;
 #endif
@@ -786,6 +835,39 @@ static AV1LrMTInfo *get_lr_job_info(AV1LrSync *lr_sync) {
   return cur_job_info;
 }
 
+// Records that a job copied its rows to the frame, and reports the rows all
+// the planes copied.
+static void lr_sync_job_done(AV1LrSync *const lr_sync,
+                             const FilterFrameCtxt *ctxt,
+                             const AV1LrMTInfo *job) {
+#if CONFIG_MULTITHREAD
+  if (lr_sync->rows_done == NULL) return;
+  const int plane = job->plane;
+  const int num_units = ctxt[plane].rsi->vert_units_per_tile;
+  int prev_rows = lr_sync->frame_height;
+  int rows = lr_sync->frame_height;
+  pthread_mutex_lock(lr_sync->rows_done_mutex);
+  for (int i = 0; i < MAX_MB_PLANE; ++i)
+    prev_rows = AOMMIN(prev_rows, lr_sync->rows_final[i]);
+  lr_sync->copy_end[plane][job->lr_unit_row] = job->v_copy_end;
+  while (lr_sync->units_done[plane] < num_units &&
+         lr_sync->copy_end[plane][lr_sync->units_done[plane]] >= 0) {
+    lr_sync->rows_final[plane] =
+        lr_sync->copy_end[plane][lr_sync->units_done[plane]]
+        << ctxt[plane].ss_y;
+    ++lr_sync->units_done[plane];
+  }
+  for (int i = 0; i < MAX_MB_PLANE; ++i)
+    rows = AOMMIN(rows, lr_sync->rows_final[i]);
+  if (rows > prev_rows) lr_sync->rows_done(lr_sync->rows_done_priv, rows);
+  pthread_mutex_unlock(lr_sync->rows_done_mutex);
+#else
+  (void)lr_sync;
+  (void)ctxt;
+  (void)job;
+#endif  // CONFIG_MULTITHREAD
+}
+
 // Implement row loop restoration for each thread.
 static int loop_restoration_row_worker(void *arg1, void *arg2) {
   AV1LrSync *const lr_sync = (AV1LrSync *)arg1;
@@ -835,6 +917,7 @@ static int loop_restoration_row_worker(void *arg1, void *arg2) {
       copy_funs[plane](lr_ctxt->dst, lr_ctxt->frame, ctxt[plane].tile_rect.left,
                        ctxt[plane].tile_rect.right, cur_job_info->v_copy_start,
                        cur_job_info->v_copy_end);
+      lr_sync_job_done(lr_sync, ctxt, cur_job_info);
     } else {
       break;
     }
@@ -844,10 +927,12 @@ static int loop_restoration_row_worker(void *arg1, void *arg2) {
 
 static void foreach_rest_unit_in_planes_mt(AV1LrStruct *lr_ctxt,
                                            AVxWorker *workers, int nworkers,
-                                           AV1LrSync *lr_sync, AV1_COMMON *cm) {
+                                           AV1LrSync *lr_sync, AV1_COMMON *cm,
+                                           av1_rows_done_fn_t rows_done,
+                                           void *rows_done_priv) {
   FilterFrameCtxt *ctxt = lr_ctxt->ctxt;
 
-  const int num_planes = av1_num_planes(cm);
+  const int num_planes = av1_num_recon_planes(cm);
 
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
   int num_rows_lr = 0;
@@ -883,6 +968,21 @@ static void foreach_rest_unit_in_planes_mt(AV1LrStruct *lr_ctxt,
 
   enqueue_lr_jobs(lr_sync, lr_ctxt, cm);
 
+  lr_sync->rows_done = rows_done;
+  lr_sync->rows_done_priv = rows_done_priv;
+  lr_sync->frame_height = cm->height;
+  for (i = 0; i < MAX_MB_PLANE; i++) {
+    lr_sync->units_done[i] = 0;
+    // The planes without restoration are final already.
+    lr_sync->rows_final[i] = INT_MAX;
+    if (i < num_planes &&
+        cm->rst_info[i].frame_restoration_type != RESTORE_NONE) {
+      lr_sync->rows_final[i] = 0;
+      memset(lr_sync->copy_end[i], -1,
+             sizeof(*(lr_sync->copy_end[i])) * num_rows_lr);
+    }
+  }
+
   // Set up looprestoration thread data.
   for (i = 0; i < num_workers; ++i) {
     AVxWorker *const worker = &workers[i];
@@ -905,13 +1005,13 @@ static void foreach_rest_unit_in_planes_mt(AV1LrStruct *lr_ctxt,
   }
 }
 
-void av1_loop_restoration_filter_frame_mt(YV12_BUFFER_CONFIG *frame,
-                                          AV1_COMMON *cm, int optimized_lr,
-                                          AVxWorker *workers, int num_workers,
-                                          AV1LrSync *lr_sync, void *lr_ctxt) {
+void av1_loop_restoration_filter_frame_mt(
+    YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm, int optimized_lr,
+    AVxWorker *workers, int num_workers, AV1LrSync *lr_sync, void *lr_ctxt,
+    av1_rows_done_fn_t rows_done, void *rows_done_priv) {
   assert(!cm->all_lossless);
 
-  const int num_planes = av1_num_planes(cm);
+  const int num_planes = av1_num_recon_planes(cm);
 
   AV1LrStruct *loop_rest_ctxt = (AV1LrStruct *)lr_ctxt;
 
@@ -919,5 +1019,5 @@ void av1_loop_restoration_filter_frame_mt(YV12_BUFFER_CONFIG *frame,
                                          optimized_lr, num_planes);
 
   foreach_rest_unit_in_planes_mt(loop_rest_ctxt, workers, num_workers, lr_sync,
-                                 cm);
+                                 cm, rows_done, rows_done_priv);
 }
@@ -15,6 +15,7 @@
 #include "config/aom_config.h"
 
 #include "av1/common/av1_loopfilter.h"
+#include "aom_util/aom_atomics.h"
 #include "aom_util/aom_thread.h"
 
 #ifdef __cplusplus
@@ -23,6 +24,11 @@ extern "C" {
 
 struct AV1Common;
 
+// Receives the number of luma rows at the top of the frame that a filter pass
+// will not modify any more. The calls are serialized and the count grows from
+// call to call.
+typedef void (*av1_rows_done_fn_t)(void *priv, int rows);
+
 typedef struct AV1LfMTInfo {
   int mi_row;
   int plane;
@@ -36,7 +42,7 @@ typedef struct AV1LfSyncData {
   pthread_cond_t *cond_[MAX_MB_PLANE];
 #endif
   // Allocate memory to store the loop-filtered superblock index in each row.
-  int *cur_sb_col[MAX_MB_PLANE];
+  aom_atomic_int *cur_sb_col[MAX_MB_PLANE];
   // The optimal sync_range for different resolution and platform should be
   // determined by testing. Currently, it is chosen to be a power-of-2 number.
   int sync_range;
@@ -46,12 +52,23 @@ typedef struct AV1LfSyncData {
   LFWorkerData *lfdata;
   int num_workers;
 
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *job_mutex;
-#endif
   AV1LfMTInfo *job_queue;
   int jobs_enqueued;
-  int jobs_dequeued;
+  // Jobs are claimed by incrementing this counter, without a lock.
+  aom_atomic_int jobs_dequeued;
+
+  // Optional report of the rows that are final, set for each frame.
+  av1_rows_done_fn_t rows_done;
+  void *rows_done_priv;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *rows_done_mutex;
+#endif
+  // Number of planes that filtered the horizontal edges of each SB row, and
+  // the number of top SB rows filtered in all of the filtered planes.
+  int *planes_done;
+  int sb_rows_done;
+  int num_filtered_planes;
+  int sb_size_log2;
 } AV1LfSync;
 
 typedef struct AV1LrMTInfo {
@@ -77,7 +94,7 @@ typedef struct AV1LrSyncData {
   pthread_cond_t *cond_[MAX_MB_PLANE];
 #endif
   // Allocate memory to store the loop-restoration block index in each row.
-  int *cur_sb_col[MAX_MB_PLANE];
+  aom_atomic_int *cur_sb_col[MAX_MB_PLANE];
   // The optimal sync_range for different resolution and platform should be
   // determined by testing. Currently, it is chosen to be a power-of-2 number.
   int sync_range;
@@ -86,17 +103,51 @@ typedef struct AV1LrSyncData {
 
   int num_workers;
 
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *job_mutex;
-#endif
   // Row-based parallel loopfilter data
   LRWorkerData *lrworkerdata;
 
   AV1LrMTInfo *job_queue;
   int jobs_enqueued;
-  int jobs_dequeued;
+  // Jobs are claimed by incrementing this counter, without a lock.
+  aom_atomic_int jobs_dequeued;
+
+  // Optional report of the rows that are final, set for each frame.
+  av1_rows_done_fn_t rows_done;
+  void *rows_done_priv;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *rows_done_mutex;
+#endif
+  // End of the rows each finished job copied to the frame, or -1, for each
+  // unit row of each plane. A plane's rows are final up to the copy end of
+  // the last job of the run of finished jobs from the top.
+  int *copy_end[MAX_MB_PLANE];
+  int units_done[MAX_MB_PLANE];
+  int rows_final[MAX_MB_PLANE];
+  int frame_height;
 } AV1LrSync;
 
+#if CONFIG_MULTITHREAD
+// Number of times a row waiting on the row above polls its progress before
+// sleeping on the condition variable. The row above is usually only a few
+// superblocks ahead, so most waits end while polling.
+#define AV1_SYNC_SPIN_COUNT 1024
+
+// Waits until '*progress' is at least 'target'. The writer must store the
+// progress before it locks 'mutex' and signals 'cond'.
+static INLINE void av1_sync_wait(aom_atomic_int *progress, int target,
+                                 pthread_mutex_t *mutex, pthread_cond_t *cond) {
+  for (int i = 0; i < AV1_SYNC_SPIN_COUNT; ++i) {
+    if (aom_atomic_load_acquire(progress) >= target) return;
+    aom_cpu_relax();
+  }
+  pthread_mutex_lock(mutex);
+  while (aom_atomic_load_acquire(progress) < target) {
+    pthread_cond_wait(cond, mutex);
+  }
+  pthread_mutex_unlock(mutex);
+}
+#endif  // CONFIG_MULTITHREAD
+
 // Deallocate loopfilter synchronization related mutex and data.
 void av1_loop_filter_dealloc(AV1LfSync *lf_sync);
 
@@ -107,12 +158,12 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
                               int is_decoding,
 #endif
                               AVxWorker *workers, int num_workers,
-                              AV1LfSync *lf_sync);
-void av1_loop_restoration_filter_frame_mt(YV12_BUFFER_CONFIG *frame,
-                                          struct AV1Common *cm,
-                                          int optimized_lr, AVxWorker *workers,
-                                          int num_workers, AV1LrSync *lr_sync,
-                                          void *lr_ctxt);
+                              AV1LfSync *lf_sync, av1_rows_done_fn_t rows_done,
+                              void *rows_done_priv);
+void av1_loop_restoration_filter_frame_mt(
+    YV12_BUFFER_CONFIG *frame, struct AV1Common *cm, int optimized_lr,
+    AVxWorker *workers, int num_workers, AV1LrSync *lr_sync, void *lr_ctxt,
+    av1_rows_done_fn_t rows_done, void *rows_done_priv);
 void av1_loop_restoration_dealloc(AV1LrSync *lr_sync, int num_workers);
 
 #ifdef __cplusplus
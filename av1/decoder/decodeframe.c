@@ -18,6 +18,7 @@
 #include "config/av1_rtcd.h"
 
 #include "aom/aom_codec.h"
+#include "aom/aomdx.h"
 #include "aom_dsp/aom_dsp_common.h"
 #include "aom_dsp/binary_codes_reader.h"
 #include "aom_dsp/bitreader.h"
@@ -70,9 +71,6 @@
 
 // This is needed by ext_tile related unit tests.
 #define EXT_TILE_DEBUG 1
-#define MC_TEMP_BUF_PELS                       \
-  (((MAX_SB_SIZE)*2 + (AOM_INTERP_EXTEND)*2) * \
-   ((MAX_SB_SIZE)*2 + (AOM_INTERP_EXTEND)*2))
 
 // Checks that the remaining bits start with a 1 and ends with 0s.
 // It consumes an additional byte, if already byte aligned before the check.
@@ -166,6 +164,15 @@ static AOM_INLINE void inverse_transform_block(MACROBLOCKD *xd, int plane,
   memset(dqcoeff, 0, (scan_line + 1) * sizeof(dqcoeff[0]));
 }
 
+// Clears the dequantized coefficients of a transform block that is not
+// reconstructed, as inverse_transform_block() would have done.
+static AOM_INLINE void discard_transform_block(MACROBLOCKD *xd, int plane) {
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  tran_low_t *const dqcoeff = pd->dqcoeff_block + xd->cb_offset[plane];
+  const eob_info *eob_data = pd->eob_data + xd->txb_offset[plane];
+  memset(dqcoeff, 0, (eob_data->max_scan_line + 1) * sizeof(dqcoeff[0]));
+}
+
 static AOM_INLINE void read_coeffs_tx_intra_block(
     const AV1_COMMON *const cm, MACROBLOCKD *const xd, aom_reader *const r,
     const int plane, const int row, const int col, const TX_SIZE tx_size) {
@@ -223,6 +230,13 @@ static AOM_INLINE void predict_and_reconstruct_intra_block(
   MB_MODE_INFO *mbmi = xd->mi[0];
   PLANE_TYPE plane_type = get_plane_type(plane);
 
+  if (plane >= av1_num_recon_planes(cm)) {
+    struct macroblockd_plane *const pd = &xd->plane[plane];
+    if (!mbmi->skip && pd->eob_data[xd->txb_offset[plane]].eob)
+      discard_transform_block(xd, plane);
+    return;
+  }
+
   av1_predict_intra_block_facade(cm, xd, plane, col, row, tx_size);
 
   if (!mbmi->skip) {
@@ -238,7 +252,7 @@ static AOM_INLINE void predict_and_reconstruct_intra_block(
                               cm->reduced_tx_set_used);
     }
   }
-  if (plane == AOM_PLANE_Y && store_cfl_required(cm, xd)) {
+  if (plane == AOM_PLANE_Y && !cm->luma_only && store_cfl_required(cm, xd)) {
     cfl_store_tx(xd, row, col, tx_size, mbmi->sb_type);
   }
 }
@@ -248,6 +262,10 @@ static AOM_INLINE void inverse_transform_inter_block(
     const int plane, const int blk_row, const int blk_col,
     const TX_SIZE tx_size) {
   (void)r;
+  if (plane >= av1_num_recon_planes(cm)) {
+    discard_transform_block(xd, plane);
+    return;
+  }
   PLANE_TYPE plane_type = get_plane_type(plane);
   const struct macroblockd_plane *const pd = &xd->plane[plane];
 
@@ -369,8 +387,9 @@ static AOM_INLINE void set_offsets(AV1_COMMON *const cm, MACROBLOCKD *const xd,
   // as they are always compared to values that are in 1/8th pel units
   set_mi_row_col(xd, tile, mi_row, bh, mi_col, bw, cm->mi_rows, cm->mi_cols);
 
-  av1_setup_dst_planes(xd->plane, bsize, &cm->cur_frame->buf, mi_row, mi_col, 0,
-                       num_planes);
+  av1_setup_dst_planes(xd->plane, bsize, xd->cur_buf,
+                       mi_row - xd->cur_buf_mi_row, mi_col - xd->cur_buf_mi_col,
+                       0, num_planes);
 }
 
 static AOM_INLINE void decode_mbmi_block(AV1Decoder *const pbi,
@@ -913,7 +932,7 @@ static AOM_INLINE void dec_build_inter_predictors_sb(const AV1_COMMON *cm,
                                                      int mi_row, int mi_col,
                                                      BUFFER_SET *ctx,
                                                      BLOCK_SIZE bsize) {
-  const int num_planes = av1_num_planes(cm);
+  const int num_planes = av1_num_recon_planes(cm);
   dec_build_inter_predictors_sby(cm, xd, mi_row, mi_col, ctx, bsize);
   if (num_planes > 1)
     dec_build_inter_predictors_sbuv(cm, xd, mi_row, mi_col, ctx, bsize);
@@ -1078,8 +1097,9 @@ static AOM_INLINE void dec_build_obmc_inter_predictors_sb(const AV1_COMMON *cm,
                                       dst_width1, dst_height1, dst_stride1);
   dec_build_prediction_by_left_preds(cm, xd, mi_row, mi_col, dst_buf2,
                                      dst_width2, dst_height2, dst_stride2);
-  av1_setup_dst_planes(xd->plane, xd->mi[0]->sb_type, &cm->cur_frame->buf,
-                       mi_row, mi_col, 0, num_planes);
+  av1_setup_dst_planes(xd->plane, xd->mi[0]->sb_type, xd->cur_buf,
+                       mi_row - xd->cur_buf_mi_row, mi_col - xd->cur_buf_mi_col,
+                       0, num_planes);
   av1_build_obmc_inter_prediction(cm, xd, mi_row, mi_col, dst_buf1, dst_stride1,
                                   dst_buf2, dst_stride2);
 }
@@ -1087,7 +1107,7 @@ static AOM_INLINE void dec_build_obmc_inter_predictors_sb(const AV1_COMMON *cm,
 static AOM_INLINE void cfl_store_inter_block(AV1_COMMON *const cm,
                                              MACROBLOCKD *const xd) {
   MB_MODE_INFO *mbmi = xd->mi[0];
-  if (store_cfl_required(cm, xd)) {
+  if (!cm->luma_only && store_cfl_required(cm, xd)) {
     cfl_store_block(xd, mbmi->sb_type, mbmi->tx_size);
   }
 }
@@ -1527,8 +1547,9 @@ static AOM_INLINE void set_offsets_for_pred_and_recon(AV1Decoder *const pbi,
   // as they are always compared to values that are in 1/8th pel units
   set_mi_row_col(xd, tile, mi_row, bh, mi_col, bw, cm->mi_rows, cm->mi_cols);
 
-  av1_setup_dst_planes(xd->plane, bsize, &cm->cur_frame->buf, mi_row, mi_col, 0,
-                       num_planes);
+  av1_setup_dst_planes(xd->plane, bsize, xd->cur_buf,
+                       mi_row - xd->cur_buf_mi_row, mi_col - xd->cur_buf_mi_col,
+                       0, num_planes);
 }
 
 static AOM_INLINE void decode_block(AV1Decoder *const pbi, ThreadData *const td,
@@ -2725,6 +2746,47 @@ static AOM_INLINE void set_cb_buffer(AV1Decoder *pbi, MACROBLOCKD *const xd,
   xd->color_index_map_offset[1] = 0;
 }
 
+// Points the arrays of 'cb_buffer' into 'data' unless 'cb_buffer' is NULL, and
+// returns the number of bytes they take for the superblock size and chroma
+// subsampling of the sequence.
+static size_t setup_cb_buffer(const SequenceHeader *seq_params,
+                              CB_BUFFER *cb_buffer, uint8_t *data) {
+  const BLOCK_SIZE sb_size = seq_params->sb_size;
+  const int luma_pels = block_size_wide[sb_size] * block_size_high[sb_size];
+  const int chroma_pels =
+      luma_pels >> (seq_params->subsampling_x + seq_params->subsampling_y);
+  const int num_planes = seq_params->monochrome ? 1 : MAX_MB_PLANE;
+  size_t offset = 0;
+
+  if (cb_buffer != NULL) av1_zero(*cb_buffer);
+  for (int plane = 0; plane < num_planes; ++plane) {
+    const int pels = plane ? chroma_pels : luma_pels;
+    if (cb_buffer != NULL)
+      cb_buffer->dqcoeff[plane] = (tran_low_t *)(data + offset);
+    offset += ALIGN_POWER_OF_TWO(pels * sizeof(tran_low_t), 5);
+    if (cb_buffer != NULL)
+      cb_buffer->eob_data[plane] = (eob_info *)(data + offset);
+    offset += ALIGN_POWER_OF_TWO(
+        pels / (TX_SIZE_W_MIN * TX_SIZE_H_MIN) * sizeof(eob_info), 5);
+    if (plane < 2) {
+      if (cb_buffer != NULL) cb_buffer->color_index_map[plane] = data + offset;
+      offset += ALIGN_POWER_OF_TWO(pels, 5);
+    }
+  }
+  return offset;
+}
+
+static AOM_INLINE void alloc_td_cb_buf(AV1_COMMON *const cm, ThreadData *td) {
+  const size_t size = setup_cb_buffer(&cm->seq_params, NULL, NULL);
+  if (td->cb_buffer_data_size != size) {
+    av1_dec_free_td_cb_buf(td);
+    CHECK_MEM_ERROR(cm, td->cb_buffer_data, aom_memalign(32, size));
+    memset(td->cb_buffer_data, 0, size);
+    td->cb_buffer_data_size = size;
+  }
+  setup_cb_buffer(&cm->seq_params, &td->cb_buffer_base, td->cb_buffer_data);
+}
+
 static AOM_INLINE void decoder_alloc_tile_data(AV1Decoder *pbi,
                                                const int n_tiles) {
   AV1_COMMON *const cm = &pbi->common;
@@ -2822,13 +2884,9 @@ static INLINE void sync_read(AV1DecRowMTSync *const dec_row_mt_sync, int r,
   const int nsync = dec_row_mt_sync->sync_range;
 
   if (r && !(c & (nsync - 1))) {
-    pthread_mutex_t *const mutex = &dec_row_mt_sync->mutex_[r - 1];
-    pthread_mutex_lock(mutex);
-
-    while (c > dec_row_mt_sync->cur_sb_col[r - 1] - nsync) {
-      pthread_cond_wait(&dec_row_mt_sync->cond_[r - 1], mutex);
-    }
-    pthread_mutex_unlock(mutex);
+    av1_sync_wait(&dec_row_mt_sync->cur_sb_col[r - 1], c + nsync,
+                  &dec_row_mt_sync->mutex_[r - 1],
+                  &dec_row_mt_sync->cond_[r - 1]);
   }
 #else
   (void)dec_row_mt_sync;
@@ -2852,10 +2910,9 @@ static INLINE void sync_write(AV1DecRowMTSync *const dec_row_mt_sync, int r,
   }
 
   if (sig) {
-    pthread_mutex_lock(&dec_row_mt_sync->mutex_[r]);
-
-    dec_row_mt_sync->cur_sb_col[r] = cur;
+    aom_atomic_store_release(&dec_row_mt_sync->cur_sb_col[r], cur);
 
+    pthread_mutex_lock(&dec_row_mt_sync->mutex_[r]);
     pthread_cond_signal(&dec_row_mt_sync->cond_[r]);
     pthread_mutex_unlock(&dec_row_mt_sync->mutex_[r]);
   }
@@ -2867,6 +2924,42 @@ static INLINE void sync_write(AV1DecRowMTSync *const dec_row_mt_sync, int r,
 #endif  // CONFIG_MULTITHREAD
 }
 
+// Reports the luma rows of cur_frame from the last reported row up to, but not
+// including, end_row as final.
+static AOM_INLINE void report_row_progress(AV1Decoder *pbi, int end_row) {
+  end_row = AOMMIN(end_row, pbi->common.height);
+  if (end_row <= pbi->row_progress_rows_done) return;
+  pbi->row_progress_cb(pbi->row_progress_priv, pbi->row_progress_rows_done,
+                       end_row);
+  pbi->row_progress_rows_done = end_row;
+}
+
+// av1_rows_done_fn_t of the last post-filter pass of a frame.
+static void report_filtered_rows(void *priv, int rows) {
+  report_row_progress((AV1Decoder *)priv, rows);
+}
+
+// Records that the superblock row starting at mi_row has been reconstructed in
+// one more tile column, and reports the rows above the first superblock row
+// that is still incomplete. In row-mt decoding, the caller must hold
+// pbi->row_mt_mutex_.
+static AOM_INLINE void row_progress_sb_row_done(AV1Decoder *pbi, int mi_row) {
+  AV1_COMMON *const cm = &pbi->common;
+  const int mib_size_log2 = cm->seq_params.mib_size_log2;
+  const int sb_size_log2 = mib_size_log2 + MI_SIZE_LOG2;
+  const int sb_rows =
+      (cm->mi_rows + cm->seq_params.mib_size - 1) >> mib_size_log2;
+
+  ++pbi->row_progress_tile_cols_done[mi_row >> mib_size_log2];
+  if (pbi->row_progress_rows_done >= cm->height) return;
+
+  int sb_row = pbi->row_progress_rows_done >> sb_size_log2;
+  while (sb_row < sb_rows &&
+         pbi->row_progress_tile_cols_done[sb_row] == cm->tile_cols)
+    ++sb_row;
+  report_row_progress(pbi, sb_row << sb_size_log2);
+}
+
 static AOM_INLINE void decode_tile_sb_row(AV1Decoder *pbi, ThreadData *const td,
                                           TileInfo tile_info,
                                           const int mi_row) {
@@ -2940,8 +3033,37 @@ static AOM_INLINE void set_decode_func_pointers(ThreadData *td,
   }
 }
 
+// Returns how the tile is processed when only the tiles selected with
+// AV1D_SET_TILE_MASK are decoded: 0x3 to parse and reconstruct it, 0x1 to only
+// parse it for the frame context it provides, or 0 to skip it.
+static AOM_INLINE int get_tile_decode_flag(const AV1Decoder *pbi,
+                                           int tile_idx) {
+  const AV1_COMMON *const cm = &pbi->common;
+  if (!cm->partial_tile_decode ||
+      ((pbi->tile_mask[tile_idx >> 5] >> (tile_idx & 31)) & 1))
+    return 0x3;
+  if (cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD &&
+      tile_idx == cm->context_update_tile_id)
+    return 0x1;
+  return 0;
+}
+
+// Clears the mode info of a tile that was parsed but not reconstructed, so
+// that the post filters treat it as not coded.
+static AOM_INLINE void clear_tile_mode_info(AV1_COMMON *cm,
+                                            const TileInfo *tile_info) {
+  for (int mi_row = tile_info->mi_row_start; mi_row < tile_info->mi_row_end;
+       ++mi_row) {
+    memset(cm->mi_grid_base + mi_row * cm->mi_stride + tile_info->mi_col_start,
+           0,
+           (tile_info->mi_col_end - tile_info->mi_col_start) *
+               sizeof(*cm->mi_grid_base));
+  }
+}
+
 static AOM_INLINE void decode_tile(AV1Decoder *pbi, ThreadData *const td,
-                                   int tile_row, int tile_col) {
+                                   int tile_row, int tile_col,
+                                   int parse_decode_flag) {
   TileInfo tile_info;
 
   AV1_COMMON *const cm = &pbi->common;
@@ -2964,20 +3086,33 @@ static AOM_INLINE void decode_tile(AV1Decoder *pbi, ThreadData *const td,
 
       // Bit-stream parsing and decoding of the superblock
       decode_partition(pbi, td, mi_row, mi_col, td->bit_reader,
-                       cm->seq_params.sb_size, 0x3);
+                       cm->seq_params.sb_size, parse_decode_flag);
 
       if (aom_reader_has_overflowed(td->bit_reader)) {
         aom_merge_corrupted_flag(&td->xd.corrupted, 1);
         return;
       }
     }
+    if (pbi->row_progress_early) row_progress_sb_row_done(pbi, mi_row);
   }
+  if (!(parse_decode_flag & 0x2)) clear_tile_mode_info(cm, &tile_info);
 
   int corrupted =
       (check_trailing_bits_after_symbol_coder(td->bit_reader)) ? 1 : 0;
   aom_merge_corrupted_flag(&td->xd.corrupted, corrupted);
 }
 
+// Returns the end of the data of the last tile of a tile group.
+static const uint8_t *get_tile_group_end(AV1Decoder *pbi, int end_tile) {
+  const AV1_COMMON *const cm = &pbi->common;
+  if (get_tile_decode_flag(pbi, end_tile))
+    return aom_reader_find_end(&pbi->tile_data[end_tile].bit_reader);
+  // The tile was skipped. Its data runs to the end of the tile group.
+  const TileBufferDec *const tile_buffer =
+      &pbi->tile_buffers[end_tile / cm->tile_cols][end_tile % cm->tile_cols];
+  return tile_buffer->data + tile_buffer->size;
+}
+
 static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
                                    const uint8_t *data_end, int start_tile,
                                    int end_tile) {
@@ -3065,8 +3200,6 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
   }
 #endif
 
-  set_decode_func_pointers(&pbi->td, 0x3);
-
   // Load all tile information into thread_data.
   td->xd = pbi->mb;
   td->xd.corrupted = 0;
@@ -3094,9 +3227,12 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
       if (row * cm->tile_cols + col < start_tile ||
           row * cm->tile_cols + col > end_tile)
         continue;
+      const int parse_decode_flag =
+          get_tile_decode_flag(pbi, row * cm->tile_cols + col);
+      if (!parse_decode_flag) continue;
 
       td->bit_reader = &tile_data->bit_reader;
-      av1_zero(td->cb_buffer_base.dqcoeff);
+      memset(td->cb_buffer_data, 0, td->cb_buffer_data_size);
       av1_tile_init(&td->xd.tile, cm, row, col);
       td->xd.current_qindex = cm->base_qindex;
       setup_bool_decoder(tile_bs_buf->data, data_end, tile_bs_buf->size,
@@ -3118,7 +3254,8 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
       td->xd.tile_ctx = &tile_data->tctx;
 
       // decode tile
-      decode_tile(pbi, td, row, col);
+      set_decode_func_pointers(td, parse_decode_flag);
+      decode_tile(pbi, td, row, col, parse_decode_flag);
       aom_merge_corrupted_flag(&pbi->mb.corrupted, td->xd.corrupted);
       if (pbi->mb.corrupted)
         aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
@@ -3134,8 +3271,6 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
     // Return the end of the last tile buffer
     return raw_data_end;
   }
-  TileDataDec *const tile_data = pbi->tile_data + end_tile;
-
   if (gPacketizerMode == PACKETIZER_MODE_WRITE_PACKETS)
     // Skip to the end of the tile group.
     return data_end;
@@ -3144,20 +3279,15 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
     // Ignore it and don't advance the data pointer.
     return data;
 
-  return aom_reader_find_end(&tile_data->bit_reader);
+  return get_tile_group_end(pbi, end_tile);
 }
 
 static TileJobsDec *get_dec_job_info(AV1DecTileMT *tile_mt_info) {
   TileJobsDec *cur_job_info = NULL;
 #if CONFIG_MULTITHREAD
-  pthread_mutex_lock(tile_mt_info->job_mutex);
-
-  if (tile_mt_info->jobs_dequeued < tile_mt_info->jobs_enqueued) {
-    cur_job_info = tile_mt_info->job_queue + tile_mt_info->jobs_dequeued;
-    tile_mt_info->jobs_dequeued++;
-  }
-
-  pthread_mutex_unlock(tile_mt_info->job_mutex);
+  const int job = aom_atomic_fetch_add(&tile_mt_info->jobs_dequeued, 1);
+  if (job < tile_mt_info->jobs_enqueued)
+    cur_job_info = tile_mt_info->job_queue + job;
 #else
   (void)tile_mt_info;
 #endif
@@ -3174,7 +3304,7 @@ static AOM_INLINE void tile_worker_hook_init(
   int tile_col = tile_data->tile_info.tile_col;
 
   td->bit_reader = &tile_data->bit_reader;
-  av1_zero(td->cb_buffer_base.dqcoeff);
+  memset(td->cb_buffer_data, 0, td->cb_buffer_data_size);
   av1_tile_init(&td->xd.tile, cm, tile_row, tile_col);
   td->xd.current_qindex = cm->base_qindex;
   setup_bool_decoder(tile_buffer->data, thread_data->data_end,
@@ -3224,8 +3354,6 @@ static int tile_worker_hook(void *arg1, void *arg2) {
   allow_update_cdf = cm->large_scale_tile ? 0 : 1;
   allow_update_cdf = allow_update_cdf && !cm->disable_cdf_update;
 
-  set_decode_func_pointers(td, 0x3);
-
   assert(cm->tile_cols > 0);
   while (!td->xd.corrupted) {
     TileJobsDec *cur_job_info = get_dec_job_info(&pbi->tile_mt_info);
@@ -3238,7 +3366,10 @@ static int tile_worker_hook(void *arg1, void *arg2) {
       // decode tile
       int tile_row = tile_data->tile_info.tile_row;
       int tile_col = tile_data->tile_info.tile_col;
-      decode_tile(pbi, td, tile_row, tile_col);
+      const int parse_decode_flag =
+          get_tile_decode_flag(pbi, tile_row * cm->tile_cols + tile_col);
+      set_decode_func_pointers(td, parse_decode_flag);
+      decode_tile(pbi, td, tile_row, tile_col, parse_decode_flag);
     } else {
       break;
     }
@@ -3525,7 +3656,13 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
 #endif
     while (!get_next_job_info(pbi, &next_job_info, &end_of_frame)) {
 #if CONFIG_MULTITHREAD
+      struct aom_usec_timer timer;
+      if (pbi->timing_enabled) aom_usec_timer_start(&timer);
       pthread_cond_wait(pbi->row_mt_cond_, pbi->row_mt_mutex_);
+      if (pbi->timing_enabled) {
+        aom_usec_timer_mark(&timer);
+        thread_data->wait_us += aom_usec_timer_elapsed(&timer);
+      }
 #endif
     }
 #if CONFIG_MULTITHREAD
@@ -3553,6 +3690,7 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
     pthread_mutex_lock(pbi->row_mt_mutex_);
 #endif
     dec_row_mt_sync->num_threads_working--;
+    if (pbi->row_progress_early) row_progress_sb_row_done(pbi, mi_row);
 #if CONFIG_MULTITHREAD
     pthread_mutex_unlock(pbi->row_mt_mutex_);
 #endif
@@ -3575,12 +3713,13 @@ static AOM_INLINE void enqueue_tile_jobs(AV1Decoder *pbi, AV1_COMMON *cm,
   AV1DecTileMT *tile_mt_info = &pbi->tile_mt_info;
   TileJobsDec *tile_job_queue = tile_mt_info->job_queue;
   tile_mt_info->jobs_enqueued = 0;
-  tile_mt_info->jobs_dequeued = 0;
+  aom_atomic_init(&tile_mt_info->jobs_dequeued, 0);
 
   for (int row = tile_rows_start; row < tile_rows_end; row++) {
     for (int col = tile_cols_start; col < tile_cols_end; col++) {
       if (row * cm->tile_cols + col < start_tile ||
-          row * cm->tile_cols + col > end_tile)
+          row * cm->tile_cols + col > end_tile ||
+          !get_tile_decode_flag(pbi, row * cm->tile_cols + col))
         continue;
       tile_job_queue->tile_buffer = &pbi->tile_buffers[row][col];
       tile_job_queue->tile_data = pbi->tile_data + row * cm->tile_cols + col;
@@ -3596,16 +3735,6 @@ static AOM_INLINE void alloc_dec_jobs(AV1DecTileMT *tile_mt_info,
   tile_mt_info->alloc_tile_rows = tile_rows;
   tile_mt_info->alloc_tile_cols = tile_cols;
   int num_tiles = tile_rows * tile_cols;
-#if CONFIG_MULTITHREAD
-  {
-    CHECK_MEM_ERROR(cm, tile_mt_info->job_mutex,
-                    aom_malloc(sizeof(*tile_mt_info->job_mutex) * num_tiles));
-
-    for (int i = 0; i < num_tiles; i++) {
-      pthread_mutex_init(&tile_mt_info->job_mutex[i], NULL);
-    }
-  }
-#endif
   CHECK_MEM_ERROR(cm, tile_mt_info->job_queue,
                   aom_malloc(sizeof(*tile_mt_info->job_queue) * num_tiles));
 }
@@ -3630,6 +3759,15 @@ void av1_free_mc_tmp_buf(ThreadData *thread_data) {
   }
 }
 
+// Returns the number of pixels of the buffers used to extend the borders of
+// reference blocks, which may be twice as large as a superblock when the
+// reference frame is scaled.
+static INLINE int get_mc_buf_pels(const SequenceHeader *seq_params) {
+  const int sb_size = block_size_wide[seq_params->sb_size];
+  return (sb_size * 2 + AOM_INTERP_EXTEND * 2) *
+         (sb_size * 2 + AOM_INTERP_EXTEND * 2);
+}
+
 static AOM_INLINE void allocate_mc_tmp_buf(AV1_COMMON *const cm,
                                            ThreadData *thread_data,
                                            int buf_size, int use_highbd) {
@@ -3646,26 +3784,62 @@ static AOM_INLINE void allocate_mc_tmp_buf(AV1_COMMON *const cm,
   thread_data->mc_buf_size = buf_size;
   thread_data->mc_buf_use_highbd = use_highbd;
 
+  // tmp_conv_dst has a stride of MAX_SB_SIZE but no more rows than a
+  // superblock.
+  const int sb_rows = block_size_high[cm->seq_params.sb_size];
   CHECK_MEM_ERROR(cm, thread_data->tmp_conv_dst,
-                  aom_memalign(32, MAX_SB_SIZE * MAX_SB_SIZE *
+                  aom_memalign(32, sb_rows * MAX_SB_SIZE *
                                        sizeof(*thread_data->tmp_conv_dst)));
   for (int i = 0; i < 2; ++i) {
     CHECK_MEM_ERROR(
         cm, thread_data->tmp_obmc_bufs[i],
-        aom_memalign(16, 2 * MAX_MB_PLANE * MAX_SB_SQUARE *
+        aom_memalign(16, (1 + use_highbd) * MAX_MB_PLANE * MAX_SB_SQUARE *
                              sizeof(*thread_data->tmp_obmc_bufs[i])));
   }
 }
 
+// Allocates the buffers of 'td' for the superblock size, chroma subsampling
+// and bit depth of the sequence, unless they were allocated for them already.
+static AOM_INLINE void alloc_td_bufs(AV1_COMMON *const cm, ThreadData *td) {
+  const int use_highbd = cm->seq_params.use_highbitdepth;
+  const int buf_size = get_mc_buf_pels(&cm->seq_params) << use_highbd;
+  if (td->mc_buf_size != buf_size) {
+    av1_free_mc_tmp_buf(td);
+    allocate_mc_tmp_buf(cm, td, buf_size, use_highbd);
+  }
+  alloc_td_cb_buf(cm, td);
+}
+
+// Runs the hook of a tile worker and measures the time it takes.
+static int timed_dec_worker_hook(void *arg1, void *arg2) {
+  DecWorkerData *const thread_data = (DecWorkerData *)arg1;
+  struct aom_usec_timer timer;
+  aom_usec_timer_start(&timer);
+  const int64_t cpu_start = aom_thread_cpu_usec();
+  const int ret = thread_data->timed_hook(arg1, arg2);
+  aom_usec_timer_mark(&timer);
+  thread_data->busy_us = aom_usec_timer_elapsed(&timer);
+  thread_data->busy_cpu_us = aom_thread_cpu_usec() - cpu_start;
+  return ret;
+}
+
 static AOM_INLINE void reset_dec_workers(AV1Decoder *pbi,
                                          AVxWorkerHook worker_hook,
                                          int num_workers) {
+  AV1_COMMON *const cm = &pbi->common;
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
 
   // Reset tile decoding hook
   for (int worker_idx = 0; worker_idx < num_workers; ++worker_idx) {
     AVxWorker *const worker = &pbi->tile_workers[worker_idx];
     DecWorkerData *const thread_data = pbi->thread_data + worker_idx;
+    // The thread data of a worker is allocated the first time it is used.
+    if (thread_data->td == NULL) {
+      CHECK_MEM_ERROR(cm, thread_data->td,
+                      aom_memalign(32, sizeof(*thread_data->td)));
+      av1_zero(*thread_data->td);
+    }
+    alloc_td_bufs(cm, thread_data->td);
     thread_data->td->xd = pbi->mb;
     thread_data->td->xd.corrupted = 0;
     thread_data->td->xd.mc_buf[0] = thread_data->td->mc_buf[0];
@@ -3676,7 +3850,15 @@ static AOM_INLINE void reset_dec_workers(AV1Decoder *pbi,
     }
     winterface->sync(worker);
 
-    worker->hook = worker_hook;
+    if (pbi->timing_enabled) {
+      worker->hook = timed_dec_worker_hook;
+      thread_data->timed_hook = worker_hook;
+      thread_data->busy_us = 0;
+      thread_data->busy_cpu_us = 0;
+      thread_data->wait_us = 0;
+    } else {
+      worker->hook = worker_hook;
+    }
     worker->data1 = thread_data;
     worker->data2 = pbi;
   }
@@ -3692,6 +3874,7 @@ static AOM_INLINE void launch_dec_workers(AV1Decoder *pbi,
                                           int num_workers) {
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
 
+  if (pbi->timing_enabled) aom_usec_timer_start(&pbi->tile_workers_timer);
   for (int worker_idx = 0; worker_idx < num_workers; ++worker_idx) {
     AVxWorker *const worker = &pbi->tile_workers[worker_idx];
     DecWorkerData *const thread_data = (DecWorkerData *)worker->data1;
@@ -3717,6 +3900,20 @@ static AOM_INLINE void sync_dec_workers(AV1Decoder *pbi, int num_workers) {
   }
 
   pbi->mb.corrupted = corrupted;
+
+  if (pbi->timing_enabled) {
+    aom_usec_timer_mark(&pbi->tile_workers_timer);
+    const int64_t elapsed = aom_usec_timer_elapsed(&pbi->tile_workers_timer);
+    for (int worker_idx = 0; worker_idx < num_workers; ++worker_idx) {
+      const DecWorkerData *const thread_data = pbi->thread_data + worker_idx;
+      pbi->timing.worker_idle_us +=
+          AOMMAX(elapsed - thread_data->busy_us, 0) + thread_data->wait_us;
+      // The last worker runs on the calling thread, whose CPU time is already
+      // counted by the stage.
+      if (worker_idx < num_workers - 1)
+        pbi->timing.cpu_us[AOM_DECODE_STAGE_TILES] += thread_data->busy_cpu_us;
+    }
+  }
 }
 
 static AOM_INLINE void decode_mt_init(AV1Decoder *pbi) {
@@ -3739,16 +3936,15 @@ static AOM_INLINE void decode_mt_init(AV1Decoder *pbi) {
 
       winterface->init(worker);
       worker->thread_name = "aom tile worker";
+      worker->pool = pbi->thread_pool;
       if (worker_idx < num_threads - 1 && !winterface->reset(worker)) {
         aom_internal_error(&cm->error, AOM_CODEC_ERROR,
                            "Tile decoder thread creation failed");
       }
 
       if (worker_idx < num_threads - 1) {
-        // Allocate thread data.
-        CHECK_MEM_ERROR(cm, thread_data->td,
-                        aom_memalign(32, sizeof(*thread_data->td)));
-        av1_zero(*thread_data->td);
+        // The thread data is allocated by reset_dec_workers().
+        thread_data->td = NULL;
       } else {
         // Main thread acts as a worker and uses the thread data in pbi
         thread_data->td = &pbi->td;
@@ -3757,15 +3953,6 @@ static AOM_INLINE void decode_mt_init(AV1Decoder *pbi) {
       thread_data->error_info.setjmp = 0;
     }
   }
-  const int use_highbd = cm->seq_params.use_highbitdepth;
-  const int buf_size = MC_TEMP_BUF_PELS << use_highbd;
-  for (worker_idx = 0; worker_idx < pbi->max_threads - 1; ++worker_idx) {
-    DecWorkerData *const thread_data = pbi->thread_data + worker_idx;
-    if (thread_data->td->mc_buf_size != buf_size) {
-      av1_free_mc_tmp_buf(thread_data->td);
-      allocate_mc_tmp_buf(cm, thread_data->td, buf_size, use_highbd);
-    }
-  }
 }
 
 static AOM_INLINE void tile_mt_queue(AV1Decoder *pbi, int tile_cols,
@@ -3875,9 +4062,150 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
     // Return the end of the last tile buffer
     return raw_data_end;
   }
-  TileDataDec *const tile_data = pbi->tile_data + end_tile;
 
-  return aom_reader_find_end(&tile_data->bit_reader);
+  return get_tile_group_end(pbi, end_tile);
+}
+
+// Points the reconstruction of the tile referred to by 'entry' at its slot in
+// pbi->tile_list_outbuf, so that the tile is decoded in place.
+static AOM_INLINE void setup_tile_list_dst_buf(AV1Decoder *pbi,
+                                               const TileListEntryDec *entry,
+                                               MACROBLOCKD *xd) {
+  AV1_COMMON *const cm = &pbi->common;
+  const int out_width_in_tiles = pbi->output_frame_width_in_tiles_minus_1 + 1;
+  const int tr = entry->output_idx / out_width_in_tiles;
+  const int tc = entry->output_idx % out_width_in_tiles;
+  int tile_width, tile_height;
+  av1_get_uniform_tile_size(cm, &tile_width, &tile_height);
+
+  // The blocks of the tile are located relative to the top-left corner of the
+  // output frame, so that they land in the slot (tr, tc).
+  xd->cur_buf = &pbi->tile_list_outbuf;
+  xd->cur_buf_mi_row = (entry->tile_row - tr) * tile_height;
+  xd->cur_buf_mi_col = (entry->tile_col - tc) * tile_width;
+}
+
+static int tile_list_worker_hook(void *arg1, void *arg2) {
+  DecWorkerData *const thread_data = (DecWorkerData *)arg1;
+  AV1Decoder *const pbi = (AV1Decoder *)arg2;
+  ThreadData *const td = thread_data->td;
+
+  // The jmp_buf is valid only for the duration of the function that calls
+  // setjmp(). Therefore, this function must reset the 'setjmp' field to 0
+  // before it returns.
+  if (setjmp(thread_data->error_info.jmp)) {
+    thread_data->error_info.setjmp = 0;
+    thread_data->td->xd.corrupted = 1;
+    return 0;
+  }
+  thread_data->error_info.setjmp = 1;
+
+  set_decode_func_pointers(td, 0x3);
+
+  while (!td->xd.corrupted) {
+    TileJobsDec *cur_job_info = get_dec_job_info(&pbi->tile_mt_info);
+    if (cur_job_info == NULL) break;
+
+    TileDataDec *const tile_data = cur_job_info->tile_data;
+    for (int i = 0; i < cur_job_info->num_tile_list_entries; ++i) {
+      const TileListEntryDec *const entry = &cur_job_info->tile_list_entries[i];
+      setup_tile_list_dst_buf(pbi, entry, &td->xd);
+      // Tile lists are only used with large_scale_tile, which never updates
+      // the CDFs.
+      tile_worker_hook_init(pbi, thread_data, &entry->tile_buffer, tile_data,
+                            0);
+      decode_tile(pbi, td, entry->tile_row, entry->tile_col, 0x3);
+      if (td->xd.corrupted) break;
+    }
+  }
+  thread_data->error_info.setjmp = 0;
+  return !td->xd.corrupted;
+}
+
+static int compare_tile_list_entries(const void *a, const void *b) {
+  const TileListEntryDec *const e1 = (const TileListEntryDec *)a;
+  const TileListEntryDec *const e2 = (const TileListEntryDec *)b;
+  if (e1->anchor_frame_idx != e2->anchor_frame_idx)
+    return e1->anchor_frame_idx - e2->anchor_frame_idx;
+  if (e1->tile_row != e2->tile_row) return e1->tile_row - e2->tile_row;
+  if (e1->tile_col != e2->tile_col) return e1->tile_col - e2->tile_col;
+  return e1->output_idx - e2->output_idx;
+}
+
+void av1_decode_tile_list_mt(AV1Decoder *pbi, const uint8_t *data_end) {
+  AV1_COMMON *const cm = &pbi->common;
+  AV1DecTileMT *const tile_mt_info = &pbi->tile_mt_info;
+  TileListEntryDec *const entries = pbi->tile_list_entries;
+  const int num_entries = pbi->tile_count_minus_1 + 1;
+  const int tile_cols = cm->tile_cols;
+  const int tile_rows = cm->tile_rows;
+  const int n_tiles = tile_cols * tile_rows;
+
+  assert(cm->large_scale_tile);
+  decode_mt_init(pbi);
+
+  if (pbi->tile_data == NULL || n_tiles != pbi->allocated_tiles) {
+    decoder_alloc_tile_data(pbi, n_tiles);
+  }
+  for (int row = 0; row < tile_rows; row++) {
+    for (int col = 0; col < tile_cols; col++) {
+      TileDataDec *tile_data = pbi->tile_data + row * tile_cols + col;
+      av1_tile_init(&tile_data->tile_info, cm, row, col);
+    }
+  }
+  if (tile_mt_info->alloc_tile_cols != tile_cols ||
+      tile_mt_info->alloc_tile_rows != tile_rows) {
+    av1_dealloc_dec_jobs(tile_mt_info);
+    alloc_dec_jobs(tile_mt_info, cm, tile_rows, tile_cols);
+  }
+
+  // The anchor frame is set through the reference buffer shared by all
+  // workers, so the entries are decoded in one pass per anchor frame. Within
+  // a pass, entries that refer to the same tile share its mode info and
+  // contexts in cm, and are decoded one after the other by a single job.
+  qsort(entries, num_entries, sizeof(*entries), compare_tile_list_entries);
+
+  int start = 0;
+  while (start < num_entries) {
+    const int anchor_frame_idx = entries[start].anchor_frame_idx;
+    int end = start;
+
+    tile_mt_info->jobs_enqueued = 0;
+    aom_atomic_init(&tile_mt_info->jobs_dequeued, 0);
+    while (end < num_entries &&
+           entries[end].anchor_frame_idx == anchor_frame_idx) {
+      const int tile_row = entries[end].tile_row;
+      const int tile_col = entries[end].tile_col;
+      TileJobsDec *const job =
+          &tile_mt_info->job_queue[tile_mt_info->jobs_enqueued++];
+      job->tile_buffer = NULL;
+      job->tile_data = pbi->tile_data + tile_row * tile_cols + tile_col;
+      job->tile_list_entries = &entries[end];
+      job->num_tile_list_entries = 0;
+      do {
+        ++job->num_tile_list_entries;
+        ++end;
+      } while (end < num_entries &&
+               entries[end].anchor_frame_idx == anchor_frame_idx &&
+               entries[end].tile_row == tile_row &&
+               entries[end].tile_col == tile_col);
+    }
+    assert(tile_mt_info->jobs_enqueued <= n_tiles);
+
+    av1_set_reference_dec(cm, cm->remapped_ref_idx[0], 1,
+                          &pbi->ext_refs.refs[anchor_frame_idx]);
+
+    const int num_workers =
+        AOMMIN(pbi->max_threads, tile_mt_info->jobs_enqueued);
+    reset_dec_workers(pbi, tile_list_worker_hook, num_workers);
+    launch_dec_workers(pbi, data_end, num_workers);
+    sync_dec_workers(pbi, num_workers);
+
+    if (pbi->mb.corrupted)
+      aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
+                         "Failed to decode tile data");
+    start = end;
+  }
 }
 
 static AOM_INLINE void dec_alloc_cb_buf(AV1Decoder *pbi) {
@@ -3885,12 +4213,22 @@ static AOM_INLINE void dec_alloc_cb_buf(AV1Decoder *pbi) {
   int size = ((cm->mi_rows >> cm->seq_params.mib_size_log2) + 1) *
              ((cm->mi_cols >> cm->seq_params.mib_size_log2) + 1);
 
-  if (pbi->cb_buffer_alloc_size < size) {
+  const size_t data_size = setup_cb_buffer(&cm->seq_params, NULL, NULL);
+
+  if (pbi->cb_buffer_alloc_size < size ||
+      pbi->cb_buffer_data_size != data_size) {
     av1_dec_free_cb_buf(pbi);
     CHECK_MEM_ERROR(cm, pbi->cb_buffer_base,
-                    aom_memalign(32, sizeof(*pbi->cb_buffer_base) * size));
-    memset(pbi->cb_buffer_base, 0, sizeof(*pbi->cb_buffer_base) * size);
+                    aom_malloc(sizeof(*pbi->cb_buffer_base) * size));
+    CHECK_MEM_ERROR(cm, pbi->cb_buffer_data,
+                    aom_memalign(32, data_size * size));
+    memset(pbi->cb_buffer_data, 0, data_size * size);
     pbi->cb_buffer_alloc_size = size;
+    pbi->cb_buffer_data_size = data_size;
+  }
+  for (int i = 0; i < pbi->cb_buffer_alloc_size; ++i) {
+    setup_cb_buffer(&cm->seq_params, pbi->cb_buffer_base + i,
+                    pbi->cb_buffer_data + i * data_size);
   }
 }
 
@@ -4710,6 +5048,7 @@ static int read_uncompressed_header(AV1Decoder *pbi,
     aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
                        "No sequence header");
   }
+  pbi->frame_skipped = 0;
 
   cm->last_frame_type = current_frame->frame_type;
 
@@ -4787,6 +5126,10 @@ static int read_uncompressed_header(AV1Decoder *pbi,
       // frame is output via the show_existing_frame mechanism at most once.
       if (pbi->reset_decoder_state) frame_to_show->showable_frame = 0;
 
+      // A frame whose reconstruction was skipped cannot be shown later.
+      pbi->frame_skipped = pbi->skip_frames == AOM_SKIP_FRAMES_NON_KEY &&
+                           frame_to_show->frame_type != KEY_FRAME;
+
       cm->film_grain_params = frame_to_show->film_grain_params;
 
       if (pbi->reset_decoder_state) {
@@ -4834,6 +5177,11 @@ static int read_uncompressed_header(AV1Decoder *pbi,
             : aom_rb_read_bit(rb);
   }
 
+  if (current_frame->frame_type == KEY_FRAME) {
+    pbi->skip_frames = pbi->skip_frames_request;
+    cm->luma_only = pbi->luma_only_request;
+  }
+
   if (current_frame->frame_type == KEY_FRAME && cm->show_frame) {
     /* All frames need to be marked as not valid for referencing */
     for (int i = 0; i < REF_FRAMES; i++) {
@@ -5176,7 +5524,8 @@ static int read_uncompressed_header(AV1Decoder *pbi,
   cm->cur_frame->buf.transfer_characteristics =
       seq_params->transfer_characteristics;
   cm->cur_frame->buf.matrix_coefficients = seq_params->matrix_coefficients;
-  cm->cur_frame->buf.monochrome = seq_params->monochrome;
+  // Luma-only frames are output as monochrome images.
+  cm->cur_frame->buf.monochrome = seq_params->monochrome || cm->luma_only;
   cm->cur_frame->buf.chroma_sample_position =
       seq_params->chroma_sample_position;
   cm->cur_frame->buf.color_range = seq_params->color_range;
@@ -5348,6 +5697,20 @@ static AOM_INLINE void superres_post_decode(AV1Decoder *pbi) {
   av1_superres_upscale(cm, pool);
 }
 
+// Returns 1 if the tiles of the current frame are not decoded because of
+// AV1D_SET_SKIP_FRAMES. Only the frame headers of such frames are parsed.
+static INLINE int skip_frame_reconstruction(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  if (cm->large_scale_tile) return 0;
+  switch (pbi->skip_frames) {
+    case AOM_SKIP_FRAMES_NON_REFERENCE:
+      return cm->current_frame.refresh_frame_flags == 0;
+    case AOM_SKIP_FRAMES_NON_KEY:
+      return cm->current_frame.frame_type != KEY_FRAME;
+    default: return 0;
+  }
+}
+
 uint32_t av1_decode_frame_headers_and_setup(AV1Decoder *pbi,
                                             struct aom_read_bit_buffer *rb,
                                             const uint8_t *data,
@@ -5406,9 +5769,12 @@ uint32_t av1_decode_frame_headers_and_setup(AV1Decoder *pbi,
     return uncomp_hdr_size;
   }
 
-  cm->setup_mi(cm);
+  pbi->frame_skipped = skip_frame_reconstruction(pbi);
+  if (!pbi->frame_skipped) {
+    cm->setup_mi(cm);
 
-  av1_setup_motion_field(cm);
+    av1_setup_motion_field(cm);
+  }
 
   av1_setup_block_planes(xd, cm->seq_params.subsampling_x,
                          cm->seq_params.subsampling_y, num_planes);
@@ -5435,12 +5801,56 @@ static AOM_INLINE void setup_frame_info(AV1Decoder *pbi) {
       cm->rst_info[2].frame_restoration_type != RESTORE_NONE) {
     av1_alloc_restoration_buffers(cm);
   }
-  const int use_highbd = cm->seq_params.use_highbitdepth;
-  const int buf_size = MC_TEMP_BUF_PELS << use_highbd;
-  if (pbi->td.mc_buf_size != buf_size) {
-    av1_free_mc_tmp_buf(&pbi->td);
-    allocate_mc_tmp_buf(cm, &pbi->td, buf_size, use_highbd);
+  alloc_td_bufs(cm, &pbi->td);
+}
+
+// Returns 1 if the loop filter, CDEF and loop restoration are not applied to
+// the current frame because it is shown but never used as a reference. See
+// AV1D_SET_SKIP_OUTPUT_ONLY_FILTERS.
+static INLINE int skip_output_only_filters(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  return pbi->skip_output_only_filters && cm->show_frame &&
+         cm->current_frame.refresh_frame_flags == 0;
+}
+
+// Returns 1 if any loop filter, CDEF, superres or loop restoration pass runs
+// on the current frame after its tiles have been decoded.
+static INLINE int frame_has_post_filters(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  if (cm->allow_intrabc || cm->single_tile_decoding) return 0;
+  if (av1_superres_scaled(cm)) return 1;
+  if (skip_output_only_filters(pbi)) return 0;
+  return cm->lf.filter_level[0] || cm->lf.filter_level[1] ||
+         (!cm->skip_loop_filter && !cm->coded_lossless &&
+          (cm->cdef_info.cdef_bits || cm->cdef_info.cdef_strengths[0] ||
+           cm->cdef_info.cdef_uv_strengths[0])) ||
+         cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+         cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+         cm->rst_info[2].frame_restoration_type != RESTORE_NONE;
+}
+
+static AOM_INLINE void row_progress_frame_init(AV1Decoder *pbi) {
+  AV1_COMMON *const cm = &pbi->common;
+  const int sb_rows = (cm->mi_rows + cm->seq_params.mib_size - 1) >>
+                      cm->seq_params.mib_size_log2;
+
+  pbi->row_progress_rows_done = 0;
+  pbi->row_progress_early = 0;
+  if (pbi->row_progress_cb == NULL || cm->large_scale_tile) return;
+
+  if (pbi->row_progress_alloc_sb_rows < sb_rows) {
+    aom_free(pbi->row_progress_tile_cols_done);
+    pbi->row_progress_alloc_sb_rows = 0;
+    CHECK_MEM_ERROR(cm, pbi->row_progress_tile_cols_done,
+                    aom_malloc(sb_rows *
+                               sizeof(*pbi->row_progress_tile_cols_done)));
+    pbi->row_progress_alloc_sb_rows = sb_rows;
   }
+  memset(pbi->row_progress_tile_cols_done, 0,
+         sb_rows * sizeof(*pbi->row_progress_tile_cols_done));
+  // Monochrome frames get their chroma planes set after the tiles are decoded.
+  pbi->row_progress_early = !frame_has_post_filters(pbi) &&
+                            av1_num_planes(cm) == 3 && !cm->partial_tile_decode;
 }
 
 void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
@@ -5451,21 +5861,39 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
   MACROBLOCKD *const xd = &pbi->mb;
   const int tile_count_tg = end_tile - start_tile + 1;
 
-  if (initialize_flag) setup_frame_info(pbi);
+  if (pbi->frame_skipped) {
+    // The tile data of a skipped frame is not parsed. Its buffer only
+    // provides the frame context for frames that refer to it, which are
+    // skipped as well.
+    *p_data_end = data_end;
+    if (end_tile == cm->tile_rows * cm->tile_cols - 1)
+      cm->cur_frame->frame_context = *cm->fc;
+    return;
+  }
+
+  if (initialize_flag) {
+    setup_frame_info(pbi);
+    cm->partial_tile_decode = pbi->tile_mask_enabled && !cm->large_scale_tile;
+    row_progress_frame_init(pbi);
+  }
   const int num_planes = av1_num_planes(cm);
 #if CONFIG_LPF_MASK
   av1_loop_filter_frame_init(cm, 0, num_planes);
 #endif
 
+  start_dec_timing(pbi, AOM_DECODE_STAGE_TILES);
   if (pbi->max_threads > 1 && !(cm->large_scale_tile && !pbi->ext_tile_debug) &&
-      pbi->row_mt)
+      pbi->row_mt && !cm->partial_tile_decode)
     *p_data_end =
         decode_tiles_row_mt(pbi, data, data_end, start_tile, end_tile);
   else if (pbi->max_threads > 1 && tile_count_tg > 1 &&
-           !(cm->large_scale_tile && !pbi->ext_tile_debug))
+           !(cm->large_scale_tile && !pbi->ext_tile_debug)) {
+    // Tiles complete out of order here; rows are reported at the end.
+    pbi->row_progress_early = 0;
     *p_data_end = decode_tiles_mt(pbi, data, data_end, start_tile, end_tile);
-  else
+  } else
     *p_data_end = decode_tiles(pbi, data, data_end, start_tile, end_tile);
+  end_dec_timing(pbi, AOM_DECODE_STAGE_TILES);
 
   // If the bit stream is monochrome, set the U and V buffers to a constant.
   if (num_planes < 3) {
@@ -5477,71 +5905,96 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
   }
 
   if (!cm->allow_intrabc && !cm->single_tile_decoding) {
-    if (cm->lf.filter_level[0] || cm->lf.filter_level[1]) {
+    const int skip_filters = skip_output_only_filters(pbi);
+    const int do_loop_restoration =
+        !skip_filters &&
+        (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+         cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+         cm->rst_info[2].frame_restoration_type != RESTORE_NONE);
+    const int do_cdef =
+        !skip_filters && !cm->skip_loop_filter && !cm->coded_lossless &&
+        (cm->cdef_info.cdef_bits || cm->cdef_info.cdef_strengths[0] ||
+         cm->cdef_info.cdef_uv_strengths[0]);
+    const int do_superres = av1_superres_scaled(cm);
+    const int optimized_loop_restoration = !do_cdef && !do_superres;
+    // The rows are reported by the last filter pass that modifies them, when
+    // it runs on the workers.
+    const av1_rows_done_fn_t rows_done =
+        pbi->row_progress_cb != NULL && !cm->large_scale_tile
+            ? report_filtered_rows
+            : NULL;
+
+    if ((cm->lf.filter_level[0] || cm->lf.filter_level[1]) && !skip_filters) {
+      start_dec_timing(pbi, AOM_DECODE_STAGE_LOOP_FILTER);
       if (pbi->num_workers > 1) {
+        const int lf_is_last =
+            optimized_loop_restoration && !do_loop_restoration;
         av1_loop_filter_frame_mt(
-            &cm->cur_frame->buf, cm, &pbi->mb, 0, num_planes, 0,
+            &cm->cur_frame->buf, cm, &pbi->mb, 0, av1_num_recon_planes(cm), 0,
 #if CONFIG_LPF_MASK
             1,
 #endif
-            pbi->tile_workers, pbi->num_workers, &pbi->lf_row_sync);
+            pbi->tile_workers, pbi->num_workers, &pbi->lf_row_sync,
+            lf_is_last ? rows_done : NULL, pbi);
       } else {
         av1_loop_filter_frame(&cm->cur_frame->buf, cm, &pbi->mb,
 #if CONFIG_LPF_MASK
                               1,
 #endif
-                              0, num_planes, 0);
+                              0, av1_num_recon_planes(cm), 0);
       }
+      end_dec_timing(pbi, AOM_DECODE_STAGE_LOOP_FILTER);
     }
 
-    const int do_loop_restoration =
-        cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
-        cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
-        cm->rst_info[2].frame_restoration_type != RESTORE_NONE;
-    const int do_cdef =
-        !cm->skip_loop_filter && !cm->coded_lossless &&
-        (cm->cdef_info.cdef_bits || cm->cdef_info.cdef_strengths[0] ||
-         cm->cdef_info.cdef_uv_strengths[0]);
-    const int do_superres = av1_superres_scaled(cm);
-    const int optimized_loop_restoration = !do_cdef && !do_superres;
-
     if (!optimized_loop_restoration) {
       if (do_loop_restoration)
         av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf,
                                                  cm, 0);
 
-      if (do_cdef) av1_cdef_frame(&pbi->common.cur_frame->buf, cm, &pbi->mb);
+      if (do_cdef) {
+        start_dec_timing(pbi, AOM_DECODE_STAGE_CDEF);
+        av1_cdef_frame(&pbi->common.cur_frame->buf, cm, &pbi->mb);
+        end_dec_timing(pbi, AOM_DECODE_STAGE_CDEF);
+      }
 
-      superres_post_decode(pbi);
+      if (do_superres) {
+        start_dec_timing(pbi, AOM_DECODE_STAGE_SUPERRES);
+        superres_post_decode(pbi);
+        end_dec_timing(pbi, AOM_DECODE_STAGE_SUPERRES);
+      }
 
       if (do_loop_restoration) {
+        start_dec_timing(pbi, AOM_DECODE_STAGE_LOOP_RESTORATION);
         av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf,
                                                  cm, 1);
         if (pbi->num_workers > 1) {
           av1_loop_restoration_filter_frame_mt(
               (YV12_BUFFER_CONFIG *)xd->cur_buf, cm, optimized_loop_restoration,
               pbi->tile_workers, pbi->num_workers, &pbi->lr_row_sync,
-              &pbi->lr_ctxt);
+              &pbi->lr_ctxt, rows_done, pbi);
         } else {
           av1_loop_restoration_filter_frame((YV12_BUFFER_CONFIG *)xd->cur_buf,
                                             cm, optimized_loop_restoration,
                                             &pbi->lr_ctxt);
         }
+        end_dec_timing(pbi, AOM_DECODE_STAGE_LOOP_RESTORATION);
       }
     } else {
       // In no cdef and no superres case. Provide an optimized version of
       // loop_restoration_filter.
       if (do_loop_restoration) {
+        start_dec_timing(pbi, AOM_DECODE_STAGE_LOOP_RESTORATION);
         if (pbi->num_workers > 1) {
           av1_loop_restoration_filter_frame_mt(
               (YV12_BUFFER_CONFIG *)xd->cur_buf, cm, optimized_loop_restoration,
               pbi->tile_workers, pbi->num_workers, &pbi->lr_row_sync,
-              &pbi->lr_ctxt);
+              &pbi->lr_ctxt, rows_done, pbi);
         } else {
           av1_loop_restoration_filter_frame((YV12_BUFFER_CONFIG *)xd->cur_buf,
                                             cm, optimized_loop_restoration,
                                             &pbi->lr_ctxt);
         }
+        end_dec_timing(pbi, AOM_DECODE_STAGE_LOOP_RESTORATION);
       }
     }
   }
@@ -5560,6 +6013,9 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                        "Decode failed. Frame data is corrupted.");
   }
 
+  if (pbi->row_progress_cb != NULL && !cm->large_scale_tile)
+    report_row_progress(pbi, cm->height);
+
 #if CONFIG_INSPECTION
   if (pbi->inspect_cb != NULL) {
     (*pbi->inspect_cb)(pbi, pbi->inspect_ctx);
@@ -49,6 +49,12 @@ void av1_decode_tg_tiles_and_wrapup(struct AV1Decoder *pbi, const uint8_t *data,
                                     const uint8_t **p_data_end, int start_tile,
                                     int end_tile, int initialize_flag);
 
+// Decodes the entries of the tile list in pbi->tile_list_entries with the
+// tile workers, writing each tile directly into its place in
+// pbi->tile_list_outbuf. The tile data must lie before data_end. On failure,
+// calls aom_internal_error and does not return.
+void av1_decode_tile_list_mt(struct AV1Decoder *pbi, const uint8_t *data_end);
+
 // Implements the color_config() function in the spec. Reports errors by
 // calling rb->error_handler() or aom_internal_error().
 void av1_read_color_config(struct aom_read_bit_buffer *rb,
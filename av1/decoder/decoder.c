@@ -176,12 +176,6 @@ AV1Decoder *av1_decoder_create(BufferPool *const pool) {
 
 void av1_dealloc_dec_jobs(struct AV1DecTileMTData *tile_mt_info) {
   if (tile_mt_info != NULL) {
-#if CONFIG_MULTITHREAD
-    if (tile_mt_info->job_mutex != NULL) {
-      pthread_mutex_destroy(tile_mt_info->job_mutex);
-      aom_free(tile_mt_info->job_mutex);
-    }
-#endif
     aom_free(tile_mt_info->job_queue);
     // clear the structure as the source of this call may be a resize in which
     // case this call will be followed by an _alloc() which may fail.
@@ -192,7 +186,17 @@ void av1_dealloc_dec_jobs(struct AV1DecTileMTData *tile_mt_info) {
 void av1_dec_free_cb_buf(AV1Decoder *pbi) {
   aom_free(pbi->cb_buffer_base);
   pbi->cb_buffer_base = NULL;
+  aom_free(pbi->cb_buffer_data);
+  pbi->cb_buffer_data = NULL;
   pbi->cb_buffer_alloc_size = 0;
+  pbi->cb_buffer_data_size = 0;
+}
+
+void av1_dec_free_td_cb_buf(ThreadData *td) {
+  aom_free(td->cb_buffer_data);
+  td->cb_buffer_data = NULL;
+  td->cb_buffer_data_size = 0;
+  av1_zero(td->cb_buffer_base);
 }
 
 void av1_decoder_remove(AV1Decoder *pbi) {
@@ -209,7 +213,9 @@ void av1_decoder_remove(AV1Decoder *pbi) {
   if (pbi->thread_data) {
     for (int worker_idx = 0; worker_idx < pbi->max_threads - 1; worker_idx++) {
       DecWorkerData *const thread_data = pbi->thread_data + worker_idx;
+      if (thread_data->td == NULL) continue;
       av1_free_mc_tmp_buf(thread_data->td);
+      av1_dec_free_td_cb_buf(thread_data->td);
       aom_free(thread_data->td);
     }
     aom_free(pbi->thread_data);
@@ -243,14 +249,84 @@ void av1_decoder_remove(AV1Decoder *pbi) {
   }
 
   av1_dec_free_cb_buf(pbi);
+  aom_free(pbi->row_progress_tile_cols_done);
 #if CONFIG_ACCOUNTING
   aom_accounting_clear(&pbi->accounting);
 #endif
   av1_free_mc_tmp_buf(&pbi->td);
+  av1_dec_free_td_cb_buf(&pbi->td);
 
   aom_free(pbi);
 }
 
+static size_t get_td_memory_usage(const AV1_COMMON *cm, const ThreadData *td) {
+  size_t size = td->cb_buffer_data_size;
+  if (td->mc_buf_size > 0) {
+    const int use_highbd = td->mc_buf_use_highbd;
+    size += 2 * (size_t)td->mc_buf_size;
+    size += block_size_high[cm->seq_params.sb_size] * MAX_SB_SIZE *
+            sizeof(*td->tmp_conv_dst);
+    size += 2 * (1 + use_highbd) * MAX_MB_PLANE * MAX_SB_SQUARE;
+  }
+  return size;
+}
+
+size_t av1_dec_get_memory_usage(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  size_t size = sizeof(*pbi);
+
+  // Mode info and motion field projection.
+  size += (size_t)cm->mi_alloc_size * sizeof(*cm->mi);
+  size += (size_t)cm->mi_grid_size *
+          (sizeof(*cm->mi_grid_base) + sizeof(*cm->tx_type_map));
+  size += (size_t)cm->tpl_mvs_mem_size * sizeof(*cm->tpl_mvs);
+
+  // Loop restoration.
+  for (int plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    const RestorationInfo *const rsi = &cm->rst_info[plane];
+    if (rsi->unit_info != NULL)
+      size += (size_t)rsi->units_per_tile * sizeof(*rsi->unit_info);
+    size += 2 * (size_t)rsi->boundaries.stripe_boundary_size;
+  }
+  if (cm->rst_tmpbuf != NULL) size += RESTORATION_TMPBUF_SIZE;
+
+  // Tiles and coefficients.
+  size += (size_t)pbi->allocated_tiles * sizeof(*pbi->tile_data);
+  size += (size_t)pbi->cb_buffer_alloc_size *
+          (sizeof(*pbi->cb_buffer_base) + pbi->cb_buffer_data_size);
+  size += pbi->tile_list_outbuf.buffer_alloc_sz;
+
+  // Worker threads. The last worker uses the thread data in pbi.
+  size += get_td_memory_usage(cm, &pbi->td);
+  size += (size_t)pbi->num_workers *
+          (sizeof(*pbi->tile_workers) + sizeof(*pbi->thread_data));
+  for (int i = 0; i < pbi->num_workers - 1; ++i) {
+    const ThreadData *const td = pbi->thread_data[i].td;
+    if (td != NULL) size += sizeof(*td) + get_td_memory_usage(cm, td);
+  }
+
+  // Frame buffers.
+  const BufferPool *const pool = cm->buffer_pool;
+  if (pool != NULL) {
+    const InternalFrameBufferList *const list = &pool->int_frame_buffers;
+    if (list->int_fb != NULL) {
+      for (int i = 0; i < list->num_internal_frame_buffers; ++i)
+        size += list->int_fb[i].size;
+    }
+    for (int i = 0; i < FRAME_BUFFERS; ++i) {
+      const RefCntBuffer *const buf = &pool->frame_bufs[i];
+      size += buf->buf.buffer_alloc_sz;
+      if (buf->mvs != NULL) {
+        size += (size_t)((buf->mi_rows + 1) >> 1) * ((buf->mi_cols + 1) >> 1) *
+                sizeof(*buf->mvs);
+      }
+      if (buf->seg_map != NULL)
+        size += (size_t)buf->mi_rows * buf->mi_cols * sizeof(*buf->seg_map);
+    }
+  }
+  return size;
+}
+
 void av1_visit_palette(AV1Decoder *const pbi, MACROBLOCKD *const xd, int mi_row,
                        int mi_col, aom_reader *r, BLOCK_SIZE bsize,
                        palette_visitor_fn_t visit) {
@@ -372,6 +448,50 @@ static void release_current_frame(AV1Decoder *pbi) {
   cm->cur_frame = NULL;
 }
 
+void av1_decoder_reset(AV1Decoder *pbi) {
+  AV1_COMMON *const cm = &pbi->common;
+  BufferPool *const pool = cm->buffer_pool;
+
+  if (pbi->frame_in_progress) {
+    release_current_frame(pbi);
+    pbi->frame_in_progress = 0;
+  }
+
+  lock_buffer_pool(pool);
+  for (size_t i = 0; i < pbi->num_output_frames; i++) {
+    decrease_ref_count(pbi->output_frames[i], pool);
+  }
+  pbi->num_output_frames = 0;
+  for (int i = 0; i < REF_FRAMES; i++) {
+    decrease_ref_count(cm->ref_frame_map[i], pool);
+    cm->ref_frame_map[i] = NULL;
+  }
+  for (int i = 0; i < FRAME_BUFFERS; ++i) {
+    RefCntBuffer *const buf = &pool->frame_bufs[i];
+    if (buf->ref_count > 0) continue;
+    buf->order_hint = 0;
+    av1_zero(buf->ref_order_hints);
+  }
+  unlock_buffer_pool(pool);
+
+  for (int i = 0; i < INTER_REFS_PER_FRAME; i++) {
+    cm->remapped_ref_idx[i] = INVALID_IDX;
+  }
+  cm->prev_frame = NULL;
+  cm->last_frame_seg_map = NULL;
+  cm->current_frame.frame_number = 0;
+
+  // Wait for a sequence header and a key frame, like a new decoder.
+  pbi->need_resync = 1;
+  pbi->decoding_first_frame = 1;
+  pbi->sequence_header_ready = 0;
+  pbi->sequence_header_changed = 0;
+  pbi->reset_decoder_state = 0;
+  pbi->seen_frame_header = 0;
+  pbi->next_start_tile = 0;
+  pbi->camera_frame_header_ready = 0;
+}
+
 // If any buffer updating is signaled it should be done here.
 // Consumes a reference to cm->cur_frame.
 //
@@ -401,7 +521,7 @@ static void update_frame_buffers(AV1Decoder *pbi, int frame_decoded) {
       }
     }
 
-    if (cm->show_existing_frame || cm->show_frame) {
+    if ((cm->show_existing_frame || cm->show_frame) && !pbi->frame_skipped) {
       if (pbi->output_all_layers) {
         // Append this frame to the output queue
         if (pbi->num_output_frames >= MAX_NUM_SPATIAL_LAYERS) {
@@ -464,7 +584,8 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     if (ref_buf != NULL) ref_buf->buf.corrupted = 1;
   }
 
-  if (assign_cur_frame_new_fb(cm) == NULL) {
+  // A partially decoded frame keeps its frame buffer.
+  if (!pbi->frame_in_progress && assign_cur_frame_new_fb(cm) == NULL) {
     cm->error.error_code = AOM_CODEC_MEM_ERROR;
     return 1;
   }
@@ -486,6 +607,7 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     }
 
     release_current_frame(pbi);
+    pbi->frame_in_progress = 0;
     aom_clear_system_state();
     return -1;
   }
@@ -502,6 +624,12 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     return 1;
   }
 
+  if (pbi->frame_in_progress) {
+    // Hold on to cm->cur_frame until its remaining tile groups are decoded.
+    cm->error.setjmp = 0;
+    return 0;
+  }
+
 #if TXCOEFF_TIMER
   cm->cum_txcoeff_timer += cm->txcoeff_timer;
   fprintf(stderr,
@@ -15,8 +15,11 @@
 #include "config/aom_config.h"
 
 #include "aom/aom_codec.h"
+#include "aom/aomdx.h"
 #include "aom_dsp/bitreader.h"
+#include "aom_ports/aom_timer.h"
 #include "aom_scale/yv12config.h"
+#include "aom_util/aom_atomics.h"
 #include "aom_util/aom_thread.h"
 
 #include "av1/common/thread_common.h"
@@ -47,9 +50,14 @@ typedef void (*predict_inter_block_visitor_fn_t)(AV1_COMMON *const cm,
 typedef void (*cfl_store_inter_block_visitor_fn_t)(AV1_COMMON *const cm,
                                                    MACROBLOCKD *const xd);
 
+typedef void (*row_progress_fn_t)(void *priv, int start_row, int end_row);
+
 typedef struct ThreadData {
   DECLARE_ALIGNED(32, MACROBLOCKD, xd);
   CB_BUFFER cb_buffer_base;
+  // Memory that cb_buffer_base points into, and its size in bytes.
+  uint8_t *cb_buffer_data;
+  size_t cb_buffer_data_size;
   aom_reader *bit_reader;
   uint8_t *mc_buf[2];
   int32_t mc_buf_size;
@@ -79,7 +87,7 @@ typedef struct AV1DecRowMTSyncData {
   pthread_cond_t *cond_;
 #endif
   int allocated_sb_rows;
-  int *cur_sb_col;
+  aom_atomic_int *cur_sb_col;
   int sync_range;
   int mi_rows;
   int mi_cols;
@@ -140,18 +148,30 @@ typedef struct EXTERNAL_REFERENCES {
   int num;
 } EXTERNAL_REFERENCES;
 
+// One tile of a tile list OBU (large_scale_tile only).
+typedef struct TileListEntryDec {
+  TileBufferDec tile_buffer;
+  int anchor_frame_idx;
+  int tile_row;
+  int tile_col;
+  // Position of the tile in the output frame, in tiles and in raster order.
+  int output_idx;
+} TileListEntryDec;
+
 typedef struct TileJobsDec {
   TileBufferDec *tile_buffer;
   TileDataDec *tile_data;
+  // When decoding a tile list, the entries decoded by this job. They all
+  // refer to the tile described by tile_data.
+  const TileListEntryDec *tile_list_entries;
+  int num_tile_list_entries;
 } TileJobsDec;
 
 typedef struct AV1DecTileMTData {
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *job_mutex;
-#endif
   TileJobsDec *job_queue;
   int jobs_enqueued;
-  int jobs_dequeued;
+  // Jobs are claimed by incrementing this counter, without a lock.
+  aom_atomic_int jobs_dequeued;
   int alloc_tile_rows;
   int alloc_tile_cols;
 } AV1DecTileMT;
@@ -175,7 +195,8 @@ typedef struct AV1Decoder {
   TileBufferDec tile_buffers[MAX_TILE_ROWS][MAX_TILE_COLS];
   AV1DecTileMT tile_mt_info;
 
-  // Each time the decoder is called, we expect to receive a full temporal unit.
+  // Each time the decoder is called, we expect to receive a full temporal unit,
+  // unless incremental_decode is set.
   // This can contain up to one shown frame per spatial layer in the current
   // operating point (note that some layers may be entirely omitted).
   // If the 'output_all_layers' option is true, we save all of these shown
@@ -209,6 +230,39 @@ typedef struct AV1Decoder {
 #endif
   int sequence_header_ready;
   int sequence_header_changed;
+  // Boolean: whether a temporal unit may be received in several pieces, each
+  // ending on an OBU boundary.
+  int incremental_decode;
+  // Boolean: whether cur_frame has been partially decoded and the remaining
+  // tile groups are expected in the next piece of the temporal unit.
+  int frame_in_progress;
+  // The aom_skip_frames_t mode requested with AV1D_SET_SKIP_FRAMES, and the
+  // one in effect since the last key frame.
+  int skip_frames_request;
+  int skip_frames;
+  // Boolean: whether the current frame is neither reconstructed nor output.
+  int frame_skipped;
+  // Boolean: whether the loop filter, CDEF and loop restoration are skipped on
+  // frames that are shown but never used as a reference.
+  int skip_output_only_filters;
+  // Boolean: the value requested with AV1D_SET_LUMA_ONLY. It is copied to
+  // common.luma_only at the next key frame.
+  int luma_only_request;
+  // Boolean: whether only the tiles set in tile_mask are decoded
+  // (AV1D_SET_TILE_MASK). Bit (i % 32) of tile_mask[i / 32] selects tile i.
+  int tile_mask_enabled;
+  uint32_t tile_mask[MAX_TILES / 32];
+  // Pool whose threads run the jobs of the tile workers, or NULL if the tile
+  // workers have threads of their own (AV1D_SET_THREAD_POOL).
+  AVxThreadPool *thread_pool;
+  // Boolean: whether the decoding stages are timed (AV1D_SET_DECODE_TIMING).
+  int timing_enabled;
+  // Times of the current temporal unit. Reset by the codec interface.
+  aom_decode_timing_t timing;
+  struct aom_usec_timer stage_timer[AOM_DECODE_STAGES];
+  int64_t stage_cpu_start[AOM_DECODE_STAGES];
+  // Measures the time from the launch to the sync of the tile workers.
+  struct aom_usec_timer tile_workers_timer;
 #if CONFIG_INSPECTION
   aom_inspect_cb inspect_cb;
   void *inspect_ctx;
@@ -228,6 +282,7 @@ typedef struct AV1Decoder {
   int output_frame_height_in_tiles_minus_1;
   int tile_count_minus_1;
   uint32_t coded_tile_data_size;
+  TileListEntryDec tile_list_entries[MAX_TILES];
   unsigned int ext_tile_debug;  // for ext-tile software debug & testing
   unsigned int row_mt;
   EXTERNAL_REFERENCES ext_refs;
@@ -235,6 +290,10 @@ typedef struct AV1Decoder {
 
   CB_BUFFER *cb_buffer_base;
   int cb_buffer_alloc_size;
+  // Memory that the cb_buffer_alloc_size buffers of cb_buffer_base point
+  // into, and the size in bytes of the part of it used by each buffer.
+  uint8_t *cb_buffer_data;
+  size_t cb_buffer_data_size;
 
   int allocated_row_mt_sync_rows;
 
@@ -244,6 +303,19 @@ typedef struct AV1Decoder {
 #endif
 
   AV1DecRowMTInfo frame_row_mt_info;
+
+  // Called with [start_row, end_row) ranges of luma rows of cur_frame that
+  // are final. See AV1D_SET_ROW_PROGRESS_CALLBACK.
+  row_progress_fn_t row_progress_cb;
+  void *row_progress_priv;
+  // Boolean: whether rows may be reported as soon as they are reconstructed,
+  // i.e. the current frame has no post-filtering.
+  int row_progress_early;
+  // Number of luma rows of cur_frame reported so far.
+  int row_progress_rows_done;
+  // Number of tile columns that have finished each superblock row.
+  int *row_progress_tile_cols_done;
+  int row_progress_alloc_sb_rows;
 } AV1Decoder;
 
 // Returns 0 on success. Sets pbi->common.error.error_code to a nonzero error
@@ -269,6 +341,10 @@ aom_codec_err_t av1_copy_new_frame_dec(AV1_COMMON *cm,
 
 struct AV1Decoder *av1_decoder_create(BufferPool *const pool);
 
+// Releases the frames referenced by the decoder and resets the state of the
+// stream, keeping the allocations of the decoder for the next stream.
+void av1_decoder_reset(struct AV1Decoder *pbi);
+
 void av1_decoder_remove(struct AV1Decoder *pbi);
 void av1_dealloc_dec_jobs(struct AV1DecTileMTData *tile_mt_info);
 
@@ -276,6 +352,12 @@ void av1_dec_row_mt_dealloc(AV1DecRowMTSync *dec_row_mt_sync);
 
 void av1_dec_free_cb_buf(AV1Decoder *pbi);
 
+void av1_dec_free_td_cb_buf(ThreadData *td);
+
+// Returns an estimate in bytes of the memory allocated by the decoder, its
+// worker threads and the frame buffers of its buffer pool.
+size_t av1_dec_get_memory_usage(const AV1Decoder *pbi);
+
 static INLINE void decrease_ref_count(RefCntBuffer *const buf,
                                       BufferPool *const pool) {
   if (buf != NULL) {
@@ -296,6 +378,22 @@ static INLINE void decrease_ref_count(RefCntBuffer *const buf,
   }
 }
 
+static INLINE void start_dec_timing(AV1Decoder *pbi,
+                                    aom_decode_stage_t stage) {
+  if (!pbi->timing_enabled) return;
+  aom_usec_timer_start(&pbi->stage_timer[stage]);
+  pbi->stage_cpu_start[stage] = aom_thread_cpu_usec();
+}
+
+static INLINE void end_dec_timing(AV1Decoder *pbi, aom_decode_stage_t stage) {
+  if (!pbi->timing_enabled) return;
+  aom_usec_timer_mark(&pbi->stage_timer[stage]);
+  pbi->timing.wall_us[stage] +=
+      aom_usec_timer_elapsed(&pbi->stage_timer[stage]);
+  pbi->timing.cpu_us[stage] +=
+      aom_thread_cpu_usec() - pbi->stage_cpu_start[stage];
+}
+
 #define ACCT_STR __func__
 static INLINE int av1_read_uniform(aom_reader *r, int n) {
   const int l = get_unsigned_bits(n);
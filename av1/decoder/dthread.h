@@ -29,6 +29,13 @@ typedef struct DecWorkerData {
   struct ThreadData *td;
   const uint8_t *data_end;
   struct aom_internal_error_info error_info;
+  // The hook run by the worker when the decoding stages are timed, and the
+  // wall clock and CPU time it took.
+  AVxWorkerHook timed_hook;
+  int64_t busy_us;
+  int64_t busy_cpu_us;
+  // Part of busy_us spent waiting for a row to decode.
+  int64_t wait_us;
 } DecWorkerData;
 
 // WorkerData for the FrameWorker thread. It contains all the information of
@@ -501,53 +501,74 @@ static uint32_t read_and_decode_one_tile_list(AV1Decoder *pbi,
   tile_list_payload_size += tile_list_info_bytes;
   data += tile_list_info_bytes;
 
-  int tile_idx = 0;
+  // Read the tile list entries.
   for (i = 0; i <= pbi->tile_count_minus_1; i++) {
-    // Process 1 tile.
+    TileListEntryDec *const entry = &pbi->tile_list_entries[i];
     // Reset the bit reader.
     rb->bit_offset = 0;
     rb->bit_buffer = data;
 
     // Read out the tile info.
     uint32_t tile_info_bytes = 5;
-    // Set reference for each tile.
-    int ref_idx = aom_rb_read_literal(rb, 8);
-    if (ref_idx >= MAX_EXTERNAL_REFERENCES) {
+    entry->anchor_frame_idx = aom_rb_read_literal(rb, 8);
+    if (entry->anchor_frame_idx >= MAX_EXTERNAL_REFERENCES) {
       cm->error.error_code = AOM_CODEC_CORRUPT_FRAME;
       return 0;
     }
-    av1_set_reference_dec(cm, cm->remapped_ref_idx[0], 1,
-                          &pbi->ext_refs.refs[ref_idx]);
-
-    pbi->dec_tile_row = aom_rb_read_literal(rb, 8);
-    pbi->dec_tile_col = aom_rb_read_literal(rb, 8);
-    if (pbi->dec_tile_row < 0 || pbi->dec_tile_col < 0 ||
-        pbi->dec_tile_row >= cm->tile_rows ||
-        pbi->dec_tile_col >= cm->tile_cols) {
+    entry->tile_row = aom_rb_read_literal(rb, 8);
+    entry->tile_col = aom_rb_read_literal(rb, 8);
+    if (entry->tile_row >= cm->tile_rows || entry->tile_col >= cm->tile_cols) {
       cm->error.error_code = AOM_CODEC_CORRUPT_FRAME;
       return 0;
     }
 
-    pbi->coded_tile_data_size = aom_rb_read_literal(rb, 16) + 1;
+    entry->tile_buffer.size = aom_rb_read_literal(rb, 16) + 1;
     data += tile_info_bytes;
-    if ((size_t)(data_end - data) < pbi->coded_tile_data_size) {
+    if ((size_t)(data_end - data) < entry->tile_buffer.size) {
       cm->error.error_code = AOM_CODEC_CORRUPT_FRAME;
       return 0;
     }
+    entry->tile_buffer.data = data;
+    entry->output_idx = i;
 
-    av1_decode_tg_tiles_and_wrapup(pbi, data, data + pbi->coded_tile_data_size,
-                                   p_data_end, start_tile, end_tile, 0);
-    uint32_t tile_payload_size = (uint32_t)(*p_data_end - data);
-
-    tile_list_payload_size += tile_info_bytes + tile_payload_size;
+    tile_list_payload_size +=
+        tile_info_bytes + (uint32_t)entry->tile_buffer.size;
 
     // Update data ptr for next tile decoding.
-    data = *p_data_end;
-    assert(data <= data_end);
-
-    // Copy the decoded tile to the tile list output buffer.
-    copy_decoded_tile_to_tile_list_buffer(pbi, tile_idx);
-    tile_idx++;
+    data += entry->tile_buffer.size;
+  }
+  *p_data_end = data;
+
+  // With several threads, the tiles are decoded concurrently and straight
+  // into the tile list output buffer. The copy is kept when it also converts
+  // 8-bit content decoded in high bitdepth buffers, and when the frame needs
+  // post-filtering (which would then apply to the whole frame).
+  if (pbi->max_threads > 1 && pbi->tile_count_minus_1 > 0 &&
+      cm->single_tile_decoding &&
+      !(cm->seq_params.use_highbitdepth &&
+        cm->seq_params.bit_depth == AOM_BITS_8)) {
+    av1_decode_tile_list_mt(pbi, data_end);
+  } else {
+    for (i = 0; i <= pbi->tile_count_minus_1; i++) {
+      const TileListEntryDec *const entry = &pbi->tile_list_entries[i];
+      const uint8_t *tile_data_end;
+
+      // Set reference for each tile.
+      av1_set_reference_dec(cm, cm->remapped_ref_idx[0], 1,
+                            &pbi->ext_refs.refs[entry->anchor_frame_idx]);
+      pbi->dec_tile_row = entry->tile_row;
+      pbi->dec_tile_col = entry->tile_col;
+      pbi->coded_tile_data_size = (uint32_t)entry->tile_buffer.size;
+
+      av1_decode_tg_tiles_and_wrapup(
+          pbi, entry->tile_buffer.data,
+          entry->tile_buffer.data + entry->tile_buffer.size, &tile_data_end,
+          start_tile, end_tile, 0);
+      assert(tile_data_end <= data_end);
+
+      // Copy the decoded tile to the tile list output buffer.
+      copy_decoded_tile_to_tile_list_buffer(pbi, entry->output_idx);
+    }
   }
 
   *frame_decoding_finished = 1;
@@ -760,8 +781,16 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
   uint32_t frame_header_size = 0;
   ObuHeader obu_header;
   memset(&obu_header, 0, sizeof(obu_header));
-  pbi->seen_frame_header = 0;
-  pbi->next_start_tile = 0;
+  if (pbi->frame_in_progress) {
+    // Continue the frame whose header and first tile groups were received in
+    // an earlier piece of this temporal unit.
+    is_first_tg_obu_received = pbi->next_start_tile == 0;
+    frame_header_size = (uint32_t)pbi->frame_header_size;
+    pbi->frame_in_progress = 0;
+  } else {
+    pbi->seen_frame_header = 0;
+    pbi->next_start_tile = 0;
+  }
 
   if (data_end < data) {
     cm->error.error_code = AOM_CODEC_CORRUPT_FRAME;
@@ -789,6 +818,14 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
       break;
     }
 
+    if (bytes_available == 0 && pbi->incremental_decode &&
+        !cm->large_scale_tile) {
+      // The rest of the frame arrives with the next piece of data.
+      *p_data_end = data;
+      pbi->frame_in_progress = 1;
+      break;
+    }
+
     aom_codec_err_t status =
         aom_read_obu_header_and_size(data, bytes_available, cm->is_annexb,
                                      &obu_header, &payload_size, &bytes_read);
@@ -836,7 +873,9 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
         pbi->next_start_tile = 0;
         break;
       case OBU_SEQUENCE_HEADER:
+        start_dec_timing(pbi, AOM_DECODE_STAGE_HEADER);
         decoded_payload_size = read_sequence_header_obu(pbi, &rb);
+        end_dec_timing(pbi, AOM_DECODE_STAGE_HEADER);
         if (cm->error.error_code != AOM_CODEC_OK) return -1;
         break;
       case OBU_FRAME_HEADER:
@@ -857,8 +896,10 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
         // Only decode first frame header received
         if (!pbi->seen_frame_header ||
             (cm->large_scale_tile && !pbi->camera_frame_header_ready)) {
+          start_dec_timing(pbi, AOM_DECODE_STAGE_HEADER);
           frame_header_size = read_frame_header_obu(
               pbi, &rb, data, p_data_end, obu_header.type != OBU_FRAME);
+          end_dec_timing(pbi, AOM_DECODE_STAGE_HEADER);
           pbi->seen_frame_header = 1;
           if (!pbi->ext_tile_debug && cm->large_scale_tile)
             pbi->camera_frame_header_ready = 1;
@@ -16,10 +16,23 @@
 extern "C" {
 #endif
 
+#include "aom_util/aom_atomics.h"
 #include "av1/encoder/encoder.h"
 
 struct aom_write_bit_buffer;
 
+// The entropy coding of the tiles of a frame. The threads writing the symbols
+// of the tiles claim them one at a time. The coded tiles are then copied to
+// the bitstream in tile order, with their sizes.
+typedef struct PackTilesCtx {
+  // The writer of each tile in raster order, left running until its tile is
+  // copied.
+  aom_writer *writers;
+  int num_tiles;
+  // The next tile to write.
+  aom_atomic_int next_tile;
+} PackTilesCtx;
+
 // Writes only the OBU Sequence Header payload, and returns the size of the
 // payload written to 'dst'. This function does not write the OBU header, the
 // optional extension, or the OBU size to 'dst'.
@@ -36,6 +49,9 @@ int av1_write_uleb_obu_size(uint32_t obu_header_size, uint32_t obu_payload_size,
 int av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dst, size_t *size,
                        int *const largest_tile_id);
 
+// Writes the symbols of the tiles of 'ctx' not claimed by another thread.
+void av1_write_tiles_symbols(AV1_COMP *cpi, ThreadData *td, PackTilesCtx *ctx);
+
 void av1_write_tx_type(const AV1_COMMON *const cm, const MACROBLOCKD *xd,
                        TX_TYPE tx_type, TX_SIZE tx_size, aom_writer *w);
 
@@ -902,6 +902,7 @@ static int denoise_and_encode(AV1_COMP *const cpi, uint8_t *const dest,
                               EncodeFrameInput *const frame_input,
                               EncodeFrameParams *const frame_params,
                               EncodeFrameResults *const frame_results,
+                              struct lookahead_entry *source,
                               int *temporal_filtered) {
   if (frame_params->frame_type != KEY_FRAME ||
       !cpi->oxcf.enable_keyframe_filtering) {
@@ -918,7 +919,9 @@ static int denoise_and_encode(AV1_COMP *const cpi, uint8_t *const dest,
   const int use_hbd = frame_input->source->flags & YV12_FLAG_HIGHBITDEPTH;
   const int num_planes = av1_num_planes(cm);
 
-  if (use_hbd) {
+  if (frame_input->source == &source->img) {
+    noise_level = av1_lookahead_get_stats(cpi->lookahead, source)->noise_level;
+  } else if (use_hbd) {
     noise_level = highbd_estimate_noise(
         frame_input->source->y_buffer, frame_input->source->y_crop_width,
         frame_input->source->y_crop_height, frame_input->source->y_stride,
@@ -1306,7 +1309,7 @@ int av1_encode_strategy(AV1_COMP *const cpi, size_t *const size,
   }
 #else
   if (denoise_and_encode(cpi, dest, &frame_input, &frame_params, &frame_results,
-                         &code_arf) != AOM_CODEC_OK) {
+                         source, &code_arf) != AOM_CODEC_OK) {
     return AOM_CODEC_ERROR;
   }
 #endif  // CONFIG_REALTIME_ONLY
@@ -4737,7 +4737,7 @@ static INLINE int64_t calc_erroradv_threshold(AV1_COMP *cpi,
 
 static void compute_global_motion_for_ref_frame(
     AV1_COMP *cpi, YV12_BUFFER_CONFIG *ref_buf[REF_FRAMES], int frame,
-    int *num_frm_corners, int *frm_corners, unsigned char *frm_buffer,
+    int num_frm_corners, int *frm_corners, unsigned char *frm_buffer,
     MotionModel *params_by_motion, uint8_t *segment_map,
     const int segment_map_w, const int segment_map_h,
     const WarpedMotionParams *ref_params) {
@@ -4754,13 +4754,8 @@ static void compute_global_motion_for_ref_frame(
   WarpedMotionParams tmp_wm_params;
   const double *params_this_motion;
   int inliers_by_motion[RANSAC_NUM_MOTIONS];
+  GlobalMotionCorrespondences corrs;
   assert(ref_buf[frame] != NULL);
-  if (*num_frm_corners < 0) {
-    // compute interest points using FAST features
-    *num_frm_corners = av1_fast_corner_detect(
-        frm_buffer, cpi->source->y_width, cpi->source->y_height,
-        cpi->source->y_stride, frm_corners, MAX_CORNERS);
-  }
   TransformationType model;
 
   aom_clear_system_state();
@@ -4776,6 +4771,7 @@ static void compute_global_motion_for_ref_frame(
               abs(ref_frame_dist) <= 2 && do_adaptive_gm_estimation
           ? GLOBAL_MOTION_DISFLOW_BASED
           : GLOBAL_MOTION_FEATURE_BASED;
+  av1_init_gm_correspondences(&corrs);
   for (model = ROTZOOM; model < GLOBAL_TRANS_TYPES_ENC; ++model) {
     int64_t best_warp_error = INT64_MAX;
     // Initially set all params to identity.
@@ -4787,9 +4783,9 @@ static void compute_global_motion_for_ref_frame(
 
     av1_compute_global_motion(
         model, frm_buffer, cpi->source->y_width, cpi->source->y_height,
-        cpi->source->y_stride, frm_corners, *num_frm_corners, ref_buf[frame],
-        cpi->common.seq_params.bit_depth, gm_estimation_type, inliers_by_motion,
-        params_by_motion, RANSAC_NUM_MOTIONS);
+        cpi->source->y_stride, frm_corners, num_frm_corners, ref_buf[frame],
+        cpi->common.seq_params.bit_depth, gm_estimation_type, &corrs,
+        inliers_by_motion, params_by_motion, RANSAC_NUM_MOTIONS);
     int64_t ref_frame_error = 0;
     for (i = 0; i < RANSAC_NUM_MOTIONS; ++i) {
       if (inliers_by_motion[i] == 0) continue;
@@ -4860,6 +4856,7 @@ static void compute_global_motion_for_ref_frame(
 
     if (cm->global_motion[frame].wmtype != IDENTITY) break;
   }
+  av1_free_gm_correspondences(&corrs);
 
   aom_clear_system_state();
 }
@@ -4920,7 +4917,7 @@ static INLINE void update_valid_ref_frames_for_gm(
 
 static INLINE void compute_gm_for_valid_ref_frames(
     AV1_COMP *cpi, YV12_BUFFER_CONFIG *ref_buf[REF_FRAMES], int frame,
-    int *num_frm_corners, int *frm_corners, unsigned char *frm_buffer,
+    int num_frm_corners, int *frm_corners, unsigned char *frm_buffer,
     MotionModel *params_by_motion, uint8_t *segment_map,
     const int segment_map_w, const int segment_map_h) {
   AV1_COMMON *const cm = &cpi->common;
@@ -4949,28 +4946,61 @@ static int compare_distance(const void *a, const void *b) {
   return 0;
 }
 
+void av1_compute_gm_for_refs(AV1_COMP *cpi, GlobalMotionCtx *gm_ctx) {
+  const YV12_BUFFER_CONFIG *const source = cpi->source;
+  MotionModel params_by_motion[RANSAC_NUM_MOTIONS];
+  for (int m = 0; m < RANSAC_NUM_MOTIONS; m++) {
+    memset(&params_by_motion[m], 0, sizeof(params_by_motion[m]));
+    params_by_motion[m].inliers =
+        aom_malloc(sizeof(*(params_by_motion[m].inliers)) * 2 * MAX_CORNERS);
+  }
+  const int segment_map_w =
+      (source->y_width + WARP_ERROR_BLOCK) >> WARP_ERROR_BLOCK_LOG;
+  const int segment_map_h =
+      (source->y_height + WARP_ERROR_BLOCK) >> WARP_ERROR_BLOCK_LOG;
+  uint8_t *segment_map =
+      aom_malloc(sizeof(*segment_map) * segment_map_w * segment_map_h);
+  memset(segment_map, 0, sizeof(*segment_map) * segment_map_w * segment_map_h);
+
+  int idx;
+  while ((idx = aom_atomic_fetch_add(&gm_ctx->next_frame, 1)) <
+         gm_ctx->num_frames) {
+    compute_gm_for_valid_ref_frames(
+        cpi, gm_ctx->ref_buf, gm_ctx->frames[idx], gm_ctx->num_frm_corners,
+        gm_ctx->frm_corners, gm_ctx->frm_buffer, params_by_motion, segment_map,
+        segment_map_w, segment_map_h);
+  }
+
+  aom_free(segment_map);
+  for (int m = 0; m < RANSAC_NUM_MOTIONS; m++) {
+    aom_free(params_by_motion[m].inliers);
+  }
+}
+
 static INLINE void compute_global_motion_for_references(
-    AV1_COMP *cpi, YV12_BUFFER_CONFIG *ref_buf[REF_FRAMES],
-    FrameDistPair reference_frame[REF_FRAMES - 1], int num_ref_frames,
-    int *num_frm_corners, int *frm_corners, unsigned char *frm_buffer,
-    MotionModel *params_by_motion, uint8_t *segment_map,
-    const int segment_map_w, const int segment_map_h) {
-  AV1_COMMON *const cm = &cpi->common;
-  // Compute global motion w.r.t. reference frames
-  for (int frame = 0; frame < num_ref_frames; frame++) {
-    int ref_frame = reference_frame[frame].frame;
-    compute_gm_for_valid_ref_frames(cpi, ref_buf, ref_frame, num_frm_corners,
-                                    frm_corners, frm_buffer, params_by_motion,
-                                    segment_map, segment_map_w, segment_map_h);
-    // If farthest ref frame yields INVALID/TRANSLATION/IDENTITY  global
-    // motion, skip evaluation of global motion w.r.t to other ref frames in
-    // that direction
-    if (cpi->sf.prune_ref_frame_for_gm_search && frame == 0 &&
-        cm->global_motion[ref_frame].wmtype != ROTZOOM)
-      break;
+    AV1_COMP *cpi, GlobalMotionCtx *gm_ctx) {
+  aom_atomic_init(&gm_ctx->next_frame, 0);
+  if (cpi->oxcf.max_threads > 1 && gm_ctx->num_frames > 1) {
+    // Convert the references to 8 bits here, as two of them may share a
+    // buffer.
+    for (int i = 0; i < gm_ctx->num_frames; i++) {
+      YV12_BUFFER_CONFIG *const buf = gm_ctx->ref_buf[gm_ctx->frames[i]];
+      if (buf->flags & YV12_FLAG_HIGHBITDEPTH)
+        av1_downconvert_frame(buf, cpi->common.seq_params.bit_depth);
+    }
+    av1_global_motion_mt(cpi, gm_ctx);
+  } else {
+    av1_compute_gm_for_refs(cpi, gm_ctx);
   }
 }
 
+static INLINE void add_gm_ref_frames(GlobalMotionCtx *gm_ctx,
+                                     const FrameDistPair *reference_frame,
+                                     int start, int end) {
+  for (int frame = start; frame < end; frame++)
+    gm_ctx->frames[gm_ctx->num_frames++] = reference_frame[frame].frame;
+}
+
 static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
   ThreadData *const td = &cpi->td;
   MACROBLOCK *const x = &td->mb;
@@ -5145,14 +5175,6 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
   if (cpi->common.current_frame.frame_type == INTER_FRAME && cpi->source &&
       cpi->oxcf.enable_global_motion && !cpi->global_motion_search_done) {
     YV12_BUFFER_CONFIG *ref_buf[REF_FRAMES];
-    MotionModel params_by_motion[RANSAC_NUM_MOTIONS];
-    for (int m = 0; m < RANSAC_NUM_MOTIONS; m++) {
-      memset(&params_by_motion[m], 0, sizeof(params_by_motion[m]));
-      params_by_motion[m].inliers =
-          aom_malloc(sizeof(*(params_by_motion[m].inliers)) * 2 * MAX_CORNERS);
-    }
-
-    int num_frm_corners = -1;
     int frm_corners[2 * MAX_CORNERS];
     unsigned char *frm_buffer = cpi->source->y_buffer;
     if (cpi->source->flags & YV12_FLAG_HIGHBITDEPTH) {
@@ -5161,15 +5183,6 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
       frm_buffer =
           av1_downconvert_frame(cpi->source, cpi->common.seq_params.bit_depth);
     }
-    const int segment_map_w =
-        (cpi->source->y_width + WARP_ERROR_BLOCK) >> WARP_ERROR_BLOCK_LOG;
-    const int segment_map_h =
-        (cpi->source->y_height + WARP_ERROR_BLOCK) >> WARP_ERROR_BLOCK_LOG;
-
-    uint8_t *segment_map =
-        aom_malloc(sizeof(*segment_map) * segment_map_w * segment_map_h);
-    memset(segment_map, 0,
-           sizeof(*segment_map) * segment_map_w * segment_map_h);
 
     FrameDistPair future_ref_frame[REF_FRAMES - 1] = {
       { -1, NONE_FRAME }, { -1, NONE_FRAME }, { -1, NONE_FRAME },
@@ -5194,26 +5207,47 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
     qsort(future_ref_frame, num_future_ref_frames, sizeof(future_ref_frame[0]),
           compare_distance);
 
-    // Compute global motion w.r.t. past reference frames
-    if (num_past_ref_frames > 0)
-      compute_global_motion_for_references(
-          cpi, ref_buf, past_ref_frame, num_past_ref_frames, &num_frm_corners,
-          frm_corners, frm_buffer, params_by_motion, segment_map, segment_map_w,
-          segment_map_h);
-
-    // Compute global motion w.r.t. future reference frames
-    if (num_future_ref_frames > 0)
-      compute_global_motion_for_references(
-          cpi, ref_buf, future_ref_frame, num_future_ref_frames,
-          &num_frm_corners, frm_corners, frm_buffer, params_by_motion,
-          segment_map, segment_map_w, segment_map_h);
-
-    aom_free(segment_map);
+    GlobalMotionCtx gm_ctx;
+    gm_ctx.ref_buf = ref_buf;
+    gm_ctx.frm_buffer = frm_buffer;
+    gm_ctx.frm_corners = frm_corners;
+    gm_ctx.num_frm_corners = 0;
+    if (num_past_ref_frames > 0 || num_future_ref_frames > 0) {
+      // compute interest points using FAST features, once for all the
+      // references
+      gm_ctx.num_frm_corners = av1_fast_corner_detect(
+          frm_buffer, cpi->source->y_width, cpi->source->y_height,
+          cpi->source->y_stride, frm_corners, MAX_CORNERS);
+    }
+
+    // If the farthest ref frame in a direction yields INVALID/TRANSLATION/
+    // IDENTITY global motion, skip evaluation of global motion w.r.t. the
+    // other ref frames in that direction. Otherwise all the ref frames are
+    // searched at once.
+    const int prune_refs = cpi->sf.prune_ref_frame_for_gm_search;
+    gm_ctx.num_frames = 0;
+    add_gm_ref_frames(&gm_ctx, past_ref_frame, 0,
+                      prune_refs ? AOMMIN(1, num_past_ref_frames)
+                                 : num_past_ref_frames);
+    add_gm_ref_frames(&gm_ctx, future_ref_frame, 0,
+                      prune_refs ? AOMMIN(1, num_future_ref_frames)
+                                 : num_future_ref_frames);
+    if (gm_ctx.num_frames > 0)
+      compute_global_motion_for_references(cpi, &gm_ctx);
+
+    if (prune_refs) {
+      gm_ctx.num_frames = 0;
+      if (num_past_ref_frames > 1 &&
+          cm->global_motion[past_ref_frame[0].frame].wmtype == ROTZOOM)
+        add_gm_ref_frames(&gm_ctx, past_ref_frame, 1, num_past_ref_frames);
+      if (num_future_ref_frames > 1 &&
+          cm->global_motion[future_ref_frame[0].frame].wmtype == ROTZOOM)
+        add_gm_ref_frames(&gm_ctx, future_ref_frame, 1, num_future_ref_frames);
+      if (gm_ctx.num_frames > 0)
+        compute_global_motion_for_references(cpi, &gm_ctx);
+    }
 
     cpi->global_motion_search_done = 1;
-    for (int m = 0; m < RANSAC_NUM_MOTIONS; m++) {
-      aom_free(params_by_motion[m].inliers);
-    }
   }
   memcpy(cm->cur_frame->global_motion, cm->global_motion,
          REF_FRAMES * sizeof(WarpedMotionParams));
@@ -13,6 +13,7 @@
 #define AOM_AV1_ENCODER_ENCODEFRAME_H_
 
 #include "aom/aom_integer.h"
+#include "aom_util/aom_atomics.h"
 #include "av1/common/blockd.h"
 #include "av1/common/enums.h"
 
@@ -42,6 +43,25 @@ void av1_encode_tile(struct AV1_COMP *cpi, struct ThreadData *td, int tile_row,
 void av1_encode_sb_row(struct AV1_COMP *cpi, struct ThreadData *td,
                        int tile_row, int tile_col, int mi_row);
 
+// The global motion search of a frame. Its references are independent, so the
+// threads searching them claim them one at a time.
+typedef struct GlobalMotionCtx {
+  struct yv12_buffer_config **ref_buf;
+  // The references to search.
+  MV_REFERENCE_FRAME frames[REF_FRAMES - 1];
+  int num_frames;
+  // The next reference to search.
+  aom_atomic_int next_frame;
+  // The 8-bit luma plane of the source, and its corners.
+  unsigned char *frm_buffer;
+  int *frm_corners;
+  int num_frm_corners;
+} GlobalMotionCtx;
+
+// Searches the global motion of the references of 'gm_ctx' not claimed by
+// another thread.
+void av1_compute_gm_for_refs(struct AV1_COMP *cpi, GlobalMotionCtx *gm_ctx);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -63,6 +63,7 @@
 #include "av1/encoder/hash_motion.h"
 #include "av1/encoder/mbgraph.h"
 #include "av1/encoder/pass2_strategy.h"
+#include "av1/encoder/pickcdef.h"
 #include "av1/encoder/picklpf.h"
 #include "av1/encoder/pickrst.h"
 #include "av1/encoder/random.h"
@@ -936,7 +937,17 @@ static void alloc_raw_frame_buffers(AV1_COMP *cpi) {
     cpi->lookahead = av1_lookahead_init(
         oxcf->width, oxcf->height, seq_params->subsampling_x,
         seq_params->subsampling_y, seq_params->use_highbitdepth,
-        oxcf->lag_in_frames, oxcf->border_in_pixels, is_scale);
+        seq_params->bit_depth, oxcf->lag_in_frames, oxcf->border_in_pixels,
+        is_scale);
+#if !CONFIG_REALTIME_ONLY
+    // With a lookahead, analyze the frames while earlier frames are encoded.
+    if (cpi->lookahead && oxcf->pass != 1 && oxcf->lag_in_frames > 0 &&
+        oxcf->max_threads > 1 &&
+        av1_lookahead_start_analysis(cpi->lookahead, cpi->thread_pool)) {
+      aom_internal_error(&cm->error, AOM_CODEC_ERROR,
+                         "Lookahead analysis thread creation failed");
+    }
+#endif  // !CONFIG_REALTIME_ONLY
   }
   if (!cpi->lookahead)
     aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
@@ -3454,6 +3465,9 @@ void av1_remove_compressor(AV1_COMP *cpi) {
   }
 #endif
   av1_row_mt_mem_dealloc(cpi);
+  av1_row_mt_sync_mem_dealloc(&cpi->tpl_row_mt_sync);
+  av1_row_mt_sync_mem_dealloc(&cpi->fp_row_mt_sync);
+  av1_free_motion_field_cache(&cpi->motion_field_cache);
   aom_free(cpi->tile_thr_data);
   aom_free(cpi->workers);
 
@@ -4576,7 +4590,7 @@ static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
     start_timing(cpi, cdef_time);
 #endif
     // Find CDEF parameters
-    av1_cdef_search(&cm->cur_frame->buf, cpi->source, cm, xd,
+    av1_cdef_search(cpi, &cm->cur_frame->buf, cpi->source, xd,
                     cpi->sf.cdef_pick_method, cpi->td.mb.rdmult);
 
     // Apply the filter
@@ -4603,9 +4617,9 @@ static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
         cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
         cm->rst_info[2].frame_restoration_type != RESTORE_NONE) {
       if (cpi->num_workers > 1)
-        av1_loop_restoration_filter_frame_mt(&cm->cur_frame->buf, cm, 0,
-                                             cpi->workers, cpi->num_workers,
-                                             &cpi->lr_row_sync, &cpi->lr_ctxt);
+        av1_loop_restoration_filter_frame_mt(
+            &cm->cur_frame->buf, cm, 0, cpi->workers, cpi->num_workers,
+            &cpi->lr_row_sync, &cpi->lr_ctxt, NULL, NULL);
       else
         av1_loop_restoration_filter_frame(&cm->cur_frame->buf, cm, 0,
                                           &cpi->lr_ctxt);
@@ -4653,7 +4667,7 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
                                0,
 #endif
                                cpi->workers, cpi->num_workers,
-                               &cpi->lf_row_sync);
+                               &cpi->lf_row_sync, NULL, NULL);
     else
       av1_loop_filter_frame(&cm->cur_frame->buf, cm, xd,
 #if CONFIG_LPF_MASK
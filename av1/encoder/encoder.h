@@ -36,6 +36,7 @@
 #include "av1/encoder/lookahead.h"
 #include "av1/encoder/mbgraph.h"
 #include "av1/encoder/mcomp.h"
+#include "av1/encoder/motion_field.h"
 #include "av1/encoder/ratectrl.h"
 #include "av1/encoder/rd.h"
 #include "av1/encoder/speed_features.h"
@@ -632,6 +633,8 @@ typedef struct ThreadData {
   uint8_t *tmp_obmc_bufs[2];
   int intrabc_used;
   int deltaq_used;
+  // The largest full-pel motion vector component written by this thread.
+  unsigned int max_mv_magnitude;
   FRAME_CONTEXT *tctx;
   MB_MODE_INFO_EXT *mbmi_ext;
 } ThreadData;
@@ -773,6 +776,12 @@ typedef struct AV1_COMP {
   uint8_t tpl_stats_block_mis_log2;  // block granularity of tpl score storage
   TplDepFrame tpl_stats_buffer[MAX_LENGTH_TPL_FRAME_STATS];
   TplDepFrame *tpl_frame;
+  // Synchronizes the block rows of the TPL model of a frame computed on
+  // several threads.
+  AV1RowMTSync tpl_row_mt_sync;
+  // The motion fields of the TPL model, reused when the same pair of source
+  // frames is searched again.
+  MotionFieldCache motion_field_cache;
 
   // For a still frame, this flag is set to 1 to skip partition search.
   int partition_search_skippable_frame;
@@ -888,6 +897,9 @@ typedef struct AV1_COMP {
   int tpl_gf_group_frames;
 
   TWO_PASS twopass;
+  // Synchronizes the macroblock rows of the first pass of a frame run on
+  // several threads.
+  AV1RowMTSync fp_row_mt_sync;
 
   GF_GROUP gf_group;
 
@@ -990,6 +1002,9 @@ typedef struct AV1_COMP {
   // Multi-threading
   int num_workers;
   AVxWorker *workers;
+  // Pool whose threads run the jobs of the workers, or NULL if the workers
+  // have threads of their own (AV1E_SET_THREAD_POOL).
+  AVxThreadPool *thread_pool;
   struct EncWorkerData *tile_thr_data;
   int existing_fb_idx_to_show;
   int is_arf_filter_off[MAX_INTERNAL_ARFS + 1];
@@ -10,10 +10,15 @@
  */
 
 #include "av1/encoder/av1_multi_thread.h"
+#include "av1/encoder/bitstream.h"
 #include "av1/encoder/encodeframe.h"
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/ethread.h"
+#include "av1/encoder/pickcdef.h"
+#include "av1/encoder/pickrst.h"
 #include "av1/encoder/rdopt.h"
+#include "av1/encoder/temporal_filter.h"
+#include "av1/encoder/tpl_model.h"
 #include "aom_dsp/aom_dsp_common.h"
 
 static AOM_INLINE void accumulate_rd_opt(ThreadData *td, ThreadData *td_t) {
@@ -411,6 +416,7 @@ static AOM_INLINE void create_enc_workers(AV1_COMP *cpi, int num_workers) {
     ++cpi->num_workers;
     winterface->init(worker);
     worker->thread_name = "aom enc worker";
+    worker->pool = cpi->thread_pool;
 
     thread_data->cpi = cpi;
     thread_data->thread_id = i;
@@ -616,12 +622,10 @@ void av1_encode_tiles_mt(AV1_COMP *cpi) {
     av1_alloc_tile_data(cpi);
 
   av1_init_tile_data(cpi);
-  // Only run once to create threads and allocate thread data.
-  if (cpi->num_workers == 0) {
-    create_enc_workers(cpi, num_workers);
-  } else {
-    num_workers = AOMMIN(num_workers, cpi->num_workers);
-  }
+  // Only run once to create threads and allocate thread data. All the
+  // threads are created, as the other passes may have more jobs than tiles.
+  if (cpi->num_workers == 0) create_enc_workers(cpi, cpi->oxcf.max_threads);
+  num_workers = AOMMIN(num_workers, cpi->num_workers);
   prepare_enc_workers(cpi, enc_worker_hook, num_workers);
   launch_enc_workers(cpi, num_workers);
   sync_enc_workers(cpi, num_workers);
@@ -705,12 +709,10 @@ void av1_encode_tiles_row_mt(AV1_COMP *cpi) {
     }
   }
 
-  // Only run once to create threads and allocate thread data.
-  if (cpi->num_workers == 0) {
-    create_enc_workers(cpi, num_workers);
-  } else {
-    num_workers = AOMMIN(num_workers, cpi->num_workers);
-  }
+  // Only run once to create threads and allocate thread data. All the
+  // threads are created, as the other passes may have more jobs than tiles.
+  if (cpi->num_workers == 0) create_enc_workers(cpi, cpi->oxcf.max_threads);
+  num_workers = AOMMIN(num_workers, cpi->num_workers);
   assign_tile_to_thread(multi_thread_ctxt, tile_cols * tile_rows, num_workers);
   prepare_enc_workers(cpi, enc_row_mt_worker_hook, num_workers);
   launch_enc_workers(cpi, num_workers);
@@ -718,3 +720,135 @@ void av1_encode_tiles_row_mt(AV1_COMP *cpi) {
   if (cm->delta_q_info.delta_lf_present_flag) update_delta_lf_for_row_mt(cpi);
   accumulate_counters_enc_workers(cpi, num_workers);
 }
+
+#if !CONFIG_REALTIME_ONLY
+static int tf_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  TemporalFilterCtx *const tf_ctx = (TemporalFilterCtx *)arg2;
+  av1_temporal_filter_rows(thread_data->cpi, thread_data->td, tf_ctx);
+  return 1;
+}
+
+static int fp_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  FirstPassCtx *const fp_ctx = (FirstPassCtx *)arg2;
+  av1_first_pass_rows(thread_data->cpi, thread_data->td, fp_ctx);
+  return 1;
+}
+
+static int tpl_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  TplFrameCtx *const tpl_ctx = (TplFrameCtx *)arg2;
+  av1_tpl_mc_flow_rows(thread_data->cpi, thread_data->td, tpl_ctx);
+  return 1;
+}
+#endif  // !CONFIG_REALTIME_ONLY
+
+static int cdef_worker_hook(void *arg1, void *arg2) {
+  (void)arg1;
+  av1_cdef_search_sbs((CdefSearchCtx *)arg2);
+  return 1;
+}
+
+static int rst_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  RestUnitStatsCtx *const ctx = (RestUnitStatsCtx *)arg2;
+  av1_compute_rest_unit_stats(ctx, ctx->tmpbufs[thread_data->start]);
+  return 1;
+}
+
+static int pack_tiles_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  PackTilesCtx *const ctx = (PackTilesCtx *)arg2;
+  av1_write_tiles_symbols(thread_data->cpi, thread_data->td, ctx);
+  return 1;
+}
+
+static int gm_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  GlobalMotionCtx *const gm_ctx = (GlobalMotionCtx *)arg2;
+  av1_compute_gm_for_refs(thread_data->cpi, gm_ctx);
+  return 1;
+}
+
+// Prepares the workers for a frame level pass which only uses the motion
+// search state and the prediction buffers of MACROBLOCK, copied from the
+// MACROBLOCK of the main thread.
+static AOM_INLINE void prepare_mb_workers(AV1_COMP *cpi, AVxWorkerHook hook,
+                                          void *data, int num_workers) {
+  for (int i = num_workers - 1; i >= 0; i--) {
+    AVxWorker *const worker = &cpi->workers[i];
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+
+    worker->hook = hook;
+    worker->data1 = thread_data;
+    worker->data2 = data;
+
+    if (thread_data->td != &cpi->td) {
+      thread_data->td->mb = cpi->td.mb;
+      thread_data->td->mb.tmp_conv_dst = thread_data->td->tmp_conv_dst;
+      thread_data->td->mb.e_mbd.tmp_conv_dst = thread_data->td->tmp_conv_dst;
+      for (int j = 0; j < 2; ++j) {
+        thread_data->td->mb.tmp_obmc_bufs[j] =
+            thread_data->td->tmp_obmc_bufs[j];
+        thread_data->td->mb.e_mbd.tmp_obmc_bufs[j] =
+            thread_data->td->tmp_obmc_bufs[j];
+      }
+    }
+  }
+}
+
+static AOM_INLINE void run_mb_workers(AV1_COMP *cpi, AVxWorkerHook hook,
+                                      void *data, int num_workers) {
+  // Only run once to create threads and allocate thread data. All the
+  // threads are created, as a pass may have fewer jobs than the tile encoding
+  // has threads.
+  if (cpi->num_workers == 0) create_enc_workers(cpi, cpi->oxcf.max_threads);
+  num_workers = AOMMIN(num_workers, cpi->num_workers);
+  prepare_mb_workers(cpi, hook, data, num_workers);
+  launch_enc_workers(cpi, num_workers);
+  sync_enc_workers(cpi, num_workers);
+}
+
+#if !CONFIG_REALTIME_ONLY
+void av1_temporal_filter_mt(AV1_COMP *cpi, TemporalFilterCtx *tf_ctx) {
+  run_mb_workers(cpi, tf_worker_hook, tf_ctx,
+                 AOMMIN(cpi->oxcf.max_threads, tf_ctx->mb_rows));
+}
+
+void av1_tpl_mc_flow_mt(AV1_COMP *cpi, TplFrameCtx *tpl_ctx) {
+  run_mb_workers(cpi, tpl_worker_hook, tpl_ctx,
+                 AOMMIN(cpi->oxcf.max_threads, tpl_ctx->mb_rows));
+}
+
+void av1_first_pass_mt(AV1_COMP *cpi, FirstPassCtx *fp_ctx) {
+  run_mb_workers(cpi, fp_worker_hook, fp_ctx,
+                 AOMMIN(cpi->oxcf.max_threads, cpi->common.mb_rows));
+}
+#endif  // !CONFIG_REALTIME_ONLY
+
+void av1_global_motion_mt(AV1_COMP *cpi, GlobalMotionCtx *gm_ctx) {
+  run_mb_workers(cpi, gm_worker_hook, gm_ctx,
+                 AOMMIN(cpi->oxcf.max_threads, gm_ctx->num_frames));
+}
+
+void av1_cdef_search_mt(AV1_COMP *cpi, CdefSearchCtx *ctx) {
+  run_mb_workers(cpi, cdef_worker_hook, ctx,
+                 AOMMIN(cpi->oxcf.max_threads, ctx->sb_count));
+}
+
+void av1_rest_unit_stats_mt(AV1_COMP *cpi, RestUnitStatsCtx *ctx) {
+  run_mb_workers(cpi, rst_worker_hook, ctx,
+                 AOMMIN(ctx->num_workers, ctx->num_units));
+}
+
+void av1_pack_tiles_mt(AV1_COMP *cpi, PackTilesCtx *ctx) {
+  const int num_workers = AOMMIN(cpi->oxcf.max_threads, ctx->num_tiles);
+  run_mb_workers(cpi, pack_tiles_worker_hook, ctx, num_workers);
+  // Each worker tracks the motion vectors it writes, merged here once they
+  // are all done.
+  for (int i = AOMMIN(num_workers, cpi->num_workers) - 1; i >= 0; i--) {
+    const ThreadData *const td = cpi->tile_thr_data[i].td;
+    cpi->max_mv_magnitude = AOMMAX(cpi->max_mv_magnitude, td->max_mv_magnitude);
+  }
+}
@@ -19,6 +19,13 @@ extern "C" {
 struct AV1_COMP;
 struct ThreadData;
 struct AV1RowMTSyncData;
+struct TemporalFilterCtx;
+struct FirstPassCtx;
+struct TplFrameCtx;
+struct GlobalMotionCtx;
+struct CdefSearchCtx;
+struct RestUnitStatsCtx;
+struct PackTilesCtx;
 
 typedef struct EncWorkerData {
   struct AV1_COMP *cpi;
@@ -44,6 +51,32 @@ void av1_row_mt_sync_mem_alloc(AV1RowMTSync *row_mt_sync, struct AV1Common *cm,
 void av1_encode_tiles_mt(struct AV1_COMP *cpi);
 void av1_encode_tiles_row_mt(struct AV1_COMP *cpi);
 
+// Filters the block rows of 'tf_ctx' on the encoder workers.
+void av1_temporal_filter_mt(struct AV1_COMP *cpi,
+                            struct TemporalFilterCtx *tf_ctx);
+
+// Computes the TPL model block rows of 'tpl_ctx' on the encoder workers.
+void av1_tpl_mc_flow_mt(struct AV1_COMP *cpi, struct TplFrameCtx *tpl_ctx);
+
+// Runs the first pass on the macroblock rows of 'fp_ctx' on the encoder
+// workers.
+void av1_first_pass_mt(struct AV1_COMP *cpi, struct FirstPassCtx *fp_ctx);
+
+// Searches the global motion of the references of 'gm_ctx' on the encoder
+// workers.
+void av1_global_motion_mt(struct AV1_COMP *cpi, struct GlobalMotionCtx *gm_ctx);
+
+// Searches the CDEF strengths of the filter blocks of 'ctx' on the encoder
+// workers.
+void av1_cdef_search_mt(struct AV1_COMP *cpi, struct CdefSearchCtx *ctx);
+
+// Derives the restoration filters of the units of 'ctx' on the encoder
+// workers.
+void av1_rest_unit_stats_mt(struct AV1_COMP *cpi, struct RestUnitStatsCtx *ctx);
+
+// Writes the symbols of the tiles of 'ctx' on the encoder workers.
+void av1_pack_tiles_mt(struct AV1_COMP *cpi, struct PackTilesCtx *ctx);
+
 void av1_accumulate_frame_counts(struct FRAME_COUNTS *acc_counts,
                                  const struct FRAME_COUNTS *counts);
 
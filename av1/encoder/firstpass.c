@@ -37,6 +37,7 @@
 #include "av1/encoder/encodemv.h"
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/encode_strategy.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/extend.h"
 #include "av1/encoder/firstpass.h"
 #include "av1/encoder/mcomp.h"
@@ -321,9 +322,10 @@ static double raw_motion_error_stdev(int *raw_motion_err_list,
 
 #define UL_INTRA_THRESH 50
 #define INVALID_ROW -1
-void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
+void av1_first_pass_rows(AV1_COMP *cpi, ThreadData *td,
+                         FirstPassCtx *fp_ctx) {
   int mb_row, mb_col;
-  MACROBLOCK *const x = &cpi->td.mb;
+  MACROBLOCK *const x = &td->mb;
   AV1_COMMON *const cm = &cpi->common;
   CurrentFrame *const current_frame = &cm->current_frame;
   const SequenceHeader *const seq_params = &cm->seq_params;
@@ -333,95 +335,20 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
   struct macroblock_plane *const p = x->plane;
   struct macroblockd_plane *const pd = xd->plane;
   const PICK_MODE_CONTEXT *ctx =
-      &cpi->td.pc_root[MAX_MIB_SIZE_LOG2 - MIN_MIB_SIZE_LOG2]->none;
+      &td->pc_root[MAX_MIB_SIZE_LOG2 - MIN_MIB_SIZE_LOG2]->none;
   int i;
 
   int recon_yoffset, src_yoffset, recon_uvoffset;
-  int64_t intra_error = 0;
-  int64_t frame_avg_wavelet_energy = 0;
-  int64_t coded_error = 0;
-  int64_t sr_coded_error = 0;
-  int64_t tr_coded_error = 0;
-
-  int sum_mvr = 0, sum_mvc = 0;
-  int sum_mvr_abs = 0, sum_mvc_abs = 0;
-  int64_t sum_mvrs = 0, sum_mvcs = 0;
-  int mvcount = 0;
-  int intercount = 0;
-  int second_ref_count = 0;
-  int third_ref_count = 0;
   const int intrapenalty = INTRA_MODE_PENALTY;
-  double neutral_count;
-  int intra_skip_count = 0;
-  int image_data_start_row = INVALID_ROW;
-  int new_mv_count = 0;
-  int sum_in_vectors = 0;
-  MV lastmv = kZeroMv;
-  TWO_PASS *twopass = &cpi->twopass;
   int recon_y_stride, src_y_stride, recon_uv_stride, uv_mb_height;
 
-  const YV12_BUFFER_CONFIG *const lst_yv12 =
-      get_ref_frame_yv12_buf(cm, LAST_FRAME);
-  const YV12_BUFFER_CONFIG *gld_yv12 = get_ref_frame_yv12_buf(cm, GOLDEN_FRAME);
-  const YV12_BUFFER_CONFIG *alt_yv12 = NULL;
-  const int alt_offset = 16 - (current_frame->frame_number % 16);
-  if (alt_offset < 16) {
-    const struct lookahead_entry *const alt_buf =
-        av1_lookahead_peek(cpi->lookahead, alt_offset);
-    if (alt_buf != NULL) {
-      alt_yv12 = &alt_buf->img;
-    }
-  }
+  const YV12_BUFFER_CONFIG *const lst_yv12 = fp_ctx->lst_yv12;
+  const YV12_BUFFER_CONFIG *const gld_yv12 = fp_ctx->gld_yv12;
+  const YV12_BUFFER_CONFIG *const alt_yv12 = fp_ctx->alt_yv12;
   YV12_BUFFER_CONFIG *const new_yv12 = &cm->cur_frame->buf;
-  double intra_factor;
-  double brightness_factor;
   const int qindex = find_fp_qindex(seq_params->bit_depth);
   const int mb_scale = mi_size_wide[BLOCK_16X16];
 
-  int *raw_motion_err_list;
-  int raw_motion_err_counts = 0;
-  CHECK_MEM_ERROR(
-      cm, raw_motion_err_list,
-      aom_calloc(cm->mb_rows * cm->mb_cols, sizeof(*raw_motion_err_list)));
-  // First pass code requires valid last and new frame buffers.
-  assert(new_yv12 != NULL);
-  assert(frame_is_intra_only(cm) || (lst_yv12 != NULL));
-
-  av1_setup_frame_size(cpi);
-  aom_clear_system_state();
-
-  xd->mi = cm->mi_grid_base;
-  xd->mi[0] = cm->mi;
-  x->e_mbd.mi[0]->sb_type = BLOCK_16X16;
-
-  intra_factor = 0.0;
-  brightness_factor = 0.0;
-  neutral_count = 0.0;
-
-  // Do not use periodic key frames.
-  cpi->rc.frames_to_key = INT_MAX;
-
-  av1_set_quantizer(cm, qindex);
-
-  av1_setup_block_planes(&x->e_mbd, seq_params->subsampling_x,
-                         seq_params->subsampling_y, num_planes);
-
-  av1_setup_src_planes(x, cpi->source, 0, 0, num_planes,
-                       x->e_mbd.mi[0]->sb_type);
-  av1_setup_dst_planes(xd->plane, seq_params->sb_size, new_yv12, 0, 0, 0,
-                       num_planes);
-
-  if (!frame_is_intra_only(cm)) {
-    av1_setup_pre_planes(xd, 0, lst_yv12, 0, 0, NULL, num_planes);
-  }
-
-  xd->mi = cm->mi_grid_base;
-  xd->mi[0] = cm->mi;
-
-  // Don't store luma on the fist pass since chroma is not computed
-  xd->cfl.store_y = 0;
-  av1_frame_init_quantizer(cpi);
-
   for (i = 0; i < num_planes; ++i) {
     p[i].coeff = ctx->coeff[i];
     p[i].qcoeff = ctx->qcoeff[i];
@@ -430,9 +357,6 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
     p[i].txb_entropy_ctx = ctx->txb_entropy_ctx[i];
   }
 
-  av1_init_mv_probs(cm);
-  av1_initialize_rd_consts(cpi);
-
   // Tiling is ignored in the first pass.
   av1_tile_init(&tile, cm, 0, 0);
   src_y_stride = cpi->source->y_stride;
@@ -440,9 +364,18 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
   recon_uv_stride = new_yv12->uv_stride;
   uv_mb_height = 16 >> (new_yv12->y_height > new_yv12->uv_height);
 
-  for (mb_row = 0; mb_row < cm->mb_rows; ++mb_row) {
+  while ((mb_row = aom_atomic_fetch_add(&fp_ctx->next_mb_row, 1)) <
+         cm->mb_rows) {
+    FirstPassRowStats *const stats = &fp_ctx->row_stats[mb_row];
+    int *const raw_motion_err_list =
+        fp_ctx->raw_motion_err_list + mb_row * cm->mb_cols;
     MV best_ref_mv = kZeroMv;
 
+    av1_zero(*stats);
+    stats->image_data_start_row = INVALID_ROW;
+    av1_setup_src_planes(x, cpi->source, mb_row * mb_scale, 0, num_planes,
+                         BLOCK_16X16);
+
     // Reset above block coeffs.
     xd->up_available = (mb_row != 0);
     recon_yoffset = (mb_row * recon_y_stride * 16);
@@ -466,6 +399,8 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
 
       aom_clear_system_state();
 
+      fp_ctx->sync_read(fp_ctx->row_mt_sync, mb_row, mb_col);
+
       const int grid_idx =
           get_mi_grid_idx(cm, mb_row * mb_scale, mb_col * mb_scale);
       const int mi_idx =
@@ -496,9 +431,10 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
       this_intra_error = aom_get_mb_ss(x->plane[0].src_diff);
 
       if (this_intra_error < UL_INTRA_THRESH) {
-        ++intra_skip_count;
-      } else if ((mb_col > 0) && (image_data_start_row == INVALID_ROW)) {
-        image_data_start_row = mb_row;
+        ++stats->intra_skip_count;
+      } else if ((mb_col > 0) &&
+                 (stats->image_data_start_row == INVALID_ROW)) {
+        stats->image_data_start_row = mb_row;
       }
 
       if (seq_params->use_highbitdepth) {
@@ -517,18 +453,19 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
       aom_clear_system_state();
       log_intra = log(this_intra_error + 1.0);
       if (log_intra < 10.0)
-        intra_factor += 1.0 + ((10.0 - log_intra) * 0.05);
+        stats->intra_factor += 1.0 + ((10.0 - log_intra) * 0.05);
       else
-        intra_factor += 1.0;
+        stats->intra_factor += 1.0;
 
       if (seq_params->use_highbitdepth)
         level_sample = CONVERT_TO_SHORTPTR(x->plane[0].src.buf)[0];
       else
         level_sample = x->plane[0].src.buf[0];
       if ((level_sample < DARK_THRESH) && (log_intra < 9.0))
-        brightness_factor += 1.0 + (0.01 * (DARK_THRESH - level_sample));
+        stats->brightness_factor +=
+            1.0 + (0.01 * (DARK_THRESH - level_sample));
       else
-        brightness_factor += 1.0;
+        stats->brightness_factor += 1.0;
 
       // Intrapenalty below deals with situations where the intra and inter
       // error scores are very low (e.g. a plain black frame).
@@ -540,14 +477,14 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
       this_intra_error += intrapenalty;
 
       // Accumulate the intra error.
-      intra_error += (int64_t)this_intra_error;
+      stats->intra_error += (int64_t)this_intra_error;
 
       const int hbd = is_cur_buf_hbd(xd);
       const int stride = x->plane[0].src.stride;
       uint8_t *buf = x->plane[0].src.buf;
       for (int r8 = 0; r8 < 2; ++r8) {
         for (int c8 = 0; c8 < 2; ++c8) {
-          frame_avg_wavelet_energy += av1_haar_ac_sad_8x8_uint8_input(
+          stats->frame_avg_wavelet_energy += av1_haar_ac_sad_8x8_uint8_input(
               buf + c8 * 8 + r8 * 8 * stride, stride, hbd);
         }
       }
@@ -637,7 +574,7 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
 
             if (gf_motion_error < motion_error &&
                 gf_motion_error < this_intra_error)
-              ++second_ref_count;
+              ++stats->second_ref_count;
 
             // Reset to last frame as reference buffer.
             xd->plane[0].pre[0].buf = lst_yv12->y_buffer + recon_yoffset;
@@ -649,12 +586,12 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
             // (just as will be done for) accumulation of "coded_error" for
             // the last frame.
             if (gf_motion_error < this_intra_error)
-              sr_coded_error += gf_motion_error;
+              stats->sr_coded_error += gf_motion_error;
             else
-              sr_coded_error += this_intra_error;
+              stats->sr_coded_error += this_intra_error;
           } else {
             gf_motion_error = motion_error;
-            sr_coded_error += motion_error;
+            stats->sr_coded_error += motion_error;
           }
 
           // Motion search in 3rd reference frame.
@@ -680,7 +617,7 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
             if (alt_motion_error < motion_error &&
                 alt_motion_error < gf_motion_error &&
                 alt_motion_error < this_intra_error)
-              ++third_ref_count;
+              ++stats->third_ref_count;
 
             // Reset to last frame as reference buffer.
             xd->plane[0].pre[0].buf = lst_yv12->y_buffer + recon_yoffset;
@@ -690,13 +627,14 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
             // best of the motion predicted score and the intra coded error
             // (just as will be done for) accumulation of "coded_error" for
             // the last frame.
-            tr_coded_error += AOMMIN(alt_motion_error, this_intra_error);
+            stats->tr_coded_error +=
+                AOMMIN(alt_motion_error, this_intra_error);
           } else {
-            tr_coded_error += motion_error;
+            stats->tr_coded_error += motion_error;
           }
         } else {
-          sr_coded_error += motion_error;
-          tr_coded_error += motion_error;
+          stats->sr_coded_error += motion_error;
+          stats->tr_coded_error += motion_error;
         }
 
         // Start by assuming that intra mode is best.
@@ -711,14 +649,15 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
           // cropped clips with black bars at the sides or top and bottom.
           if (((this_intra_error - intrapenalty) * 9 <= motion_error * 10) &&
               (this_intra_error < (2 * intrapenalty))) {
-            neutral_count += 1.0;
+            stats->neutral_count += 1.0;
             // Also track cases where the intra is not much worse than the inter
             // and use this in limiting the GF/arf group length.
           } else if ((this_intra_error > NCOUNT_INTRA_THRESH) &&
                      (this_intra_error <
                       (NCOUNT_INTRA_FACTOR * motion_error))) {
-            neutral_count += (double)motion_error /
-                             DOUBLE_DIVIDE_CHECK((double)this_intra_error);
+            stats->neutral_count +=
+                (double)motion_error /
+                DOUBLE_DIVIDE_CHECK((double)this_intra_error);
           }
 
           mv.row *= 8;
@@ -733,56 +672,58 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
                                         mb_col * mb_scale, NULL, bsize,
                                         AOM_PLANE_Y, AOM_PLANE_Y);
           av1_encode_sby_pass1(cm, x, bsize);
-          sum_mvr += mv.row;
-          sum_mvr_abs += abs(mv.row);
-          sum_mvc += mv.col;
-          sum_mvc_abs += abs(mv.col);
-          sum_mvrs += mv.row * mv.row;
-          sum_mvcs += mv.col * mv.col;
-          ++intercount;
+          stats->sum_mvr += mv.row;
+          stats->sum_mvr_abs += abs(mv.row);
+          stats->sum_mvc += mv.col;
+          stats->sum_mvc_abs += abs(mv.col);
+          stats->sum_mvrs += mv.row * mv.row;
+          stats->sum_mvcs += mv.col * mv.col;
+          ++stats->intercount;
 
           best_ref_mv = mv;
 
           if (!is_zero_mv(&mv)) {
-            ++mvcount;
+            if (++stats->mvcount == 1) stats->first_mv = mv;
 
             // Non-zero vector, was it different from the last non zero vector?
-            if (!is_equal_mv(&mv, &lastmv)) ++new_mv_count;
-            lastmv = mv;
+            if (!is_equal_mv(&mv, &stats->last_mv)) ++stats->new_mv_count;
+            stats->last_mv = mv;
 
             // Does the row vector point inwards or outwards?
             if (mb_row < cm->mb_rows / 2) {
               if (mv.row > 0)
-                --sum_in_vectors;
+                --stats->sum_in_vectors;
               else if (mv.row < 0)
-                ++sum_in_vectors;
+                ++stats->sum_in_vectors;
             } else if (mb_row > cm->mb_rows / 2) {
               if (mv.row > 0)
-                ++sum_in_vectors;
+                ++stats->sum_in_vectors;
               else if (mv.row < 0)
-                --sum_in_vectors;
+                --stats->sum_in_vectors;
             }
 
             // Does the col vector point inwards or outwards?
             if (mb_col < cm->mb_cols / 2) {
               if (mv.col > 0)
-                --sum_in_vectors;
+                --stats->sum_in_vectors;
               else if (mv.col < 0)
-                ++sum_in_vectors;
+                ++stats->sum_in_vectors;
             } else if (mb_col > cm->mb_cols / 2) {
               if (mv.col > 0)
-                ++sum_in_vectors;
+                ++stats->sum_in_vectors;
               else if (mv.col < 0)
-                --sum_in_vectors;
+                --stats->sum_in_vectors;
             }
           }
         }
-        raw_motion_err_list[raw_motion_err_counts++] = raw_motion_error;
+        raw_motion_err_list[mb_col] = raw_motion_error;
       } else {
-        sr_coded_error += (int64_t)this_intra_error;
-        tr_coded_error += (int64_t)this_intra_error;
+        stats->sr_coded_error += (int64_t)this_intra_error;
+        stats->tr_coded_error += (int64_t)this_intra_error;
       }
-      coded_error += (int64_t)this_intra_error;
+      stats->coded_error += (int64_t)this_intra_error;
+
+      fp_ctx->sync_write(fp_ctx->row_mt_sync, mb_row, mb_col, cm->mb_cols);
 
       // Adjust to the next column of MBs.
       x->plane[0].src.buf += 16;
@@ -794,15 +735,169 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
       recon_uvoffset += uv_mb_height;
       alt_yv12_yoffset += 16;
     }
-    // Adjust to the next row of MBs.
-    x->plane[0].src.buf += 16 * x->plane[0].src.stride - 16 * cm->mb_cols;
-    x->plane[1].src.buf +=
-        uv_mb_height * x->plane[1].src.stride - uv_mb_height * cm->mb_cols;
-    x->plane[2].src.buf +=
-        uv_mb_height * x->plane[1].src.stride - uv_mb_height * cm->mb_cols;
 
     aom_clear_system_state();
   }
+}
+
+void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
+  MACROBLOCK *const x = &cpi->td.mb;
+  AV1_COMMON *const cm = &cpi->common;
+  CurrentFrame *const current_frame = &cm->current_frame;
+  const SequenceHeader *const seq_params = &cm->seq_params;
+  const int num_planes = av1_num_planes(cm);
+  MACROBLOCKD *const xd = &x->e_mbd;
+  int i;
+
+  int64_t intra_error = 0;
+  int64_t frame_avg_wavelet_energy = 0;
+  int64_t coded_error = 0;
+  int64_t sr_coded_error = 0;
+  int64_t tr_coded_error = 0;
+
+  int sum_mvr = 0, sum_mvc = 0;
+  int sum_mvr_abs = 0, sum_mvc_abs = 0;
+  int64_t sum_mvrs = 0, sum_mvcs = 0;
+  int mvcount = 0;
+  int intercount = 0;
+  int second_ref_count = 0;
+  int third_ref_count = 0;
+  double neutral_count;
+  int intra_skip_count = 0;
+  int image_data_start_row = INVALID_ROW;
+  int new_mv_count = 0;
+  int sum_in_vectors = 0;
+  MV lastmv = kZeroMv;
+  TWO_PASS *twopass = &cpi->twopass;
+  FirstPassCtx fp_ctx;
+
+  const YV12_BUFFER_CONFIG *const lst_yv12 =
+      get_ref_frame_yv12_buf(cm, LAST_FRAME);
+  const YV12_BUFFER_CONFIG *gld_yv12 = get_ref_frame_yv12_buf(cm, GOLDEN_FRAME);
+  const YV12_BUFFER_CONFIG *alt_yv12 = NULL;
+  const int alt_offset = 16 - (current_frame->frame_number % 16);
+  if (alt_offset < 16) {
+    const struct lookahead_entry *const alt_buf =
+        av1_lookahead_peek(cpi->lookahead, alt_offset);
+    if (alt_buf != NULL) {
+      alt_yv12 = &alt_buf->img;
+    }
+  }
+  YV12_BUFFER_CONFIG *const new_yv12 = &cm->cur_frame->buf;
+  double intra_factor;
+  double brightness_factor;
+  const int qindex = find_fp_qindex(seq_params->bit_depth);
+
+  int *raw_motion_err_list;
+  const int raw_motion_err_counts =
+      frame_is_intra_only(cm) ? 0 : cm->mb_rows * cm->mb_cols;
+  CHECK_MEM_ERROR(
+      cm, raw_motion_err_list,
+      aom_calloc(cm->mb_rows * cm->mb_cols, sizeof(*raw_motion_err_list)));
+  CHECK_MEM_ERROR(cm, fp_ctx.row_stats,
+                  aom_calloc(cm->mb_rows, sizeof(*fp_ctx.row_stats)));
+  // First pass code requires valid last and new frame buffers.
+  assert(new_yv12 != NULL);
+  assert(frame_is_intra_only(cm) || (lst_yv12 != NULL));
+
+  av1_setup_frame_size(cpi);
+  aom_clear_system_state();
+
+  xd->mi = cm->mi_grid_base;
+  xd->mi[0] = cm->mi;
+  x->e_mbd.mi[0]->sb_type = BLOCK_16X16;
+
+  intra_factor = 0.0;
+  brightness_factor = 0.0;
+  neutral_count = 0.0;
+
+  // Do not use periodic key frames.
+  cpi->rc.frames_to_key = INT_MAX;
+
+  av1_set_quantizer(cm, qindex);
+
+  av1_setup_block_planes(&x->e_mbd, seq_params->subsampling_x,
+                         seq_params->subsampling_y, num_planes);
+
+  av1_setup_src_planes(x, cpi->source, 0, 0, num_planes,
+                       x->e_mbd.mi[0]->sb_type);
+  av1_setup_dst_planes(xd->plane, seq_params->sb_size, new_yv12, 0, 0, 0,
+                       num_planes);
+
+  if (!frame_is_intra_only(cm)) {
+    av1_setup_pre_planes(xd, 0, lst_yv12, 0, 0, NULL, num_planes);
+  }
+
+  xd->mi = cm->mi_grid_base;
+  xd->mi[0] = cm->mi;
+
+  // Don't store luma on the fist pass since chroma is not computed
+  xd->cfl.store_y = 0;
+  av1_frame_init_quantizer(cpi);
+
+  av1_init_mv_probs(cm);
+  av1_initialize_rd_consts(cpi);
+
+  fp_ctx.lst_yv12 = lst_yv12;
+  fp_ctx.gld_yv12 = gld_yv12;
+  fp_ctx.alt_yv12 = alt_yv12;
+  fp_ctx.raw_motion_err_list = raw_motion_err_list;
+  aom_atomic_init(&fp_ctx.next_mb_row, 0);
+  if (cpi->oxcf.max_threads > 1 && cm->mb_rows > 1) {
+    AV1RowMTSync *const row_mt_sync = &cpi->fp_row_mt_sync;
+    if (row_mt_sync->rows != cm->mb_rows) {
+      av1_row_mt_sync_mem_dealloc(row_mt_sync);
+      av1_row_mt_sync_mem_alloc(row_mt_sync, cm, cm->mb_rows);
+    }
+    memset(row_mt_sync->cur_col, -1,
+           sizeof(*row_mt_sync->cur_col) * cm->mb_rows);
+    fp_ctx.row_mt_sync = row_mt_sync;
+    fp_ctx.sync_read = av1_row_mt_sync_read;
+    fp_ctx.sync_write = av1_row_mt_sync_write;
+    av1_first_pass_mt(cpi, &fp_ctx);
+  } else {
+    fp_ctx.row_mt_sync = NULL;
+    fp_ctx.sync_read = av1_row_mt_sync_read_dummy;
+    fp_ctx.sync_write = av1_row_mt_sync_write_dummy;
+    av1_first_pass_rows(cpi, &cpi->td, &fp_ctx);
+  }
+
+  // Merge the row statistics in row order, so that they do not depend on the
+  // number of threads.
+  for (i = 0; i < cm->mb_rows; ++i) {
+    const FirstPassRowStats *const stats = &fp_ctx.row_stats[i];
+    intra_error += stats->intra_error;
+    frame_avg_wavelet_energy += stats->frame_avg_wavelet_energy;
+    coded_error += stats->coded_error;
+    sr_coded_error += stats->sr_coded_error;
+    tr_coded_error += stats->tr_coded_error;
+    sum_mvr += stats->sum_mvr;
+    sum_mvc += stats->sum_mvc;
+    sum_mvr_abs += stats->sum_mvr_abs;
+    sum_mvc_abs += stats->sum_mvc_abs;
+    sum_mvrs += stats->sum_mvrs;
+    sum_mvcs += stats->sum_mvcs;
+    intercount += stats->intercount;
+    second_ref_count += stats->second_ref_count;
+    third_ref_count += stats->third_ref_count;
+    neutral_count += stats->neutral_count;
+    intra_factor += stats->intra_factor;
+    brightness_factor += stats->brightness_factor;
+    intra_skip_count += stats->intra_skip_count;
+    if (image_data_start_row == INVALID_ROW)
+      image_data_start_row = stats->image_data_start_row;
+    sum_in_vectors += stats->sum_in_vectors;
+    new_mv_count += stats->new_mv_count;
+    if (stats->mvcount > 0) {
+      // The first non-zero vector of the row was counted as new against the
+      // zero vector, and may be the last one of the rows above.
+      if (is_equal_mv(&stats->first_mv, &lastmv)) --new_mv_count;
+      lastmv = stats->last_mv;
+      mvcount += stats->mvcount;
+    }
+  }
+  aom_free(fp_ctx.row_stats);
+
   const double raw_err_stdev =
       raw_motion_error_stdev(raw_motion_err_list, raw_motion_err_counts);
   aom_free(raw_motion_err_list);
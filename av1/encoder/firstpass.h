@@ -12,6 +12,7 @@
 #ifndef AOM_AV1_ENCODER_FIRSTPASS_H_
 #define AOM_AV1_ENCODER_FIRSTPASS_H_
 
+#include "aom_util/aom_atomics.h"
 #include "av1/common/enums.h"
 #include "av1/common/onyxc_int.h"
 #include "av1/encoder/lookahead.h"
@@ -179,10 +180,59 @@ typedef struct {
 struct AV1_COMP;
 struct EncodeFrameParams;
 struct AV1EncoderConfig;
+struct AV1RowMTSyncData;
+struct ThreadData;
+
+// First pass statistics of a macroblock row.
+typedef struct {
+  int64_t intra_error;
+  int64_t frame_avg_wavelet_energy;
+  int64_t coded_error;
+  int64_t sr_coded_error;
+  int64_t tr_coded_error;
+  int sum_mvr, sum_mvc;
+  int sum_mvr_abs, sum_mvc_abs;
+  int64_t sum_mvrs, sum_mvcs;
+  int mvcount;
+  int intercount;
+  int second_ref_count;
+  int third_ref_count;
+  double neutral_count;
+  double intra_factor;
+  double brightness_factor;
+  int intra_skip_count;
+  int image_data_start_row;
+  int new_mv_count;
+  int sum_in_vectors;
+  // First and last non-zero motion vectors of the row.
+  MV first_mv;
+  MV last_mv;
+} FirstPassRowStats;
+
+// The first pass of a frame. The threads running it claim its macroblock
+// rows one at a time, and a macroblock waits for the macroblocks above and
+// above right, whose reconstruction its intra prediction uses.
+typedef struct FirstPassCtx {
+  const YV12_BUFFER_CONFIG *lst_yv12;
+  const YV12_BUFFER_CONFIG *gld_yv12;
+  const YV12_BUFFER_CONFIG *alt_yv12;
+  // The next macroblock row to process.
+  aom_atomic_int next_mb_row;
+  FirstPassRowStats *row_stats;
+  // The (0, 0) motion errors of the macroblocks, in raster order.
+  int *raw_motion_err_list;
+  struct AV1RowMTSyncData *row_mt_sync;
+  void (*sync_read)(struct AV1RowMTSyncData *const, int, int);
+  void (*sync_write)(struct AV1RowMTSyncData *const, int, int, const int);
+} FirstPassCtx;
 
 void av1_init_first_pass(struct AV1_COMP *cpi);
 void av1_rc_get_first_pass_params(struct AV1_COMP *cpi);
 void av1_first_pass(struct AV1_COMP *cpi, const int64_t ts_duration);
+// Processes the macroblock rows of 'fp_ctx' not claimed by another thread,
+// using the MACROBLOCK of 'td'.
+void av1_first_pass_rows(struct AV1_COMP *cpi, struct ThreadData *td,
+                         FirstPassCtx *fp_ctx);
 void av1_end_first_pass(struct AV1_COMP *cpi);
 
 void av1_twopass_zero_stats(FIRSTPASS_STATS *section);
@@ -423,33 +423,34 @@ void av1_compute_feature_segmentation_map(uint8_t *segment_map, int width,
 static int compute_global_motion_feature_based(
     TransformationType type, unsigned char *frm_buffer, int frm_width,
     int frm_height, int frm_stride, int *frm_corners, int num_frm_corners,
-    YV12_BUFFER_CONFIG *ref, int bit_depth, int *num_inliers_by_motion,
+    YV12_BUFFER_CONFIG *ref, int bit_depth,
+    GlobalMotionCorrespondences *corrs, int *num_inliers_by_motion,
     MotionModel *params_by_motion, int num_motions) {
   int i;
-  int num_ref_corners;
-  int num_correspondences;
-  int *correspondences;
-  int ref_corners[2 * MAX_CORNERS];
-  unsigned char *ref_buffer = ref->y_buffer;
   RansacFunc ransac = av1_get_ransac_type(type);
 
-  if (ref->flags & YV12_FLAG_HIGHBITDEPTH) {
-    ref_buffer = av1_downconvert_frame(ref, bit_depth);
-  }
-
-  num_ref_corners =
-      av1_fast_corner_detect(ref_buffer, ref->y_width, ref->y_height,
-                             ref->y_stride, ref_corners, MAX_CORNERS);
+  if (corrs->num_correspondences < 0) {
+    int ref_corners[2 * MAX_CORNERS];
+    unsigned char *ref_buffer = ref->y_buffer;
+    if (ref->flags & YV12_FLAG_HIGHBITDEPTH) {
+      ref_buffer = av1_downconvert_frame(ref, bit_depth);
+    }
 
-  // find correspondences between the two images
-  correspondences =
-      (int *)malloc(num_frm_corners * 4 * sizeof(*correspondences));
-  num_correspondences = av1_determine_correspondence(
-      frm_buffer, (int *)frm_corners, num_frm_corners, ref_buffer,
-      (int *)ref_corners, num_ref_corners, frm_width, frm_height, frm_stride,
-      ref->y_stride, correspondences);
+    const int num_ref_corners =
+        av1_fast_corner_detect(ref_buffer, ref->y_width, ref->y_height,
+                               ref->y_stride, ref_corners, MAX_CORNERS);
+
+    // find correspondences between the two images
+    corrs->correspondences = (int *)aom_malloc(
+        num_frm_corners * 4 * sizeof(*corrs->correspondences));
+    corrs->num_correspondences = av1_determine_correspondence(
+        frm_buffer, (int *)frm_corners, num_frm_corners, ref_buffer,
+        (int *)ref_corners, num_ref_corners, frm_width, frm_height, frm_stride,
+        ref->y_stride, corrs->correspondences);
+  }
+  const int num_correspondences = corrs->num_correspondences;
 
-  ransac(correspondences, num_correspondences, num_inliers_by_motion,
+  ransac(corrs->correspondences, num_correspondences, num_inliers_by_motion,
          params_by_motion, num_motions);
 
   // Set num_inliers = 0 for motions with too few inliers so they are ignored.
@@ -458,12 +459,10 @@ static int compute_global_motion_feature_based(
         num_correspondences == 0) {
       num_inliers_by_motion[i] = 0;
     } else {
-      get_inliers_from_indices(&params_by_motion[i], correspondences);
+      get_inliers_from_indices(&params_by_motion[i], corrs->correspondences);
     }
   }
 
-  free(correspondences);
-
   // Return true if any one of the motions has inliers.
   for (i = 0; i < num_motions; ++i) {
     if (num_inliers_by_motion[i] > 0) return 1;
@@ -910,71 +909,76 @@ static void compute_flow_field(ImagePyramid *frm_pyr, ImagePyramid *ref_pyr,
 static int compute_global_motion_disflow_based(
     TransformationType type, unsigned char *frm_buffer, int frm_width,
     int frm_height, int frm_stride, int *frm_corners, int num_frm_corners,
-    YV12_BUFFER_CONFIG *ref, int bit_depth, int *num_inliers_by_motion,
+    YV12_BUFFER_CONFIG *ref, int bit_depth,
+    GlobalMotionCorrespondences *corrs, int *num_inliers_by_motion,
     MotionModel *params_by_motion, int num_motions) {
-  unsigned char *ref_buffer = ref->y_buffer;
-  const int ref_width = ref->y_width;
-  const int ref_height = ref->y_height;
-  const int pad_size = AOMMAX(PATCH_SIZE, MIN_PAD);
-  int num_correspondences;
-  double *correspondences;
   RansacFuncDouble ransac = av1_get_ransac_double_prec_type(type);
-  assert(frm_width == ref_width);
-  assert(frm_height == ref_height);
-
-  // Ensure the number of pyramid levels will work with the frame resolution
-  const int msb =
-      frm_width < frm_height ? get_msb(frm_width) : get_msb(frm_height);
-  const int n_levels = AOMMIN(msb, N_LEVELS);
-
-  if (ref->flags & YV12_FLAG_HIGHBITDEPTH) {
-    ref_buffer = av1_downconvert_frame(ref, bit_depth);
-  }
-
-  // TODO(sarahparker) We will want to do the source pyramid computation
-  // outside of this function so it doesn't get recomputed for every
-  // reference. We also don't need to compute every pyramid level for the
-  // reference in advance, since lower levels can be overwritten once their
-  // flow field is computed and upscaled. I'll add these optimizations
-  // once the full implementation is working.
-  // Allocate frm image pyramids
-  int compute_gradient = 1;
-  ImagePyramid *frm_pyr =
-      alloc_pyramid(frm_width, frm_height, pad_size, compute_gradient);
-  compute_flow_pyramids(frm_buffer, frm_width, frm_height, frm_stride, n_levels,
-                        pad_size, compute_gradient, frm_pyr);
-  // Allocate ref image pyramids
-  compute_gradient = 0;
-  ImagePyramid *ref_pyr =
-      alloc_pyramid(ref_width, ref_height, pad_size, compute_gradient);
-  compute_flow_pyramids(ref_buffer, ref_width, ref_height, ref->y_stride,
-                        n_levels, pad_size, compute_gradient, ref_pyr);
-
-  double *flow_u =
-      aom_malloc(frm_pyr->strides[0] * frm_pyr->heights[0] * sizeof(*flow_u));
-  double *flow_v =
-      aom_malloc(frm_pyr->strides[0] * frm_pyr->heights[0] * sizeof(*flow_v));
 
-  memset(flow_u, 0,
-         frm_pyr->strides[0] * frm_pyr->heights[0] * sizeof(*flow_u));
-  memset(flow_v, 0,
-         frm_pyr->strides[0] * frm_pyr->heights[0] * sizeof(*flow_v));
+  if (corrs->num_correspondences < 0) {
+    unsigned char *ref_buffer = ref->y_buffer;
+    const int ref_width = ref->y_width;
+    const int ref_height = ref->y_height;
+    const int pad_size = AOMMAX(PATCH_SIZE, MIN_PAD);
+    assert(frm_width == ref_width);
+    assert(frm_height == ref_height);
+
+    // Ensure the number of pyramid levels will work with the frame resolution
+    const int msb =
+        frm_width < frm_height ? get_msb(frm_width) : get_msb(frm_height);
+    const int n_levels = AOMMIN(msb, N_LEVELS);
+
+    if (ref->flags & YV12_FLAG_HIGHBITDEPTH) {
+      ref_buffer = av1_downconvert_frame(ref, bit_depth);
+    }
 
-  compute_flow_field(frm_pyr, ref_pyr, flow_u, flow_v);
+    // TODO(sarahparker) We will want to do the source pyramid computation
+    // outside of this function so it doesn't get recomputed for every
+    // reference. We also don't need to compute every pyramid level for the
+    // reference in advance, since lower levels can be overwritten once their
+    // flow field is computed and upscaled. I'll add these optimizations
+    // once the full implementation is working.
+    // Allocate frm image pyramids
+    int compute_gradient = 1;
+    ImagePyramid *frm_pyr =
+        alloc_pyramid(frm_width, frm_height, pad_size, compute_gradient);
+    compute_flow_pyramids(frm_buffer, frm_width, frm_height, frm_stride,
+                          n_levels, pad_size, compute_gradient, frm_pyr);
+    // Allocate ref image pyramids
+    compute_gradient = 0;
+    ImagePyramid *ref_pyr =
+        alloc_pyramid(ref_width, ref_height, pad_size, compute_gradient);
+    compute_flow_pyramids(ref_buffer, ref_width, ref_height, ref->y_stride,
+                          n_levels, pad_size, compute_gradient, ref_pyr);
+
+    double *flow_u = aom_malloc(frm_pyr->strides[0] * frm_pyr->heights[0] *
+                                sizeof(*flow_u));
+    double *flow_v = aom_malloc(frm_pyr->strides[0] * frm_pyr->heights[0] *
+                                sizeof(*flow_v));
+
+    memset(flow_u, 0,
+           frm_pyr->strides[0] * frm_pyr->heights[0] * sizeof(*flow_u));
+    memset(flow_v, 0,
+           frm_pyr->strides[0] * frm_pyr->heights[0] * sizeof(*flow_v));
+
+    compute_flow_field(frm_pyr, ref_pyr, flow_u, flow_v);
+
+    // find correspondences between the two images using the flow field
+    corrs->correspondences_double = aom_malloc(
+        num_frm_corners * 4 * sizeof(*corrs->correspondences_double));
+    corrs->num_correspondences = determine_disflow_correspondence(
+        frm_corners, num_frm_corners, flow_u, flow_v, frm_width, frm_height,
+        frm_pyr->strides[0], corrs->correspondences_double);
+
+    free_pyramid(frm_pyr);
+    free_pyramid(ref_pyr);
+    aom_free(flow_u);
+    aom_free(flow_v);
+  }
+  const int num_correspondences = corrs->num_correspondences;
 
-  // find correspondences between the two images using the flow field
-  correspondences = aom_malloc(num_frm_corners * 4 * sizeof(*correspondences));
-  num_correspondences = determine_disflow_correspondence(
-      frm_corners, num_frm_corners, flow_u, flow_v, frm_width, frm_height,
-      frm_pyr->strides[0], correspondences);
-  ransac(correspondences, num_correspondences, num_inliers_by_motion,
-         params_by_motion, num_motions);
+  ransac(corrs->correspondences_double, num_correspondences,
+         num_inliers_by_motion, params_by_motion, num_motions);
 
-  free_pyramid(frm_pyr);
-  free_pyramid(ref_pyr);
-  aom_free(correspondences);
-  aom_free(flow_u);
-  aom_free(flow_v);
   // Set num_inliers = 0 for motions with too few inliers so they are ignored.
   for (int i = 0; i < num_motions; ++i) {
     if (num_inliers_by_motion[i] < MIN_INLIER_PROB * num_correspondences) {
@@ -989,24 +993,37 @@ static int compute_global_motion_disflow_based(
   return 0;
 }
 
+void av1_init_gm_correspondences(GlobalMotionCorrespondences *corrs) {
+  corrs->num_correspondences = -1;
+  corrs->correspondences = NULL;
+  corrs->correspondences_double = NULL;
+}
+
+void av1_free_gm_correspondences(GlobalMotionCorrespondences *corrs) {
+  aom_free(corrs->correspondences);
+  aom_free(corrs->correspondences_double);
+  av1_init_gm_correspondences(corrs);
+}
+
 int av1_compute_global_motion(TransformationType type,
                               unsigned char *frm_buffer, int frm_width,
                               int frm_height, int frm_stride, int *frm_corners,
                               int num_frm_corners, YV12_BUFFER_CONFIG *ref,
                               int bit_depth,
                               GlobalMotionEstimationType gm_estimation_type,
+                              GlobalMotionCorrespondences *corrs,
                               int *num_inliers_by_motion,
                               MotionModel *params_by_motion, int num_motions) {
   switch (gm_estimation_type) {
     case GLOBAL_MOTION_FEATURE_BASED:
       return compute_global_motion_feature_based(
           type, frm_buffer, frm_width, frm_height, frm_stride, frm_corners,
-          num_frm_corners, ref, bit_depth, num_inliers_by_motion,
+          num_frm_corners, ref, bit_depth, corrs, num_inliers_by_motion,
           params_by_motion, num_motions);
     case GLOBAL_MOTION_DISFLOW_BASED:
       return compute_global_motion_disflow_based(
           type, frm_buffer, frm_width, frm_height, frm_stride, frm_corners,
-          num_frm_corners, ref, bit_depth, num_inliers_by_motion,
+          num_frm_corners, ref, bit_depth, corrs, num_inliers_by_motion,
           params_by_motion, num_motions);
     default: assert(0 && "Unknown global motion estimation type");
   }
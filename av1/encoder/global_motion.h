@@ -30,6 +30,22 @@ typedef enum {
   GLOBAL_MOTION_DISFLOW_BASED,
 } GlobalMotionEstimationType;
 
+// The correspondences between the corners of a frame and points of a
+// reference, as x, y, reference x and reference y. They do not depend on the
+// motion model, so the first av1_compute_global_motion() call for the pair
+// computes them and the calls for the other models reuse them.
+typedef struct {
+  // -1 until computed.
+  int num_correspondences;
+  // Used by the feature based estimation.
+  int *correspondences;
+  // Used by the disflow based estimation.
+  double *correspondences_double;
+} GlobalMotionCorrespondences;
+
+void av1_init_gm_correspondences(GlobalMotionCorrespondences *corrs);
+void av1_free_gm_correspondences(GlobalMotionCorrespondences *corrs);
+
 unsigned char *av1_downconvert_frame(YV12_BUFFER_CONFIG *frm, int bit_depth);
 
 typedef struct {
@@ -86,6 +102,10 @@ int64_t av1_refine_integerized_param(
   "num_inliers" should be length "num_motions", and will be populated with the
   number of inlier feature points for each motion. Params for which the
   num_inliers entry is 0 should be ignored by the caller.
+
+  "corrs" caches the correspondences of the pair of frames. It should be
+  initialized with av1_init_gm_correspondences() and passed to all the calls
+  for the pair.
 */
 int av1_compute_global_motion(TransformationType type,
                               unsigned char *frm_buffer, int frm_width,
@@ -93,6 +113,7 @@ int av1_compute_global_motion(TransformationType type,
                               int num_frm_corners, YV12_BUFFER_CONFIG *ref,
                               int bit_depth,
                               GlobalMotionEstimationType gm_estimation_type,
+                              GlobalMotionCorrespondences *corrs,
                               int *num_inliers_by_motion,
                               MotionModel *params_by_motion, int num_motions);
 #ifdef __cplusplus
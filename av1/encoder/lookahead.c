@@ -17,6 +17,7 @@
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/extend.h"
 #include "av1/encoder/lookahead.h"
+#include "av1/encoder/temporal_filter.h"
 
 /* Return the buffer at the given absolute index and increment the index */
 static struct lookahead_entry *pop(struct lookahead_ctx *ctx, int *idx) {
@@ -29,8 +30,38 @@ static struct lookahead_entry *pop(struct lookahead_ctx *ctx, int *idx) {
   return buf;
 }
 
+static void analyze_buffer(const struct lookahead_ctx *ctx,
+                           struct lookahead_entry *buf) {
+#if CONFIG_REALTIME_ONLY
+  // The noise level is only used by the key frame filtering.
+  (void)ctx;
+  buf->stats.noise_level = 0;
+#else
+  const YV12_BUFFER_CONFIG *const img = &buf->img;
+  if (img->flags & YV12_FLAG_HIGHBITDEPTH) {
+    buf->stats.noise_level = highbd_estimate_noise(
+        img->y_buffer, img->y_crop_width, img->y_crop_height, img->y_stride,
+        ctx->bit_depth, EDGE_THRESHOLD);
+  } else {
+    buf->stats.noise_level =
+        estimate_noise(img->y_buffer, img->y_crop_width, img->y_crop_height,
+                       img->y_stride, EDGE_THRESHOLD);
+  }
+#endif  // CONFIG_REALTIME_ONLY
+  buf->stats_ready = 1;
+}
+
+static int analysis_worker_hook(void *arg1, void *arg2) {
+  analyze_buffer((const struct lookahead_ctx *)arg1,
+                 (struct lookahead_entry *)arg2);
+  return 1;
+}
+
 void av1_lookahead_destroy(struct lookahead_ctx *ctx) {
   if (ctx) {
+    if (ctx->analysis_started) {
+      aom_get_worker_interface()->end(&ctx->analysis_worker);
+    }
     if (ctx->buf) {
       int i;
 
@@ -43,8 +74,8 @@ void av1_lookahead_destroy(struct lookahead_ctx *ctx) {
 
 struct lookahead_ctx *av1_lookahead_init(
     unsigned int width, unsigned int height, unsigned int subsampling_x,
-    unsigned int subsampling_y, int use_highbitdepth, unsigned int depth,
-    const int border_in_pixels, int is_scale) {
+    unsigned int subsampling_y, int use_highbitdepth, int bit_depth,
+    unsigned int depth, const int border_in_pixels, int is_scale) {
   struct lookahead_ctx *ctx = NULL;
 
   // Clamp the lookahead queue depth
@@ -59,6 +90,7 @@ struct lookahead_ctx *av1_lookahead_init(
     const int legacy_byte_alignment = 0;
     unsigned int i;
     ctx->max_sz = depth;
+    ctx->bit_depth = bit_depth;
     ctx->buf = calloc(depth, sizeof(*ctx->buf));
     if (!ctx->buf) goto fail;
     for (i = 0; i < depth; i++)
@@ -82,6 +114,26 @@ fail:
   return NULL;
 }
 
+int av1_lookahead_start_analysis(struct lookahead_ctx *ctx,
+                                 AVxThreadPool *pool) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  AVxWorker *const worker = &ctx->analysis_worker;
+
+  if (ctx->analysis_started) return 0;
+  winterface->init(worker);
+  worker->thread_name = "aom lookahead";
+  worker->pool = pool;
+  worker->hook = analysis_worker_hook;
+  worker->data1 = ctx;
+  worker->data2 = NULL;
+  if (!winterface->reset(worker)) {
+    winterface->end(worker);
+    return 1;
+  }
+  ctx->analysis_started = 1;
+  return 0;
+}
+
 #define USE_PARTIAL_COPY 0
 
 int av1_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
@@ -102,6 +154,10 @@ int av1_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
   int larger_dimensions, new_dimensions;
 
   if (ctx->sz + 1 + MAX_PRE_FRAMES > ctx->max_sz) return 1;
+  // The buffer may still be analyzed.
+  if (ctx->analysis_started) {
+    aom_get_worker_interface()->sync(&ctx->analysis_worker);
+  }
   ctx->sz++;
   buf = pop(ctx, &ctx->write_idx);
 
@@ -180,6 +236,11 @@ int av1_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
   buf->ts_start = ts_start;
   buf->ts_end = ts_end;
   buf->flags = flags;
+  buf->stats_ready = 0;
+  if (ctx->analysis_started) {
+    ctx->analysis_worker.data2 = buf;
+    aom_get_worker_interface()->launch(&ctx->analysis_worker);
+  }
   return 0;
 }
 
@@ -217,4 +278,21 @@ struct lookahead_entry *av1_lookahead_peek(struct lookahead_ctx *ctx,
   return buf;
 }
 
+struct lookahead_entry *av1_lookahead_find(struct lookahead_ctx *ctx,
+                                           const YV12_BUFFER_CONFIG *img) {
+  for (int i = 0; i < ctx->max_sz; ++i) {
+    if (&ctx->buf[i].img == img) return &ctx->buf[i];
+  }
+  return NULL;
+}
+
 unsigned int av1_lookahead_depth(struct lookahead_ctx *ctx) { return ctx->sz; }
+
+const struct lookahead_stats *av1_lookahead_get_stats(
+    struct lookahead_ctx *ctx, struct lookahead_entry *buf) {
+  if (ctx->analysis_started && ctx->analysis_worker.data2 == buf) {
+    aom_get_worker_interface()->sync(&ctx->analysis_worker);
+  }
+  if (!buf->stats_ready) analyze_buffer(ctx, buf);
+  return &buf->stats;
+}
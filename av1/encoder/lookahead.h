@@ -13,7 +13,9 @@
 #define AOM_AV1_ENCODER_LOOKAHEAD_H_
 
 #include "aom_scale/yv12config.h"
+#include "aom/aom_encoder.h"
 #include "aom/aom_integer.h"
+#include "aom_util/aom_thread.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,11 +23,19 @@ extern "C" {
 
 #define MAX_LAG_BUFFERS 25
 
+// Statistics of a frame computed by the analysis stage of the lookahead.
+struct lookahead_stats {
+  // Noise level of the luma plane, negative if it cannot be estimated.
+  double noise_level;
+};
+
 struct lookahead_entry {
   YV12_BUFFER_CONFIG img;
   int64_t ts_start;
   int64_t ts_end;
   aom_enc_frame_flags_t flags;
+  struct lookahead_stats stats;
+  int stats_ready;
 };
 
 // The max of past frames we want to keep in the queue.
@@ -37,6 +47,9 @@ struct lookahead_ctx {
   int read_idx;                /* Read index */
   int write_idx;               /* Write index */
   struct lookahead_entry *buf; /* Buffer list */
+  int bit_depth;               /* Bit depth of the frames */
+  int analysis_started;        /* Analysis runs on analysis_worker */
+  AVxWorker analysis_worker;   /* Analyzes the last enqueued buffer */
 };
 
 /**\brief Initializes the lookahead stage
@@ -46,8 +59,22 @@ struct lookahead_ctx {
  */
 struct lookahead_ctx *av1_lookahead_init(
     unsigned int width, unsigned int height, unsigned int subsampling_x,
-    unsigned int subsampling_y, int use_highbitdepth, unsigned int depth,
-    const int border_in_pixels, int is_scale);
+    unsigned int subsampling_y, int use_highbitdepth, int bit_depth,
+    unsigned int depth, const int border_in_pixels, int is_scale);
+
+/**\brief Starts the analysis stage on its own thread
+ *
+ * The statistics of each enqueued buffer are then computed on the thread,
+ * while the encoder works on earlier frames. Otherwise they are computed
+ * when they are first requested.
+ *
+ * \param[in] ctx         Pointer to the lookahead context
+ * \param[in] pool        Thread pool to run the analysis on, or NULL
+ *
+ * \retval 0, if the thread could be started
+ */
+int av1_lookahead_start_analysis(struct lookahead_ctx *ctx,
+                                 AVxThreadPool *pool);
 
 /**\brief Destroys the lookahead stage
  */
@@ -94,12 +121,34 @@ struct lookahead_entry *av1_lookahead_pop(struct lookahead_ctx *ctx, int drain);
 struct lookahead_entry *av1_lookahead_peek(struct lookahead_ctx *ctx,
                                            int index);
 
+/**\brief Get the entry of a frame buffer
+ *
+ * Returns NULL if the buffer is not one of the queue. The entry may have been
+ * popped, but its time stamps are the ones of the frame in the buffer.
+ *
+ * \param[in] ctx       Pointer to the lookahead context
+ * \param[in] img       Frame buffer
+ */
+struct lookahead_entry *av1_lookahead_find(struct lookahead_ctx *ctx,
+                                           const YV12_BUFFER_CONFIG *img);
+
 /**\brief Get the number of frames currently in the lookahead queue
  *
  * \param[in] ctx       Pointer to the lookahead context
  */
 unsigned int av1_lookahead_depth(struct lookahead_ctx *ctx);
 
+/**\brief Get the statistics of a buffer of the queue
+ *
+ * Waits for the analysis thread if it is still working on the buffer.
+ *
+ * \param[in] ctx       Pointer to the lookahead context
+ * \param[in] buf       Buffer returned by av1_lookahead_peek() or
+ *                      av1_lookahead_pop()
+ */
+const struct lookahead_stats *av1_lookahead_get_stats(
+    struct lookahead_ctx *ctx, struct lookahead_entry *buf);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
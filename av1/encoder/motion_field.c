@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aom_mem/aom_mem.h"
+#include "av1/encoder/motion_field.h"
+
+MotionField *av1_find_motion_field(MotionFieldCache *cache, int64_t src_ts,
+                                   int64_t ref_ts, BLOCK_SIZE bsize,
+                                   int qindex, int rows, int cols) {
+  for (int i = 0; i < MOTION_FIELD_CACHE_SIZE; ++i) {
+    MotionField *const field = &cache->fields[i];
+    if (field->in_use && field->src_ts == src_ts && field->ref_ts == ref_ts &&
+        field->bsize == bsize && field->qindex == qindex &&
+        field->rows == rows && field->cols == cols) {
+      return field;
+    }
+  }
+  return NULL;
+}
+
+MotionField *av1_add_motion_field(MotionFieldCache *cache, int64_t src_ts,
+                                  int64_t ref_ts, BLOCK_SIZE bsize, int qindex,
+                                  int rows, int cols) {
+  // Take a free field if there is one, the oldest field otherwise.
+  MotionField *field = &cache->fields[0];
+  for (int i = 0; i < MOTION_FIELD_CACHE_SIZE; ++i) {
+    MotionField *const this_field = &cache->fields[i];
+    if (!this_field->in_use) {
+      field = this_field;
+      break;
+    }
+    if (this_field->order < field->order) field = this_field;
+  }
+  const int size = rows * cols;
+
+  field->in_use = 0;
+  if (field->alloc_size < size) {
+    aom_free(field->mvs);
+    aom_free(field->errs);
+    aom_free(field->cost_lists);
+    field->mvs = (MV *)aom_malloc(size * sizeof(*field->mvs));
+    field->errs = (int *)aom_malloc(size * sizeof(*field->errs));
+    field->cost_lists = (int(*)[MOTION_FIELD_COST_LIST_SIZE])aom_malloc(
+        size * sizeof(*field->cost_lists));
+    if (!field->mvs || !field->errs || !field->cost_lists) {
+      aom_free(field->mvs);
+      aom_free(field->errs);
+      aom_free(field->cost_lists);
+      field->mvs = NULL;
+      field->errs = NULL;
+      field->cost_lists = NULL;
+      field->alloc_size = 0;
+      return NULL;
+    }
+    field->alloc_size = size;
+  }
+  for (int i = 0; i < size; ++i) field->errs[i] = INT_MAX;
+  field->src_ts = src_ts;
+  field->ref_ts = ref_ts;
+  field->bsize = bsize;
+  field->qindex = qindex;
+  field->rows = rows;
+  field->cols = cols;
+  field->order = cache->num_added++;
+  field->in_use = 1;
+  return field;
+}
+
+void av1_free_motion_field(MotionField *field) {
+  aom_free(field->mvs);
+  aom_free(field->errs);
+  aom_free(field->cost_lists);
+  memset(field, 0, sizeof(*field));
+}
+
+void av1_free_motion_field_cache(MotionFieldCache *cache) {
+  for (int i = 0; i < MOTION_FIELD_CACHE_SIZE; ++i) {
+    av1_free_motion_field(&cache->fields[i]);
+  }
+  memset(cache, 0, sizeof(*cache));
+}
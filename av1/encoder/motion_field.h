@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_ENCODER_MOTION_FIELD_H_
+#define AOM_AV1_ENCODER_MOTION_FIELD_H_
+
+#include "aom/aom_integer.h"
+#include "av1/common/enums.h"
+#include "av1/common/mv.h"
+#include "av1/encoder/lookahead.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The number of entries in the cost list of a full-pel search.
+#define MOTION_FIELD_COST_LIST_SIZE 5
+
+// The full-pel motion vectors found for the blocks of a source frame of the
+// lookahead, when searched in another source frame. The frames are the ones
+// with the given time stamps, so a field stays valid as long as both frames
+// are in the lookahead. The search costs depend on the q index, so a field
+// only serves searches at the q index it was found at. They also depend on the
+// motion vector costs, which are not part of the key: a field found with the
+// costs of an earlier frame may differ from a new search.
+typedef struct MotionField {
+  int64_t src_ts;
+  int64_t ref_ts;
+  BLOCK_SIZE bsize;
+  int qindex;
+  int rows;
+  int cols;
+  // Full-pel vector, error and cost list of each block, in raster order. The
+  // error is INT_MAX for the blocks that have not been searched yet.
+  MV *mvs;
+  int *errs;
+  int (*cost_lists)[MOTION_FIELD_COST_LIST_SIZE];
+  int alloc_size;
+  int in_use;
+  // The number of fields added to the cache before this one.
+  int64_t order;
+} MotionField;
+
+// A TPL model searches at most INTER_REFS_PER_FRAME references for each frame
+// of the lookahead, so the fields of the previous model are not replaced by
+// those of the current one.
+#define MOTION_FIELD_CACHE_SIZE ((MAX_LAG_BUFFERS + 1) * INTER_REFS_PER_FRAME)
+
+// The motion fields of the last searched pairs of source frames.
+typedef struct MotionFieldCache {
+  MotionField fields[MOTION_FIELD_CACHE_SIZE];
+  // The number of fields added to the cache.
+  int64_t num_added;
+} MotionFieldCache;
+
+// Returns the field of the blocks of size 'bsize' of the frame with time
+// stamp 'src_ts' in the frame with time stamp 'ref_ts', searched at q index
+// 'qindex', or NULL if it is not in the cache.
+MotionField *av1_find_motion_field(MotionFieldCache *cache, int64_t src_ts,
+                                   int64_t ref_ts, BLOCK_SIZE bsize,
+                                   int qindex, int rows, int cols);
+
+// Adds a field with no searched block for the pair of frames, in a free field
+// if there is one and replacing the oldest one otherwise. Returns NULL if
+// memory allocation fails.
+MotionField *av1_add_motion_field(MotionFieldCache *cache, int64_t src_ts,
+                                  int64_t ref_ts, BLOCK_SIZE bsize, int qindex,
+                                  int rows, int cols);
+
+// Removes 'field' from its cache and frees its memory.
+void av1_free_motion_field(MotionField *field);
+
+void av1_free_motion_field_cache(MotionFieldCache *cache);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_ENCODER_MOTION_FIELD_H_
@@ -12,6 +12,7 @@
 #include <math.h>
 #include <string.h>
 
+#include "config/aom_dsp_rtcd.h"
 #include "config/aom_scale_rtcd.h"
 
 #include "aom/aom_integer.h"
@@ -20,10 +21,11 @@
 #include "av1/common/onyxc_int.h"
 #include "av1/common/reconinter.h"
 #include "av1/encoder/encoder.h"
+#include "av1/encoder/ethread.h"
+#include "av1/encoder/pickcdef.h"
 
 #define REDUCED_PRI_STRENGTHS 8
 #define REDUCED_TOTAL_STRENGTHS (REDUCED_PRI_STRENGTHS * CDEF_SEC_STRENGTHS)
-#define TOTAL_STRENGTHS (CDEF_PRI_STRENGTHS * CDEF_SEC_STRENGTHS)
 
 static const int priconv[REDUCED_PRI_STRENGTHS] = { 0, 1, 2, 3, 5, 7, 10, 13 };
 
@@ -204,32 +206,6 @@ static INLINE uint64_t dist_8x8_16bit(uint16_t *dst, int dstride, uint16_t *src,
 }
 #endif  // CONFIG_DIST_8X8
 
-static INLINE uint64_t mse_8x8_16bit(uint16_t *dst, int dstride, uint16_t *src,
-                                     int sstride) {
-  uint64_t sum = 0;
-  int i, j;
-  for (i = 0; i < 8; i++) {
-    for (j = 0; j < 8; j++) {
-      int e = dst[i * dstride + j] - src[i * sstride + j];
-      sum += e * e;
-    }
-  }
-  return sum;
-}
-
-static INLINE uint64_t mse_4x4_16bit(uint16_t *dst, int dstride, uint16_t *src,
-                                     int sstride) {
-  uint64_t sum = 0;
-  int i, j;
-  for (i = 0; i < 4; i++) {
-    for (j = 0; j < 4; j++) {
-      int e = dst[i * dstride + j] - src[i * sstride + j];
-      sum += e * e;
-    }
-  }
-  return sum;
-}
-
 /* Compute MSE only on the blocks we filtered. */
 static uint64_t compute_cdef_dist(uint16_t *dst, int dstride, uint16_t *src,
                                   cdef_list *dlist, int cdef_count,
@@ -245,41 +221,35 @@ static uint64_t compute_cdef_dist(uint16_t *dst, int dstride, uint16_t *src,
         sum += dist_8x8_16bit(&dst[(by << 3) * dstride + (bx << 3)], dstride,
                               &src[bi << (3 + 3)], 8, coeff_shift);
 #else
-
-        sum += mse_8x8_16bit(&dst[(by << 3) * dstride + (bx << 3)], dstride,
-                             &src[bi << (3 + 3)], 8);
+        sum += aom_mse_wxh_16bit(&dst[(by << 3) * dstride + (bx << 3)],
+                                 dstride, &src[bi << (3 + 3)], 8, 8, 8);
 #endif  // CONFIG_DIST_8X8
-
       } else {
-        sum += mse_8x8_16bit(&dst[(by << 3) * dstride + (bx << 3)], dstride,
-                             &src[bi << (3 + 3)], 8);
+        sum += aom_mse_wxh_16bit(&dst[(by << 3) * dstride + (bx << 3)],
+                                 dstride, &src[bi << (3 + 3)], 8, 8, 8);
       }
     }
   } else if (bsize == BLOCK_4X8) {
     for (bi = 0; bi < cdef_count; bi++) {
       by = dlist[bi].by;
       bx = dlist[bi].bx;
-      sum += mse_4x4_16bit(&dst[(by << 3) * dstride + (bx << 2)], dstride,
-                           &src[bi << (3 + 2)], 4);
-      sum += mse_4x4_16bit(&dst[((by << 3) + 4) * dstride + (bx << 2)], dstride,
-                           &src[(bi << (3 + 2)) + 4 * 4], 4);
+      sum += aom_mse_wxh_16bit(&dst[(by << 3) * dstride + (bx << 2)], dstride,
+                               &src[bi << (3 + 2)], 4, 4, 8);
     }
   } else if (bsize == BLOCK_8X4) {
     for (bi = 0; bi < cdef_count; bi++) {
       by = dlist[bi].by;
       bx = dlist[bi].bx;
-      sum += mse_4x4_16bit(&dst[(by << 2) * dstride + (bx << 3)], dstride,
-                           &src[bi << (2 + 3)], 8);
-      sum += mse_4x4_16bit(&dst[(by << 2) * dstride + (bx << 3) + 4], dstride,
-                           &src[(bi << (2 + 3)) + 4], 8);
+      sum += aom_mse_wxh_16bit(&dst[(by << 2) * dstride + (bx << 3)], dstride,
+                               &src[bi << (2 + 3)], 8, 8, 4);
     }
   } else {
     assert(bsize == BLOCK_4X4);
     for (bi = 0; bi < cdef_count; bi++) {
       by = dlist[bi].by;
       bx = dlist[bi].bx;
-      sum += mse_4x4_16bit(&dst[(by << 2) * dstride + (bx << 2)], dstride,
-                           &src[bi << (2 + 2)], 4);
+      sum += aom_mse_wxh_16bit(&dst[(by << 2) * dstride + (bx << 2)], dstride,
+                               &src[bi << (2 + 2)], 4, 4, 4);
     }
   }
   return sum >> 2 * coeff_shift;
@@ -298,6 +268,90 @@ static int sb_all_skip(const AV1_COMMON *const cm, int mi_row, int mi_col) {
   return 1;
 }
 
+// Fills the mse of each strength for the filter block 'sb' of 'ctx'.
+static void cdef_search_sb(CdefSearchCtx *ctx, int sb) {
+  const AV1_COMMON *const cm = ctx->cm;
+  const int nvfb = ctx->nvfb;
+  const int nhfb = ctx->nhfb;
+  const int fbr = ctx->sb_fb_pos[sb] / nhfb;
+  const int fbc = ctx->sb_fb_pos[sb] % nhfb;
+  cdef_list dlist[MI_SIZE_128X128 * MI_SIZE_128X128];
+  int dir[CDEF_NBLOCKS][CDEF_NBLOCKS] = { { 0 } };
+  int var[CDEF_NBLOCKS][CDEF_NBLOCKS] = { { 0 } };
+  DECLARE_ALIGNED(32, uint16_t, tmp_dst[1 << (MAX_SB_SIZE_LOG2 * 2)]);
+  DECLARE_ALIGNED(32, uint16_t, inbuf[CDEF_INBUF_SIZE]);
+  uint16_t *const in = inbuf + CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER;
+
+  const MB_MODE_INFO *const mbmi =
+      cm->mi_grid_base[MI_SIZE_64X64 * fbr * cm->mi_stride +
+                       MI_SIZE_64X64 * fbc];
+  int nhb = AOMMIN(MI_SIZE_64X64, cm->mi_cols - MI_SIZE_64X64 * fbc);
+  int nvb = AOMMIN(MI_SIZE_64X64, cm->mi_rows - MI_SIZE_64X64 * fbr);
+  int hb_step = 1;
+  int vb_step = 1;
+  BLOCK_SIZE bs;
+  if (mbmi->sb_type == BLOCK_128X128 || mbmi->sb_type == BLOCK_128X64 ||
+      mbmi->sb_type == BLOCK_64X128) {
+    bs = mbmi->sb_type;
+    if (bs == BLOCK_128X128 || bs == BLOCK_128X64) {
+      nhb = AOMMIN(MI_SIZE_128X128, cm->mi_cols - MI_SIZE_64X64 * fbc);
+      hb_step = 2;
+    }
+    if (bs == BLOCK_128X128 || bs == BLOCK_64X128) {
+      nvb = AOMMIN(MI_SIZE_128X128, cm->mi_rows - MI_SIZE_64X64 * fbr);
+      vb_step = 2;
+    }
+  } else {
+    bs = BLOCK_64X64;
+  }
+
+  const int cdef_count = av1_cdef_compute_sb_list(
+      cm, fbr * MI_SIZE_64X64, fbc * MI_SIZE_64X64, dlist, bs);
+
+  const int yoff = CDEF_VBORDER * (fbr != 0);
+  const int xoff = CDEF_HBORDER * (fbc != 0);
+  int dirinit = 0;
+  for (int pli = 0; pli < ctx->num_planes; pli++) {
+    for (int i = 0; i < CDEF_INBUF_SIZE; i++) inbuf[i] = CDEF_VERY_LARGE;
+    /* We avoid filtering the pixels for which some of the pixels to average
+       are outside the frame. We could change the filter instead, but it
+       would add special cases for any future vectorization. */
+    const int ysize = (nvb << ctx->mi_high_l2[pli]) +
+                      CDEF_VBORDER * (fbr + vb_step < nvfb) + yoff;
+    const int xsize = (nhb << ctx->mi_wide_l2[pli]) +
+                      CDEF_HBORDER * (fbc + hb_step < nhfb) + xoff;
+    const int row = fbr * MI_SIZE_64X64 << ctx->mi_high_l2[pli];
+    const int col = fbc * MI_SIZE_64X64 << ctx->mi_wide_l2[pli];
+    for (int gi = 0; gi < ctx->total_strengths; gi++) {
+      int pri_strength = gi / CDEF_SEC_STRENGTHS;
+      if (ctx->fast) pri_strength = priconv[pri_strength];
+      const int sec_strength = gi % CDEF_SEC_STRENGTHS;
+      copy_sb16_16(&in[(-yoff * CDEF_BSTRIDE - xoff)], CDEF_BSTRIDE,
+                   ctx->src[pli], row - yoff, col - xoff, ctx->stride[pli],
+                   ysize, xsize);
+      av1_cdef_filter_fb(NULL, tmp_dst, CDEF_BSTRIDE, in, ctx->xdec[pli],
+                         ctx->ydec[pli], dir, &dirinit, var, pli, dlist,
+                         cdef_count, pri_strength,
+                         sec_strength + (sec_strength == 3), ctx->damping,
+                         ctx->coeff_shift);
+      const uint64_t curr_mse = compute_cdef_dist(
+          ctx->ref_coeff[pli] + row * ctx->stride[pli] + col, ctx->stride[pli],
+          tmp_dst, dlist, cdef_count, ctx->bsize[pli], ctx->coeff_shift, pli);
+      if (pli < 2)
+        ctx->mse[pli][sb][gi] = curr_mse;
+      else
+        ctx->mse[1][sb][gi] += curr_mse;
+    }
+  }
+}
+
+void av1_cdef_search_sbs(CdefSearchCtx *ctx) {
+  int sb;
+  while ((sb = aom_atomic_fetch_add(&ctx->next_sb, 1)) < ctx->sb_count) {
+    cdef_search_sb(ctx, sb);
+  }
+}
+
 static void pick_cdef_from_qp(AV1_COMMON *const cm) {
   const int bd = cm->seq_params.bit_depth;
   const int q = av1_ac_quant_QTX(cm->base_qindex, 0, bd) >> (bd - 8);
@@ -354,26 +408,21 @@ static void pick_cdef_from_qp(AV1_COMMON *const cm) {
   }
 }
 
-void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
-                     AV1_COMMON *cm, MACROBLOCKD *xd, int pick_method,
-                     int rdmult) {
+void av1_cdef_search(AV1_COMP *cpi, YV12_BUFFER_CONFIG *frame,
+                     const YV12_BUFFER_CONFIG *ref, MACROBLOCKD *xd,
+                     int pick_method, int rdmult) {
+  AV1_COMMON *const cm = &cpi->common;
   if (pick_method == CDEF_PICK_FROM_Q) {
     pick_cdef_from_qp(cm);
     return;
   }
 
-  uint16_t *src[3];
-  uint16_t *ref_coeff[3];
-  static cdef_list dlist[MI_SIZE_128X128 * MI_SIZE_128X128];
-  int dir[CDEF_NBLOCKS][CDEF_NBLOCKS] = { { 0 } };
-  int var[CDEF_NBLOCKS][CDEF_NBLOCKS] = { { 0 } };
+  CdefSearchCtx ctx;
   const int nvfb = (cm->mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
   const int nhfb = (cm->mi_cols + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
   int *sb_index = aom_malloc(nvfb * nhfb * sizeof(*sb_index));
   const int damping = 3 + (cm->base_qindex >> 6);
   const int fast = pick_method == CDEF_FAST_SEARCH;
-  const int total_strengths = fast ? REDUCED_TOTAL_STRENGTHS : TOTAL_STRENGTHS;
-  DECLARE_ALIGNED(32, uint16_t, tmp_dst[1 << (MAX_SB_SIZE_LOG2 * 2)]);
   const int num_planes = av1_num_planes(cm);
   av1_setup_dst_planes(xd->plane, cm->seq_params.sb_size, frame, 0, 0, 0,
                        num_planes);
@@ -381,12 +430,16 @@ void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
   mse[0] = aom_malloc(sizeof(**mse) * nvfb * nhfb);
   mse[1] = aom_malloc(sizeof(**mse) * nvfb * nhfb);
 
-  int stride[3];
-  int bsize[3];
-  int mi_wide_l2[3];
-  int mi_high_l2[3];
-  int xdec[3];
-  int ydec[3];
+  ctx.cm = cm;
+  ctx.nvfb = nvfb;
+  ctx.nhfb = nhfb;
+  ctx.num_planes = num_planes;
+  ctx.damping = damping;
+  ctx.coeff_shift = AOMMAX(cm->seq_params.bit_depth - 8, 0);
+  ctx.fast = fast;
+  ctx.total_strengths = fast ? REDUCED_TOTAL_STRENGTHS : TOTAL_STRENGTHS;
+  ctx.mse[0] = mse[0];
+  ctx.mse[1] = mse[1];
   for (int pli = 0; pli < num_planes; pli++) {
     uint8_t *ref_buffer;
     int ref_stride;
@@ -404,43 +457,47 @@ void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
         ref_stride = ref->uv_stride;
         break;
     }
-    src[pli] = aom_memalign(
-        32, sizeof(*src) * cm->mi_rows * cm->mi_cols * MI_SIZE * MI_SIZE);
-    ref_coeff[pli] = aom_memalign(
-        32, sizeof(*ref_coeff) * cm->mi_rows * cm->mi_cols * MI_SIZE * MI_SIZE);
-    xdec[pli] = xd->plane[pli].subsampling_x;
-    ydec[pli] = xd->plane[pli].subsampling_y;
-    bsize[pli] = ydec[pli] ? (xdec[pli] ? BLOCK_4X4 : BLOCK_8X4)
-                           : (xdec[pli] ? BLOCK_4X8 : BLOCK_8X8);
-    stride[pli] = cm->mi_cols << MI_SIZE_LOG2;
-    mi_wide_l2[pli] = MI_SIZE_LOG2 - xd->plane[pli].subsampling_x;
-    mi_high_l2[pli] = MI_SIZE_LOG2 - xd->plane[pli].subsampling_y;
+    ctx.src[pli] = aom_memalign(
+        32, sizeof(*ctx.src[pli]) * cm->mi_rows * cm->mi_cols * MI_SIZE *
+                MI_SIZE);
+    ctx.ref_coeff[pli] = aom_memalign(
+        32, sizeof(*ctx.ref_coeff[pli]) * cm->mi_rows * cm->mi_cols *
+                MI_SIZE * MI_SIZE);
+    ctx.xdec[pli] = xd->plane[pli].subsampling_x;
+    ctx.ydec[pli] = xd->plane[pli].subsampling_y;
+    ctx.bsize[pli] = ctx.ydec[pli] ? (ctx.xdec[pli] ? BLOCK_4X4 : BLOCK_8X4)
+                                   : (ctx.xdec[pli] ? BLOCK_4X8 : BLOCK_8X8);
+    ctx.stride[pli] = cm->mi_cols << MI_SIZE_LOG2;
+    ctx.mi_wide_l2[pli] = MI_SIZE_LOG2 - xd->plane[pli].subsampling_x;
+    ctx.mi_high_l2[pli] = MI_SIZE_LOG2 - xd->plane[pli].subsampling_y;
 
     const int frame_height =
         (cm->mi_rows * MI_SIZE) >> xd->plane[pli].subsampling_y;
     const int frame_width =
         (cm->mi_cols * MI_SIZE) >> xd->plane[pli].subsampling_x;
-    const int plane_sride = stride[pli];
+    const int plane_sride = ctx.stride[pli];
     const int dst_stride = xd->plane[pli].dst.stride;
+    uint16_t *const src = ctx.src[pli];
+    uint16_t *const ref_coeff = ctx.ref_coeff[pli];
     for (int r = 0; r < frame_height; ++r) {
       for (int c = 0; c < frame_width; ++c) {
         if (cm->seq_params.use_highbitdepth) {
-          src[pli][r * plane_sride + c] =
+          src[r * plane_sride + c] =
               CONVERT_TO_SHORTPTR(xd->plane[pli].dst.buf)[r * dst_stride + c];
-          ref_coeff[pli][r * plane_sride + c] =
+          ref_coeff[r * plane_sride + c] =
               CONVERT_TO_SHORTPTR(ref_buffer)[r * ref_stride + c];
         } else {
-          src[pli][r * plane_sride + c] =
+          src[r * plane_sride + c] =
               xd->plane[pli].dst.buf[r * dst_stride + c];
-          ref_coeff[pli][r * plane_sride + c] = ref_buffer[r * ref_stride + c];
+          ref_coeff[r * plane_sride + c] = ref_buffer[r * ref_stride + c];
         }
       }
     }
   }
 
-  DECLARE_ALIGNED(32, uint16_t, inbuf[CDEF_INBUF_SIZE]);
-  uint16_t *const in = inbuf + CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER;
-  const int coeff_shift = AOMMAX(cm->seq_params.bit_depth - 8, 0);
+  // List the filter blocks to search. The search of each is independent, so
+  // they are searched on the encoder workers.
+  ctx.sb_fb_pos = aom_malloc(nvfb * nhfb * sizeof(*ctx.sb_fb_pos));
   int sb_count = 0;
   for (int fbr = 0; fbr < nvfb; ++fbr) {
     for (int fbc = 0; fbc < nhfb; ++fbc) {
@@ -456,67 +513,18 @@ void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
            (mbmi->sb_type == BLOCK_128X128 || mbmi->sb_type == BLOCK_64X128)))
         continue;
 
-      int nhb = AOMMIN(MI_SIZE_64X64, cm->mi_cols - MI_SIZE_64X64 * fbc);
-      int nvb = AOMMIN(MI_SIZE_64X64, cm->mi_rows - MI_SIZE_64X64 * fbr);
-      int hb_step = 1;
-      int vb_step = 1;
-      BLOCK_SIZE bs;
-      if (mbmi->sb_type == BLOCK_128X128 || mbmi->sb_type == BLOCK_128X64 ||
-          mbmi->sb_type == BLOCK_64X128) {
-        bs = mbmi->sb_type;
-        if (bs == BLOCK_128X128 || bs == BLOCK_128X64) {
-          nhb = AOMMIN(MI_SIZE_128X128, cm->mi_cols - MI_SIZE_64X64 * fbc);
-          hb_step = 2;
-        }
-        if (bs == BLOCK_128X128 || bs == BLOCK_64X128) {
-          nvb = AOMMIN(MI_SIZE_128X128, cm->mi_rows - MI_SIZE_64X64 * fbr);
-          vb_step = 2;
-        }
-      } else {
-        bs = BLOCK_64X64;
-      }
-
-      const int cdef_count = av1_cdef_compute_sb_list(
-          cm, fbr * MI_SIZE_64X64, fbc * MI_SIZE_64X64, dlist, bs);
-
-      const int yoff = CDEF_VBORDER * (fbr != 0);
-      const int xoff = CDEF_HBORDER * (fbc != 0);
-      int dirinit = 0;
-      for (int pli = 0; pli < num_planes; pli++) {
-        for (int i = 0; i < CDEF_INBUF_SIZE; i++) inbuf[i] = CDEF_VERY_LARGE;
-        /* We avoid filtering the pixels for which some of the pixels to average
-           are outside the frame. We could change the filter instead, but it
-           would add special cases for any future vectorization. */
-        const int ysize = (nvb << mi_high_l2[pli]) +
-                          CDEF_VBORDER * (fbr + vb_step < nvfb) + yoff;
-        const int xsize = (nhb << mi_wide_l2[pli]) +
-                          CDEF_HBORDER * (fbc + hb_step < nhfb) + xoff;
-        const int row = fbr * MI_SIZE_64X64 << mi_high_l2[pli];
-        const int col = fbc * MI_SIZE_64X64 << mi_wide_l2[pli];
-        for (int gi = 0; gi < total_strengths; gi++) {
-          int pri_strength = gi / CDEF_SEC_STRENGTHS;
-          if (fast) pri_strength = priconv[pri_strength];
-          const int sec_strength = gi % CDEF_SEC_STRENGTHS;
-          copy_sb16_16(&in[(-yoff * CDEF_BSTRIDE - xoff)], CDEF_BSTRIDE,
-                       src[pli], row - yoff, col - xoff, stride[pli], ysize,
-                       xsize);
-          av1_cdef_filter_fb(
-              NULL, tmp_dst, CDEF_BSTRIDE, in, xdec[pli], ydec[pli], dir,
-              &dirinit, var, pli, dlist, cdef_count, pri_strength,
-              sec_strength + (sec_strength == 3), damping, coeff_shift);
-          const uint64_t curr_mse = compute_cdef_dist(
-              ref_coeff[pli] + row * stride[pli] + col, stride[pli], tmp_dst,
-              dlist, cdef_count, bsize[pli], coeff_shift, pli);
-          if (pli < 2)
-            mse[pli][sb_count][gi] = curr_mse;
-          else
-            mse[1][sb_count][gi] += curr_mse;
-        }
-      }
+      ctx.sb_fb_pos[sb_count] = fbr * nhfb + fbc;
       sb_index[sb_count++] =
           MI_SIZE_64X64 * fbr * cm->mi_stride + MI_SIZE_64X64 * fbc;
     }
   }
+  ctx.sb_count = sb_count;
+  aom_atomic_init(&ctx.next_sb, 0);
+  if (cpi->oxcf.max_threads > 1 && sb_count > 1) {
+    av1_cdef_search_mt(cpi, &ctx);
+  } else {
+    av1_cdef_search_sbs(&ctx);
+  }
 
   /* Search for different number of signalling bits. */
   int nb_strength_bits = 0;
@@ -586,8 +594,9 @@ void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
   aom_free(mse[0]);
   aom_free(mse[1]);
   for (int pli = 0; pli < num_planes; pli++) {
-    aom_free(src[pli]);
-    aom_free(ref_coeff[pli]);
+    aom_free(ctx.src[pli]);
+    aom_free(ctx.ref_coeff[pli]);
   }
+  aom_free(ctx.sb_fb_pos);
   aom_free(sb_index);
 }
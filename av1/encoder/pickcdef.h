@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_ENCODER_PICKCDEF_H_
+#define AOM_AV1_ENCODER_PICKCDEF_H_
+
+#include "aom_util/aom_atomics.h"
+#include "av1/common/cdef.h"
+#include "av1/encoder/encoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TOTAL_STRENGTHS (CDEF_PRI_STRENGTHS * CDEF_SEC_STRENGTHS)
+
+// The CDEF strength search of a frame. The threads filtering its 64x64 filter
+// blocks with each strength claim them one at a time.
+typedef struct CdefSearchCtx {
+  const AV1_COMMON *cm;
+  // The reconstructed and source planes, in 16 bits.
+  uint16_t *src[MAX_MB_PLANE];
+  uint16_t *ref_coeff[MAX_MB_PLANE];
+  int stride[MAX_MB_PLANE];
+  int bsize[MAX_MB_PLANE];
+  int mi_wide_l2[MAX_MB_PLANE];
+  int mi_high_l2[MAX_MB_PLANE];
+  int xdec[MAX_MB_PLANE];
+  int ydec[MAX_MB_PLANE];
+  int num_planes;
+  int nvfb;
+  int nhfb;
+  int damping;
+  int coeff_shift;
+  int fast;
+  int total_strengths;
+  // The filter blocks to search, as fbr * nhfb + fbc.
+  int *sb_fb_pos;
+  int sb_count;
+  // The next filter block to search.
+  aom_atomic_int next_sb;
+  // The luma and chroma mse of each strength for each filter block.
+  uint64_t (*mse[2])[TOTAL_STRENGTHS];
+} CdefSearchCtx;
+
+void av1_cdef_search(AV1_COMP *cpi, YV12_BUFFER_CONFIG *frame,
+                     const YV12_BUFFER_CONFIG *ref, MACROBLOCKD *xd,
+                     int pick_method, int rdmult);
+
+// Searches the filter blocks of 'ctx' not claimed by another thread.
+void av1_cdef_search_sbs(CdefSearchCtx *ctx);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_ENCODER_PICKCDEF_H_
@@ -37,6 +37,65 @@ static void yv12_copy_plane(const YV12_BUFFER_CONFIG *src_bc,
   }
 }
 
+static void yv12_copy_plane_rows(const YV12_BUFFER_CONFIG *src_bc,
+                                 YV12_BUFFER_CONFIG *dst_bc, int plane,
+                                 int vstart, int vend) {
+  const int width = src_bc->crop_widths[plane > 0];
+  switch (plane) {
+    case 0:
+      aom_yv12_partial_coloc_copy_y(src_bc, dst_bc, 0, width, vstart, vend);
+      break;
+    case 1:
+      aom_yv12_partial_coloc_copy_u(src_bc, dst_bc, 0, width, vstart, vend);
+      break;
+    case 2:
+      aom_yv12_partial_coloc_copy_v(src_bc, dst_bc, 0, width, vstart, vend);
+      break;
+    default: assert(plane >= 0 && plane <= 2); break;
+  }
+}
+
+static int64_t get_sse_plane_rows(const YV12_BUFFER_CONFIG *a,
+                                  const YV12_BUFFER_CONFIG *b, int plane,
+                                  int highbd, int vstart, int vend) {
+  const int width = b->crop_widths[plane > 0];
+  const int height = vend - vstart;
+#if CONFIG_AV1_HIGHBITDEPTH
+  if (highbd) {
+    switch (plane) {
+      case 0: return aom_highbd_get_y_sse_part(a, b, 0, width, vstart, height);
+      case 1: return aom_highbd_get_u_sse_part(a, b, 0, width, vstart, height);
+      case 2: return aom_highbd_get_v_sse_part(a, b, 0, width, vstart, height);
+      default: assert(plane >= 0 && plane <= 2); return 0;
+    }
+  }
+#else
+  (void)highbd;
+#endif
+  switch (plane) {
+    case 0: return aom_get_y_sse_part(a, b, 0, width, vstart, height);
+    case 1: return aom_get_u_sse_part(a, b, 0, width, vstart, height);
+    case 2: return aom_get_v_sse_part(a, b, 0, width, vstart, height);
+    default: assert(plane >= 0 && plane <= 2); return 0;
+  }
+}
+
+// Gets the rows of 'plane' that the filter changes when only part of the frame
+// is filtered: the filtered rows, and the ones above them that the filtering
+// of their top edges changes.
+static void get_partial_frame_rows(const AV1_COMMON *cm, int plane,
+                                   int *vstart, int *vend) {
+  const int ss_y = plane > 0 && cm->seq_params.subsampling_y;
+  int start_mi_row, end_mi_row;
+  av1_get_filter_mi_rows(cm, 1, &start_mi_row, &end_mi_row);
+  end_mi_row = start_mi_row + ALIGN_POWER_OF_TWO(end_mi_row - start_mi_row,
+                                                 MAX_MIB_SIZE_LOG2);
+  // The widest filter changes 6 luma rows on each side of an edge.
+  *vstart = AOMMAX(start_mi_row * MI_SIZE - 8, 0) >> ss_y;
+  *vend = AOMMIN((end_mi_row * MI_SIZE) >> ss_y,
+                 cm->cur_frame->buf.crop_heights[plane > 0]);
+}
+
 int av1_get_max_filter_level(const AV1_COMP *cpi) {
   if (cpi->oxcf.pass == 2) {
     return cpi->twopass.section_intra_rating > 8 ? MAX_LOOP_FILTER * 3 / 4
@@ -75,7 +134,8 @@ static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
 #if CONFIG_LPF_MASK
                              0,
 #endif
-                             cpi->workers, cpi->num_workers, &cpi->lf_row_sync);
+                             cpi->workers, cpi->num_workers, &cpi->lf_row_sync,
+                             NULL, NULL);
   else
     av1_loop_filter_frame(&cm->cur_frame->buf, cm, &cpi->td.mb.e_mbd,
 #if CONFIG_LPF_MASK
@@ -83,6 +143,18 @@ static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
 #endif
                           plane, plane + 1, partial_frame);
 
+  if (partial_frame) {
+    // Only the rows the filter changes are measured and restored.
+    int vstart, vend;
+    get_partial_frame_rows(cm, plane, &vstart, &vend);
+    filt_err = get_sse_plane_rows(sd, &cm->cur_frame->buf, plane,
+                                  cm->seq_params.use_highbitdepth, vstart,
+                                  vend);
+    yv12_copy_plane_rows(&cpi->last_frame_uf, &cm->cur_frame->buf, plane,
+                         vstart, vend);
+    return filt_err;
+  }
+
   filt_err = aom_get_sse_plane(sd, &cm->cur_frame->buf, plane,
                                cm->seq_params.use_highbitdepth);
 
@@ -130,7 +202,14 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
 
   // Set each entry to -1
   memset(ss_err, 0xFF, sizeof(ss_err));
-  yv12_copy_plane(&cm->cur_frame->buf, &cpi->last_frame_uf, plane);
+  if (partial_frame) {
+    int vstart, vend;
+    get_partial_frame_rows(cm, plane, &vstart, &vend);
+    yv12_copy_plane_rows(&cm->cur_frame->buf, &cpi->last_frame_uf, plane,
+                         vstart, vend);
+  } else {
+    yv12_copy_plane(&cm->cur_frame->buf, &cpi->last_frame_uf, plane);
+  }
   best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame, plane, dir);
   filt_best = filt_mid;
   ss_err[filt_mid] = best_err;
@@ -29,6 +29,7 @@
 
 #include "av1/encoder/av1_quantize.h"
 #include "av1/encoder/encoder.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/mathutils.h"
 #include "av1/encoder/picklpf.h"
 #include "av1/encoder/pickrst.h"
@@ -92,6 +93,10 @@ typedef struct {
   WienerInfo wiener;
   SgrprojInfo sgrproj;
 
+  // Set by the statistics pass when the Wiener filter derived from the unit
+  // statistics, in 'wiener', does better than the identity filter.
+  int wiener_found;
+
   // The sum of squared errors for this rtype.
   int64_t sse[RESTORE_SWITCHABLE_TYPES];
 
@@ -100,7 +105,7 @@ typedef struct {
   RestorationType best_rtype[RESTORE_TYPES - 1];
 } RestUnitSearchInfo;
 
-typedef struct {
+typedef struct RestSearchCtxt {
   const YV12_BUFFER_CONFIG *src;
   YV12_BUFFER_CONFIG *dst;
 
@@ -695,31 +700,13 @@ static AOM_INLINE void search_sgrproj(const RestorationTileLimits *limits,
                                       int32_t *tmpbuf,
                                       RestorationLineBuffers *rlbs) {
   (void)rlbs;
+  (void)tmpbuf;
   RestSearchCtxt *rsc = (RestSearchCtxt *)priv;
   RestUnitSearchInfo *rusi = &rsc->rusi[rest_unit_idx];
 
   const MACROBLOCK *const x = rsc->x;
-  const AV1_COMMON *const cm = rsc->cm;
-  const int highbd = cm->seq_params.use_highbitdepth;
-  const int bit_depth = cm->seq_params.bit_depth;
-
-  uint8_t *dgd_start =
-      rsc->dgd_buffer + limits->v_start * rsc->dgd_stride + limits->h_start;
-  const uint8_t *src_start =
-      rsc->src_buffer + limits->v_start * rsc->src_stride + limits->h_start;
-
-  const int is_uv = rsc->plane > 0;
-  const int ss_x = is_uv && cm->seq_params.subsampling_x;
-  const int ss_y = is_uv && cm->seq_params.subsampling_y;
-  const int procunit_width = RESTORATION_PROC_UNIT_SIZE >> ss_x;
-  const int procunit_height = RESTORATION_PROC_UNIT_SIZE >> ss_y;
-
-  rusi->sgrproj = search_selfguided_restoration(
-      dgd_start, limits->h_end - limits->h_start,
-      limits->v_end - limits->v_start, rsc->dgd_stride, src_start,
-      rsc->src_stride, highbd, bit_depth, procunit_width, procunit_height,
-      tmpbuf, rsc->sf->enable_sgr_ep_pruning);
 
+  // rusi->sgrproj was set by the statistics pass.
   RestorationUnitInfo rui;
   rui.restoration_type = RESTORE_SGRPROJ;
   rui.sgrproj_info = rusi->sgrproj;
@@ -1154,6 +1141,12 @@ static int count_wiener_bits(int wiener_win, WienerInfo *wiener_info,
   return bits;
 }
 
+static AOM_INLINE int get_reduced_wiener_win(const RestSearchCtxt *rsc) {
+  if (rsc->sf->reduce_wiener_window_size && rsc->plane == AOM_PLANE_Y)
+    return WIENER_WIN_REDUCED;
+  return (rsc->plane == AOM_PLANE_Y) ? WIENER_WIN : WIENER_WIN_CHROMA;
+}
+
 #define USE_WIENER_REFINEMENT_SEARCH 1
 static int64_t finer_tile_search_wiener(const RestSearchCtxt *rsc,
                                         const RestorationTileLimits *limits,
@@ -1274,38 +1267,12 @@ static AOM_INLINE void search_wiener(const RestorationTileLimits *limits,
 
   const int wiener_win =
       (rsc->plane == AOM_PLANE_Y) ? WIENER_WIN : WIENER_WIN_CHROMA;
+  const int reduced_wiener_win = get_reduced_wiener_win(rsc);
 
-  int reduced_wiener_win = wiener_win;
-  if (rsc->sf->reduce_wiener_window_size) {
-    reduced_wiener_win =
-        (rsc->plane == AOM_PLANE_Y) ? WIENER_WIN_REDUCED : WIENER_WIN_CHROMA;
-  }
-
-  int64_t M[WIENER_WIN2];
-  int64_t H[WIENER_WIN2 * WIENER_WIN2];
-  int32_t vfilter[WIENER_WIN], hfilter[WIENER_WIN];
-
-#if CONFIG_AV1_HIGHBITDEPTH
-  const AV1_COMMON *const cm = rsc->cm;
-  if (cm->seq_params.use_highbitdepth) {
-    av1_compute_stats_highbd(reduced_wiener_win, rsc->dgd_buffer,
-                             rsc->src_buffer, limits->h_start, limits->h_end,
-                             limits->v_start, limits->v_end, rsc->dgd_stride,
-                             rsc->src_stride, M, H, cm->seq_params.bit_depth);
-  } else {
-    av1_compute_stats(reduced_wiener_win, rsc->dgd_buffer, rsc->src_buffer,
-                      limits->h_start, limits->h_end, limits->v_start,
-                      limits->v_end, rsc->dgd_stride, rsc->src_stride, M, H);
-  }
-#else
-  av1_compute_stats(reduced_wiener_win, rsc->dgd_buffer, rsc->src_buffer,
-                    limits->h_start, limits->h_end, limits->v_start,
-                    limits->v_end, rsc->dgd_stride, rsc->src_stride, M, H);
-#endif
   const MACROBLOCK *const x = rsc->x;
   const int64_t bits_none = x->wiener_restore_cost[0];
 
-  if (!wiener_decompose_sep_sym(reduced_wiener_win, M, H, vfilter, hfilter)) {
+  if (!rusi->wiener_found) {
     rsc->bits += bits_none;
     rsc->sse += rusi->sse[RESTORE_NONE];
     rusi->best_rtype[RESTORE_WIENER - 1] = RESTORE_NONE;
@@ -1316,22 +1283,7 @@ static AOM_INLINE void search_wiener(const RestorationTileLimits *limits,
   RestorationUnitInfo rui;
   memset(&rui, 0, sizeof(rui));
   rui.restoration_type = RESTORE_WIENER;
-  finalize_sym_filter(reduced_wiener_win, vfilter, rui.wiener_info.vfilter);
-  finalize_sym_filter(reduced_wiener_win, hfilter, rui.wiener_info.hfilter);
-
-  // Filter score computes the value of the function x'*A*x - x'*b for the
-  // learned filter and compares it against identity filer. If there is no
-  // reduction in the function, the filter is reverted back to identity
-  if (compute_score(reduced_wiener_win, M, H, rui.wiener_info.vfilter,
-                    rui.wiener_info.hfilter) > 0) {
-    rsc->bits += bits_none;
-    rsc->sse += rusi->sse[RESTORE_NONE];
-    rusi->best_rtype[RESTORE_WIENER - 1] = RESTORE_NONE;
-    rusi->sse[RESTORE_WIENER] = INT64_MAX;
-    return;
-  }
-
-  aom_clear_system_state();
+  rui.wiener_info = rusi->wiener;
 
   rusi->sse[RESTORE_WIENER] = finer_tile_search_wiener(
       rsc, limits, tile_rect, &rui, reduced_wiener_win);
@@ -1363,6 +1315,121 @@ static AOM_INLINE void search_wiener(const RestorationTileLimits *limits,
   if (cost_wiener < cost_none) rsc->wiener = rusi->wiener;
 }
 
+static AOM_INLINE void compute_sgrproj_unit(const RestSearchCtxt *rsc,
+                                            const RestorationTileLimits *limits,
+                                            RestUnitSearchInfo *rusi,
+                                            int32_t *tmpbuf) {
+  const AV1_COMMON *const cm = rsc->cm;
+  const int highbd = cm->seq_params.use_highbitdepth;
+  const int bit_depth = cm->seq_params.bit_depth;
+
+  const uint8_t *dgd_start =
+      rsc->dgd_buffer + limits->v_start * rsc->dgd_stride + limits->h_start;
+  const uint8_t *src_start =
+      rsc->src_buffer + limits->v_start * rsc->src_stride + limits->h_start;
+
+  const int is_uv = rsc->plane > 0;
+  const int ss_x = is_uv && cm->seq_params.subsampling_x;
+  const int ss_y = is_uv && cm->seq_params.subsampling_y;
+  const int procunit_width = RESTORATION_PROC_UNIT_SIZE >> ss_x;
+  const int procunit_height = RESTORATION_PROC_UNIT_SIZE >> ss_y;
+
+  rusi->sgrproj = search_selfguided_restoration(
+      dgd_start, limits->h_end - limits->h_start,
+      limits->v_end - limits->v_start, rsc->dgd_stride, src_start,
+      rsc->src_stride, highbd, bit_depth, procunit_width, procunit_height,
+      tmpbuf, rsc->sf->enable_sgr_ep_pruning);
+}
+
+static AOM_INLINE void compute_wiener_unit(const RestSearchCtxt *rsc,
+                                           const RestorationTileLimits *limits,
+                                           RestUnitSearchInfo *rusi) {
+  const int reduced_wiener_win = get_reduced_wiener_win(rsc);
+
+  int64_t M[WIENER_WIN2];
+  int64_t H[WIENER_WIN2 * WIENER_WIN2];
+  int32_t vfilter[WIENER_WIN], hfilter[WIENER_WIN];
+
+#if CONFIG_AV1_HIGHBITDEPTH
+  const AV1_COMMON *const cm = rsc->cm;
+  if (cm->seq_params.use_highbitdepth) {
+    av1_compute_stats_highbd(reduced_wiener_win, rsc->dgd_buffer,
+                             rsc->src_buffer, limits->h_start, limits->h_end,
+                             limits->v_start, limits->v_end, rsc->dgd_stride,
+                             rsc->src_stride, M, H, cm->seq_params.bit_depth);
+  } else {
+    av1_compute_stats(reduced_wiener_win, rsc->dgd_buffer, rsc->src_buffer,
+                      limits->h_start, limits->h_end, limits->v_start,
+                      limits->v_end, rsc->dgd_stride, rsc->src_stride, M, H);
+  }
+#else
+  av1_compute_stats(reduced_wiener_win, rsc->dgd_buffer, rsc->src_buffer,
+                    limits->h_start, limits->h_end, limits->v_start,
+                    limits->v_end, rsc->dgd_stride, rsc->src_stride, M, H);
+#endif
+
+  rusi->wiener_found = 0;
+  if (!wiener_decompose_sep_sym(reduced_wiener_win, M, H, vfilter, hfilter))
+    return;
+
+  WienerInfo wiener;
+  memset(&wiener, 0, sizeof(wiener));
+  finalize_sym_filter(reduced_wiener_win, vfilter, wiener.vfilter);
+  finalize_sym_filter(reduced_wiener_win, hfilter, wiener.hfilter);
+
+  // Filter score computes the value of the function x'*A*x - x'*b for the
+  // learned filter and compares it against identity filer. If there is no
+  // reduction in the function, the filter is reverted back to identity
+  if (compute_score(reduced_wiener_win, M, H, wiener.vfilter, wiener.hfilter) >
+      0)
+    return;
+
+  aom_clear_system_state();
+  rusi->wiener = wiener;
+  rusi->wiener_found = 1;
+}
+
+void av1_compute_rest_unit_stats(RestUnitStatsCtx *ctx, int32_t *tmpbuf) {
+  const RestSearchCtxt *const rsc = ctx->rsc;
+  int u;
+  while ((u = aom_atomic_fetch_add(&ctx->next_unit, 1)) < ctx->num_units) {
+    if (ctx->do_sgrproj)
+      compute_sgrproj_unit(rsc, &ctx->limits[u], &rsc->rusi[u], tmpbuf);
+    if (ctx->do_wiener)
+      compute_wiener_unit(rsc, &ctx->limits[u], &rsc->rusi[u]);
+  }
+}
+
+static AOM_INLINE void get_unit_limits(const RestorationTileLimits *limits,
+                                       const AV1PixelRect *tile_rect,
+                                       int rest_unit_idx, void *priv,
+                                       int32_t *tmpbuf,
+                                       RestorationLineBuffers *rlbs) {
+  (void)tile_rect;
+  (void)tmpbuf;
+  (void)rlbs;
+  RestUnitStatsCtx *ctx = (RestUnitStatsCtx *)priv;
+  ctx->limits[rest_unit_idx] = *limits;
+}
+
+// Derives the Wiener and self-guided filters of the units of the plane of
+// 'ctx', on the encoder workers when there are several.
+static void compute_plane_stats(AV1_COMP *cpi, RestUnitStatsCtx *ctx,
+                                int num_units) {
+  RestSearchCtxt *const rsc = ctx->rsc;
+  if (!ctx->do_wiener && !ctx->do_sgrproj) return;
+
+  ctx->num_units = num_units;
+  av1_foreach_rest_unit_in_plane(rsc->cm, rsc->plane, get_unit_limits, ctx,
+                                 &rsc->tile_rect, NULL, NULL);
+  aom_atomic_init(&ctx->next_unit, 0);
+  if (ctx->num_workers > 1 && num_units > 1) {
+    av1_rest_unit_stats_mt(cpi, ctx);
+  } else {
+    av1_compute_rest_unit_stats(ctx, ctx->tmpbufs[0]);
+  }
+}
+
 static AOM_INLINE void search_norestore(const RestorationTileLimits *limits,
                                         const AV1PixelRect *tile_rect,
                                         int rest_unit_idx, void *priv,
@@ -1496,6 +1563,22 @@ void av1_pick_filter_restoration(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi) {
   cpi->td.mb.rdmult = cpi->rd.RDMULT;
 
   RestSearchCtxt rsc;
+  RestUnitStatsCtx stats_ctx;
+  memset(&stats_ctx, 0, sizeof(stats_ctx));
+  stats_ctx.rsc = &rsc;
+  stats_ctx.do_wiener = force_restore_type == RESTORE_TYPES ||
+                        force_restore_type == RESTORE_WIENER;
+  stats_ctx.do_sgrproj = force_restore_type == RESTORE_TYPES ||
+                         force_restore_type == RESTORE_SGRPROJ;
+  CHECK_MEM_ERROR(cm, stats_ctx.limits,
+                  aom_malloc(sizeof(*stats_ctx.limits) * ntiles[0]));
+  // The main thread uses the scratch buffer of the common state.
+  stats_ctx.num_workers = AOMMIN(cpi->oxcf.max_threads, ntiles[0]);
+  stats_ctx.tmpbufs[0] = cm->rst_tmpbuf;
+  for (int i = 1; i < stats_ctx.num_workers; ++i) {
+    CHECK_MEM_ERROR(cm, stats_ctx.tmpbufs[i],
+                    (int32_t *)aom_memalign(16, RESTORATION_TMPBUF_SIZE));
+  }
   const int plane_start = AOM_PLANE_Y;
   const int plane_end = num_planes > 1 ? AOM_PLANE_V : AOM_PLANE_Y;
   for (int plane = plane_start; plane <= plane_end; ++plane) {
@@ -1514,6 +1597,7 @@ void av1_pick_filter_restoration(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi) {
       av1_extend_frame(rsc.dgd_buffer, rsc.plane_width, rsc.plane_height,
                        rsc.dgd_stride, RESTORATION_BORDER, RESTORATION_BORDER,
                        highbd);
+      compute_plane_stats(cpi, &stats_ctx, plane_ntiles);
 
       for (RestorationType r = 0; r < num_rtypes; ++r) {
         if ((force_restore_type != RESTORE_TYPES) && (r != RESTORE_NONE) &&
@@ -1540,5 +1624,8 @@ void av1_pick_filter_restoration(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi) {
     }
   }
 
+  for (int i = 1; i < stats_ctx.num_workers; ++i)
+    aom_free(stats_ctx.tmpbufs[i]);
+  aom_free(stats_ctx.limits);
   aom_free(rusi);
 }
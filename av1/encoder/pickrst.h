@@ -17,9 +17,11 @@ extern "C" {
 
 #include "av1/encoder/encoder.h"
 #include "aom_ports/system_state.h"
+#include "aom_util/aom_atomics.h"
 
 struct yv12_buffer_config;
 struct AV1_COMP;
+struct RestSearchCtxt;
 
 static const uint8_t g_shuffle_stats_data[16] = {
   0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8,
@@ -59,6 +61,28 @@ static INLINE uint16_t find_average_highbd(const uint16_t *src, int h_start,
 
 void av1_pick_filter_restoration(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi);
 
+// The statistics pass of the restoration search of a plane. The threads
+// deriving the Wiener and self-guided filters of its restoration units claim
+// them one at a time. The filters only depend on the unit, so the decisions,
+// whose bit costs depend on the previous units, are made afterwards in unit
+// order.
+typedef struct RestUnitStatsCtx {
+  struct RestSearchCtxt *rsc;
+  int do_wiener;
+  int do_sgrproj;
+  // The limits of each restoration unit of the plane.
+  RestorationTileLimits *limits;
+  int num_units;
+  // The next unit to search.
+  aom_atomic_int next_unit;
+  // The self-guided filter scratch buffer of each worker.
+  int32_t *tmpbufs[MAX_NUM_THREADS];
+  int num_workers;
+} RestUnitStatsCtx;
+
+// Derives the filters of the units of 'ctx' not claimed by another thread.
+void av1_compute_rest_unit_stats(RestUnitStatsCtx *ctx, int32_t *tmpbuf);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
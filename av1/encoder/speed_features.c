@@ -208,6 +208,10 @@ static void set_good_speed_feature_framesize_dependent(
     }
 
     if (is_480p_or_larger) sf->tx_type_search.prune_tx_type_using_stats = 2;
+
+    // On large frames, a band of superblock rows is enough to pick the loop
+    // filter level.
+    if (is_720p_or_larger) sf->lpf_pick = LPF_PICK_FROM_SUBIMAGE;
   }
 }
 
@@ -289,6 +293,7 @@ static void set_good_speed_features_framesize_independent(
     sf->prune_comp_search_by_single_result = 1;
     sf->skip_repeated_newmv = 1;
     sf->obmc_full_pixel_search_level = 1;
+    sf->mv.use_motion_field_cache = 1;
     // TODO(Venkat): Clean-up frame type dependency for
     // simple_motion_search_split in partition search function and set the
     // speed feature accordingly
@@ -754,6 +759,7 @@ void av1_set_speed_features_framesize_independent(AV1_COMP *cpi, int speed) {
   sf->disable_adaptive_warp_error_thresh = 1;
   sf->mv.reduce_first_step_size = 0;
   sf->mv.auto_mv_step_size = 0;
+  sf->mv.use_motion_field_cache = 0;
   sf->comp_inter_joint_search_thresh = BLOCK_4X4;
   sf->adaptive_rd_thresh = 0;
   // TODO(sarahparker) Pair this with a speed setting once experiments are done
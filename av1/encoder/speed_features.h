@@ -237,6 +237,12 @@ typedef struct MV_SPEED_FEATURES {
 
   // When to stop subpel search.
   SUBPEL_FORCE_STOP subpel_force_stop;
+
+  // If set to 1, the TPL model reuses the full-pel motion vectors it found
+  // for a pair of source frames when it searches them again. This is lossy:
+  // the reused vectors were found with the motion vector costs of an earlier
+  // frame.
+  int use_motion_field_cache;
 } MV_SPEED_FEATURES;
 
 #define MAX_MESH_STEP 4
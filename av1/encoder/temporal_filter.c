@@ -25,6 +25,7 @@
 #include "av1/encoder/firstpass.h"
 #include "av1/encoder/mcomp.h"
 #include "av1/encoder/encoder.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/ratectrl.h"
 #include "av1/encoder/reconinter_enc.h"
 #include "av1/encoder/segmentation.h"
@@ -865,12 +866,11 @@ void apply_temporal_filter_block(YV12_BUFFER_CONFIG *frame, MACROBLOCKD *mbd,
 }
 #endif  // EXPERIMENT_TEMPORAL_FILTER
 
-static int temporal_filter_find_matching_mb_c(AV1_COMP *cpi,
+static int temporal_filter_find_matching_mb_c(AV1_COMP *cpi, MACROBLOCK *x,
                                               uint8_t *arf_frame_buf,
                                               uint8_t *frame_ptr_buf,
                                               int stride, int x_pos, int y_pos,
                                               MV *blk_mvs, int *blk_bestsme) {
-  MACROBLOCK *const x = &cpi->td.mb;
   MACROBLOCKD *const xd = &x->e_mbd;
   const MV_SPEED_FEATURES *const mv_sf = &cpi->sf.mv;
   int step_param;
@@ -990,29 +990,26 @@ static int temporal_filter_find_matching_mb_c(AV1_COMP *cpi,
 static int get_rows(int h) { return (h + BH - 1) >> BH_LOG2; }
 static int get_cols(int w) { return (w + BW - 1) >> BW_LOG2; }
 
-typedef struct {
-  int64_t sum;
-  int64_t sse;
-} FRAME_DIFF;
-
-static FRAME_DIFF temporal_filter_iterate_c(
-    AV1_COMP *cpi, YV12_BUFFER_CONFIG **frames, int frame_count,
-    int alt_ref_index, int strength, double sigma, int is_key_frame,
-    struct scale_factors *ref_scale_factors) {
+void av1_temporal_filter_rows(AV1_COMP *cpi, ThreadData *td,
+                              TemporalFilterCtx *tf_ctx) {
   const AV1_COMMON *cm = &cpi->common;
   const int num_planes = av1_num_planes(cm);
-  const int mb_cols = get_cols(frames[alt_ref_index]->y_crop_width);
-  const int mb_rows = get_rows(frames[alt_ref_index]->y_crop_height);
+  YV12_BUFFER_CONFIG **frames = tf_ctx->frames;
+  const int frame_count = tf_ctx->frame_count;
+  const int alt_ref_index = tf_ctx->alt_ref_index;
+  const int strength = tf_ctx->strength;
+  const double sigma = tf_ctx->sigma;
+  const int is_key_frame = tf_ctx->is_key_frame;
+  struct scale_factors *ref_scale_factors = tf_ctx->ref_scale_factors;
+  const int mb_cols = tf_ctx->mb_cols;
+  const int mb_rows = tf_ctx->mb_rows;
   int byte;
   int frame;
   int mb_col, mb_row;
-  int mb_y_offset = 0;
-  int mb_y_src_offset = 0;
-  int mb_uv_offset = 0;
-  int mb_uv_src_offset = 0;
   DECLARE_ALIGNED(16, unsigned int, accumulator[BLK_PELS * 3]);
   DECLARE_ALIGNED(16, uint16_t, count[BLK_PELS * 3]);
-  MACROBLOCKD *mbd = &cpi->td.mb.e_mbd;
+  MACROBLOCK *const x = &td->mb;
+  MACROBLOCKD *mbd = &x->e_mbd;
   YV12_BUFFER_CONFIG *f = frames[alt_ref_index];
   uint8_t *dst1, *dst2;
   DECLARE_ALIGNED(32, uint16_t, predictor16[BLK_PELS * 3]);
@@ -1051,9 +1048,13 @@ static FRAME_DIFF temporal_filter_iterate_c(
   MB_MODE_INFO *mbmi_ptr = &mbmi;
   mbd->mi = &mbmi_ptr;
 
-  FRAME_DIFF diff = { 0, 0 };
+  while ((mb_row = aom_atomic_fetch_add(&tf_ctx->next_mb_row, 1)) < mb_rows) {
+    FRAME_DIFF *const diff = &tf_ctx->row_diff[mb_row];
+    int mb_y_offset = mb_row * BH * cpi->alt_ref_buffer.y_stride;
+    int mb_y_src_offset = mb_row * BH * f->y_stride;
+    int mb_uv_offset = mb_row * mb_uv_height * cpi->alt_ref_buffer.uv_stride;
+    int mb_uv_src_offset = mb_row * mb_uv_height * f->uv_stride;
 
-  for (mb_row = 0; mb_row < mb_rows; mb_row++) {
     // Source frames are extended to 16 pixels. This is different than
     //  L/A/G reference frames that have a border of 32 (AV1ENCBORDERINPIXELS)
     // A 6/8 tap filter is used for motion search.  This requires 2 pixels
@@ -1065,9 +1066,8 @@ static FRAME_DIFF temporal_filter_iterate_c(
     //  8 - AOM_INTERP_EXTEND.
     // To keep the mv in play for both Y and UV planes the max that it
     //  can be on a border is therefore 16 - (2*AOM_INTERP_EXTEND+1).
-    cpi->td.mb.mv_limits.row_min =
-        -((mb_row * BH) + (17 - 2 * AOM_INTERP_EXTEND));
-    cpi->td.mb.mv_limits.row_max =
+    x->mv_limits.row_min = -((mb_row * BH) + (17 - 2 * AOM_INTERP_EXTEND));
+    x->mv_limits.row_max =
         ((mb_rows - 1 - mb_row) * BH) + (17 - 2 * AOM_INTERP_EXTEND);
 
     for (mb_col = 0; mb_col < mb_cols; mb_col++) {
@@ -1077,9 +1077,8 @@ static FRAME_DIFF temporal_filter_iterate_c(
       memset(accumulator, 0, BLK_PELS * 3 * sizeof(accumulator[0]));
       memset(count, 0, BLK_PELS * 3 * sizeof(count[0]));
 
-      cpi->td.mb.mv_limits.col_min =
-          -((mb_col * BW) + (17 - 2 * AOM_INTERP_EXTEND));
-      cpi->td.mb.mv_limits.col_max =
+      x->mv_limits.col_min = -((mb_col * BW) + (17 - 2 * AOM_INTERP_EXTEND));
+      x->mv_limits.col_max =
           ((mb_cols - 1 - mb_col) * BW) + (17 - 2 * AOM_INTERP_EXTEND);
 
       for (frame = 0; frame < frame_count; frame++) {
@@ -1109,7 +1108,7 @@ static FRAME_DIFF temporal_filter_iterate_c(
 
           // Find best match in this frame by MC
           int err = temporal_filter_find_matching_mb_c(
-              cpi, frames[alt_ref_index]->y_buffer + mb_y_src_offset,
+              cpi, x, frames[alt_ref_index]->y_buffer + mb_y_src_offset,
               frames[frame]->y_buffer + mb_y_src_offset,
               frames[frame]->y_stride, mb_col * BW, mb_row * BH, blk_mvs,
               blk_bestsme);
@@ -1326,8 +1325,8 @@ static FRAME_DIFF temporal_filter_iterate_c(
         unsigned int sse = 0;
         cpi->fn_ptr[bsize].vf(src, src_stride, dst1, stride, &sse);
 
-        diff.sum += sse;
-        diff.sse += sse * sse;
+        diff->sum += sse;
+        diff->sse += sse * sse;
       }
 
       mb_y_offset += BW;
@@ -1335,18 +1334,12 @@ static FRAME_DIFF temporal_filter_iterate_c(
       mb_uv_offset += mb_uv_width;
       mb_uv_src_offset += mb_uv_width;
     }
-    mb_y_offset += BH * cpi->alt_ref_buffer.y_stride - BW * mb_cols;
-    mb_y_src_offset += BH * f->y_stride - BW * mb_cols;
-    mb_uv_src_offset += mb_uv_height * f->uv_stride - mb_uv_width * mb_cols;
-    mb_uv_offset +=
-        mb_uv_height * cpi->alt_ref_buffer.uv_stride - mb_uv_width * mb_cols;
   }
 
   // Restore input state
   for (i = 0; i < num_planes; i++) mbd->plane[i].pre[0].buf = input_buffer[i];
 
   mbd->mi = backup_mi_grid;
-  return diff;
 }
 
 // This is an adaptation of the mehtod in the following paper:
@@ -1436,21 +1429,11 @@ static int estimate_strength(AV1_COMP *cpi, int distance, int group_boost,
   else
     q = ((int)av1_convert_qindex_to_q(cpi->rc.avg_frame_qindex[KEY_FRAME],
                                       cpi->common.seq_params.bit_depth));
-  MACROBLOCKD *mbd = &cpi->td.mb.e_mbd;
   struct lookahead_entry *buf = av1_lookahead_peek(cpi->lookahead, distance);
   int strength;
-  double noiselevel;
-  if (is_cur_buf_hbd(mbd)) {
-    noiselevel = highbd_estimate_noise(
-        buf->img.y_buffer, buf->img.y_crop_width, buf->img.y_crop_height,
-        buf->img.y_stride, mbd->bd, EDGE_THRESHOLD);
-    *sigma = noiselevel;
-  } else {
-    noiselevel = estimate_noise(buf->img.y_buffer, buf->img.y_crop_width,
-                                buf->img.y_crop_height, buf->img.y_stride,
-                                EDGE_THRESHOLD);
-    *sigma = noiselevel;
-  }
+  const double noiselevel =
+      av1_lookahead_get_stats(cpi->lookahead, buf)->noise_level;
+  *sigma = noiselevel;
   int adj_strength = cpi->oxcf.arnr_strength;
   if (noiselevel > 0) {
     // Get 4 integer adjustment levels in [-2, 1]
@@ -1513,6 +1496,7 @@ static void adjust_arnr_filter(AV1_COMP *cpi, int distance, int group_boost,
 
 int av1_temporal_filter(AV1_COMP *cpi, int distance,
                         int *show_existing_alt_ref) {
+  AV1_COMMON *const cm = &cpi->common;
   RATE_CONTROL *const rc = &cpi->rc;
   int frame;
   int frames_to_blur;
@@ -1586,14 +1570,39 @@ int av1_temporal_filter(AV1_COMP *cpi, int distance,
         frames[0]->y_crop_width, frames[0]->y_crop_height);
   }
 
-  FRAME_DIFF diff = temporal_filter_iterate_c(cpi, frames, frames_to_blur,
-                                              frames_to_blur_backward, strength,
-                                              sigma, distance == -1, &sf);
+  TemporalFilterCtx tf_ctx;
+  tf_ctx.frames = frames;
+  tf_ctx.frame_count = frames_to_blur;
+  tf_ctx.alt_ref_index = frames_to_blur_backward;
+  tf_ctx.strength = strength;
+  tf_ctx.sigma = sigma;
+  tf_ctx.is_key_frame = distance == -1;
+  tf_ctx.ref_scale_factors = &sf;
+  tf_ctx.mb_cols = get_cols(frames[frames_to_blur_backward]->y_crop_width);
+  tf_ctx.mb_rows = get_rows(frames[frames_to_blur_backward]->y_crop_height);
+  aom_atomic_init(&tf_ctx.next_mb_row, 0);
+  CHECK_MEM_ERROR(cm, tf_ctx.row_diff,
+                  aom_calloc(tf_ctx.mb_rows, sizeof(*tf_ctx.row_diff)));
+
+  // The shared exhaustive search counters would make the motion search depend
+  // on the order in which the threads filter the blocks.
+  cpi->td.mb.m_search_count_ptr = NULL;
+  cpi->td.mb.ex_search_count_ptr = NULL;
+  if (cpi->oxcf.max_threads > 1 && tf_ctx.mb_rows > 1)
+    av1_temporal_filter_mt(cpi, &tf_ctx);
+  else
+    av1_temporal_filter_rows(cpi, &cpi->td, &tf_ctx);
+
+  FRAME_DIFF diff = { 0, 0 };
+  for (int mb_row = 0; mb_row < tf_ctx.mb_rows; ++mb_row) {
+    diff.sum += tf_ctx.row_diff[mb_row].sum;
+    diff.sse += tf_ctx.row_diff[mb_row].sse;
+  }
+  aom_free(tf_ctx.row_diff);
 
   if (distance == -1) return 1;
 
   if (show_existing_alt_ref != NULL && cpi->sf.adaptive_overlay_encoding) {
-    AV1_COMMON *const cm = &cpi->common;
     int top_index = 0, bottom_index = 0;
 
     aom_clear_system_state();
@@ -1605,10 +1614,7 @@ int av1_temporal_filter(AV1_COMP *cpi, int distance,
                                            &bottom_index, &top_index);
     const int ac_q = av1_ac_quant_QTX(q, 0, cm->seq_params.bit_depth);
     const int ac_q_2 = ac_q * ac_q;
-    const int mb_cols = get_cols(frames[frames_to_blur_backward]->y_crop_width);
-    const int mb_rows =
-        get_rows(frames[frames_to_blur_backward]->y_crop_height);
-    const int mbs = AOMMAX(1, mb_rows * mb_cols);
+    const int mbs = AOMMAX(1, tf_ctx.mb_rows * tf_ctx.mb_cols);
     const float mean = (float)diff.sum / mbs;
     const float std = (float)sqrt((float)diff.sse / mbs - mean * mean);
     const float threshold = 0.7f;
@@ -12,6 +12,8 @@
 #ifndef AOM_AV1_ENCODER_TEMPORAL_FILTER_H_
 #define AOM_AV1_ENCODER_TEMPORAL_FILTER_H_
 
+#include "aom_util/aom_atomics.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -47,8 +49,37 @@ static INLINE BLOCK_SIZE dims_to_size(int w, int h) {
   }
 }
 
+typedef struct {
+  int64_t sum;
+  int64_t sse;
+} FRAME_DIFF;
+
+// The temporal filtering of a frame. Its block rows are independent, so the
+// threads filtering it claim them one at a time.
+typedef struct TemporalFilterCtx {
+  YV12_BUFFER_CONFIG **frames;
+  int frame_count;
+  int alt_ref_index;
+  int strength;
+  double sigma;
+  int is_key_frame;
+  struct scale_factors *ref_scale_factors;
+  int mb_rows;
+  int mb_cols;
+  // The next block row to filter.
+  aom_atomic_int next_mb_row;
+  // The difference between the source and the filtered source in each block
+  // row. They are summed in row order, so the result does not depend on the
+  // number of threads.
+  FRAME_DIFF *row_diff;
+} TemporalFilterCtx;
+
 int av1_temporal_filter(AV1_COMP *cpi, int distance,
                         int *show_existing_alt_ref);
+// Filters the block rows of 'tf_ctx' not claimed by another thread, using the
+// MACROBLOCK of 'td'.
+void av1_temporal_filter_rows(AV1_COMP *cpi, ThreadData *td,
+                              TemporalFilterCtx *tf_ctx);
 double estimate_noise(const uint8_t *src, int width, int height, int stride,
                       int edge_thresh);
 double highbd_estimate_noise(const uint8_t *src8, int width, int height,
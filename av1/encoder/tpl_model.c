@@ -11,6 +11,7 @@
 
 #include <stdint.h>
 #include <float.h>
+#include <string.h>
 
 #include "config/aom_config.h"
 #include "config/aom_dsp_rtcd.h"
@@ -26,6 +27,7 @@
 
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/encode_strategy.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/hybrid_fwd_txfm.h"
 #include "av1/encoder/rdopt.h"
 #include "av1/encoder/reconinter_enc.h"
@@ -85,7 +87,7 @@ static uint32_t motion_estimation(AV1_COMP *cpi, MACROBLOCK *x,
                                   uint8_t *cur_frame_buf,
                                   uint8_t *ref_frame_buf, int stride,
                                   int stride_ref, BLOCK_SIZE bsize, int mi_row,
-                                  int mi_col) {
+                                  int mi_col, MotionField *motion_field) {
   AV1_COMMON *cm = &cpi->common;
   MACROBLOCKD *const xd = &x->e_mbd;
   MV_SPEED_FEATURES *const mv_sf = &cpi->sf.mv;
@@ -114,16 +116,34 @@ static uint32_t motion_estimation(AV1_COMP *cpi, MACROBLOCK *x,
   step_param = mv_sf->reduce_first_step_size;
   step_param = AOMMIN(step_param, MAX_MVSEARCH_STEPS - 2);
 
-  av1_set_mv_search_range(&x->mv_limits, &best_ref_mv1);
-
-  av1_init3smotion_compensation(&ss_cfg, stride_ref);
-  av1_full_pixel_search(cpi, x, bsize, &best_ref_mv1_full, step_param,
-                        search_method, 0, sadpb, cond_cost_list(cpi, cost_list),
-                        &best_ref_mv1, INT_MAX, 0, (MI_SIZE * mi_col),
-                        (MI_SIZE * mi_row), 0, &ss_cfg, 0);
-
-  /* restore UMV window */
-  x->mv_limits = tmp_mv_limits;
+  const int mb_idx =
+      motion_field != NULL
+          ? (mi_row / mi_size_high[bsize]) * motion_field->cols +
+                mi_col / mi_size_wide[bsize]
+          : 0;
+  if (motion_field != NULL && motion_field->errs[mb_idx] != INT_MAX) {
+    // These blocks were searched for an earlier TPL model.
+    x->best_mv.as_mv = motion_field->mvs[mb_idx];
+    memcpy(cost_list, motion_field->cost_lists[mb_idx], sizeof(cost_list));
+  } else {
+    for (int i = 0; i < 5; ++i) cost_list[i] = INT_MAX;
+    av1_set_mv_search_range(&x->mv_limits, &best_ref_mv1);
+
+    av1_init3smotion_compensation(&ss_cfg, stride_ref);
+    const int err = av1_full_pixel_search(
+        cpi, x, bsize, &best_ref_mv1_full, step_param, search_method, 0, sadpb,
+        cond_cost_list(cpi, cost_list), &best_ref_mv1, INT_MAX, 0,
+        (MI_SIZE * mi_col), (MI_SIZE * mi_row), 0, &ss_cfg, 0);
+
+    /* restore UMV window */
+    x->mv_limits = tmp_mv_limits;
+
+    if (motion_field != NULL) {
+      motion_field->mvs[mb_idx] = x->best_mv.as_mv;
+      motion_field->errs[mb_idx] = AOMMIN(err, INT_MAX - 1);
+      memcpy(motion_field->cost_lists[mb_idx], cost_list, sizeof(cost_list));
+    }
+  }
 
   const int pw = block_size_wide[bsize];
   const int ph = block_size_high[bsize];
@@ -141,7 +161,8 @@ static AOM_INLINE void mode_estimation(
     int frame_idx, int16_t *src_diff, tran_low_t *coeff, tran_low_t *qcoeff,
     tran_low_t *dqcoeff, int mi_row, int mi_col, BLOCK_SIZE bsize,
     TX_SIZE tx_size, const YV12_BUFFER_CONFIG *ref_frame[],
-    const YV12_BUFFER_CONFIG *src_ref_frame[], uint8_t *predictor,
+    const YV12_BUFFER_CONFIG *src_ref_frame[],
+    MotionField *const motion_field[], uint8_t *predictor,
     int64_t *recon_error, int64_t *sse, TplDepStats *tpl_stats) {
   AV1_COMMON *cm = &cpi->common;
   const GF_GROUP *gf_group = &cpi->gf_group;
@@ -238,7 +259,7 @@ static AOM_INLINE void mode_estimation(
     int ref_stride = ref_frame_ptr->y_stride;
 
     motion_estimation(cpi, x, src_mb_buffer, ref_mb, src_stride, ref_stride,
-                      bsize, mi_row, mi_col);
+                      bsize, mi_row, mi_col, motion_field[rf_idx]);
 
     ConvolveParams conv_params = get_conv_params(0, 0, xd->bd);
     WarpTypesAllowed warp_types;
@@ -559,27 +580,14 @@ static YV12_BUFFER_CONFIG *get_framebuf(
   }
 }
 
-static AOM_INLINE void mc_flow_dispenser(AV1_COMP *cpi, int frame_idx,
-                                         int pframe_qindex) {
-  const GF_GROUP *gf_group = &cpi->gf_group;
-  if (frame_idx == gf_group->size) return;
-  TplDepFrame *tpl_frame = &cpi->tpl_frame[frame_idx];
-  const YV12_BUFFER_CONFIG *this_frame = tpl_frame->gf_picture;
-  const YV12_BUFFER_CONFIG *ref_frame[7] = { NULL, NULL, NULL, NULL,
-                                             NULL, NULL, NULL };
-  unsigned int ref_frame_display_index[7];
-  MV_REFERENCE_FRAME ref[2] = { LAST_FRAME, INTRA_FRAME };
-  const int max_allowed_refs = get_max_allowed_ref_frames(cpi);
-  const YV12_BUFFER_CONFIG *src_frame[7] = { NULL, NULL, NULL, NULL,
-                                             NULL, NULL, NULL };
-
+void av1_tpl_mc_flow_rows(AV1_COMP *cpi, ThreadData *td,
+                          TplFrameCtx *tpl_ctx) {
   AV1_COMMON *cm = &cpi->common;
-  struct scale_factors sf;
-  int rdmult, idx;
-  ThreadData *td = &cpi->td;
+  const int frame_idx = tpl_ctx->frame_idx;
+  TplDepFrame *tpl_frame = &cpi->tpl_frame[frame_idx];
   MACROBLOCK *x = &td->mb;
   MACROBLOCKD *xd = &x->e_mbd;
-  int mi_row, mi_col;
+  int mb_row, mi_col;
   const BLOCK_SIZE bsize = convert_length_to_bsize(MC_FLOW_BSIZE_1D);
   av1_tile_init(&xd->tile, cm, 0, 0);
 
@@ -592,19 +600,98 @@ static AOM_INLINE void mc_flow_dispenser(AV1_COMP *cpi, int frame_idx,
   const TX_SIZE tx_size = max_txsize_lookup[bsize];
   const int mi_height = mi_size_high[bsize];
   const int mi_width = mi_size_wide[bsize];
+  const int mb_cols = (cm->mi_cols + mi_width - 1) / mi_width;
 
   int64_t recon_error = 1, sse = 1;
 
-  // Setup scaling factor
-  av1_setup_scale_factors_for_frame(
-      &sf, this_frame->y_crop_width, this_frame->y_crop_height,
-      this_frame->y_crop_width, this_frame->y_crop_height);
-
-  xd->cur_buf = this_frame;
+  xd->cur_buf = tpl_frame->gf_picture;
 
   uint8_t *predictor =
       is_cur_buf_hbd(xd) ? CONVERT_TO_BYTEPTR(predictor8) : predictor8;
 
+  // Make a temporary mbmi for tpl model
+  MB_MODE_INFO mbmi;
+  memset(&mbmi, 0, sizeof(mbmi));
+  MB_MODE_INFO *mbmi_ptr = &mbmi;
+  xd->mi = &mbmi_ptr;
+
+  xd->block_ref_scale_factors[0] = &tpl_ctx->sf;
+
+  while ((mb_row = aom_atomic_fetch_add(&tpl_ctx->next_mb_row, 1)) <
+         tpl_ctx->mb_rows) {
+    const int mi_row = mb_row * mi_height;
+    // Motion estimation row boundary
+    x->mv_limits.row_min = -((mi_row * MI_SIZE) + (17 - 2 * AOM_INTERP_EXTEND));
+    x->mv_limits.row_max = (cm->mi_rows - mi_height - mi_row) * MI_SIZE +
+                           (17 - 2 * AOM_INTERP_EXTEND);
+    xd->mb_to_top_edge = -((mi_row * MI_SIZE) * 8);
+    xd->mb_to_bottom_edge = ((cm->mi_rows - mi_height - mi_row) * MI_SIZE) * 8;
+    for (mi_col = 0; mi_col < cm->mi_cols; mi_col += mi_width) {
+      const int mb_col = mi_col / mi_width;
+      TplDepStats tpl_stats;
+
+      // Wait for the above and above right blocks, which the intra prediction
+      // uses.
+      tpl_ctx->sync_read(tpl_ctx->row_mt_sync, mb_row, mb_col);
+
+      // Motion estimation column boundary
+      x->mv_limits.col_min =
+          -((mi_col * MI_SIZE) + (17 - 2 * AOM_INTERP_EXTEND));
+      x->mv_limits.col_max = ((cm->mi_cols - mi_width - mi_col) * MI_SIZE) +
+                             (17 - 2 * AOM_INTERP_EXTEND);
+      xd->mb_to_left_edge = -((mi_col * MI_SIZE) * 8);
+      xd->mb_to_right_edge = ((cm->mi_cols - mi_width - mi_col) * MI_SIZE) * 8;
+      mode_estimation(cpi, x, xd, &tpl_ctx->sf, frame_idx, src_diff, coeff,
+                      qcoeff, dqcoeff, mi_row, mi_col, bsize, tx_size,
+                      tpl_ctx->ref_frame, tpl_ctx->src_frame,
+                      tpl_ctx->motion_field, predictor, &recon_error, &sse,
+                      &tpl_stats);
+
+      // Motion flow dependency dispenser.
+      tpl_model_store(cpi, tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize,
+                      tpl_frame->stride, &tpl_stats);
+
+      tpl_ctx->sync_write(tpl_ctx->row_mt_sync, mb_row, mb_col, mb_cols);
+    }
+  }
+}
+
+static AOM_INLINE void mc_flow_dispenser(AV1_COMP *cpi, int frame_idx,
+                                         int pframe_qindex) {
+  const GF_GROUP *gf_group = &cpi->gf_group;
+  if (frame_idx == gf_group->size) return;
+  TplDepFrame *tpl_frame = &cpi->tpl_frame[frame_idx];
+  const YV12_BUFFER_CONFIG *this_frame = tpl_frame->gf_picture;
+  TplFrameCtx tpl_ctx;
+  const YV12_BUFFER_CONFIG **ref_frame = tpl_ctx.ref_frame;
+  unsigned int ref_frame_display_index[7];
+  MV_REFERENCE_FRAME ref[2] = { LAST_FRAME, INTRA_FRAME };
+  const int max_allowed_refs = get_max_allowed_ref_frames(cpi);
+  const YV12_BUFFER_CONFIG **src_frame = tpl_ctx.src_frame;
+
+  AV1_COMMON *cm = &cpi->common;
+  int rdmult, idx;
+  MACROBLOCK *x = &cpi->td.mb;
+  const BLOCK_SIZE bsize = convert_length_to_bsize(MC_FLOW_BSIZE_1D);
+  const int mi_height = mi_size_high[bsize];
+  const int mi_width = mi_size_wide[bsize];
+  const int mb_cols = (cm->mi_cols + mi_width - 1) / mi_width;
+
+  // Make a temporary mbmi for the quantizer setup
+  MB_MODE_INFO mbmi;
+  memset(&mbmi, 0, sizeof(mbmi));
+  MB_MODE_INFO *mbmi_ptr = &mbmi;
+  x->e_mbd.mi = &mbmi_ptr;
+
+  tpl_ctx.frame_idx = frame_idx;
+  tpl_ctx.mb_rows = (cm->mi_rows + mi_height - 1) / mi_height;
+  aom_atomic_init(&tpl_ctx.next_mb_row, 0);
+
+  // Setup scaling factor
+  av1_setup_scale_factors_for_frame(
+      &tpl_ctx.sf, this_frame->y_crop_width, this_frame->y_crop_height,
+      this_frame->y_crop_width, this_frame->y_crop_height);
+
   for (idx = 0; idx < INTER_REFS_PER_FRAME; ++idx) {
     TplDepFrame *tpl_ref_frame = &cpi->tpl_frame[tpl_frame->ref_map_index[idx]];
     ref_frame[idx] = cpi->tpl_frame[tpl_frame->ref_map_index[idx]].rec_picture;
@@ -638,13 +725,28 @@ static AOM_INLINE void mc_flow_dispenser(AV1_COMP *cpi, int frame_idx,
     ref_frame[ref_frame_to_disable - 1] = NULL;
   }
 
-  // Make a temporary mbmi for tpl model
-  MB_MODE_INFO mbmi;
-  memset(&mbmi, 0, sizeof(mbmi));
-  MB_MODE_INFO *mbmi_ptr = &mbmi;
-  xd->mi = &mbmi_ptr;
-
-  xd->block_ref_scale_factors[0] = &sf;
+  // Keep the motion vectors of the pairs of source frames of the lookahead,
+  // and reuse the ones found for an earlier TPL model.
+  const struct lookahead_entry *const src_entry =
+      cpi->sf.mv.use_motion_field_cache
+          ? av1_lookahead_find(cpi->lookahead, this_frame)
+          : NULL;
+  for (idx = 0; idx < INTER_REFS_PER_FRAME; ++idx) {
+    tpl_ctx.motion_field[idx] = NULL;
+    if (src_entry == NULL || ref_frame[idx] == NULL) continue;
+    const struct lookahead_entry *const ref_entry =
+        av1_lookahead_find(cpi->lookahead, src_frame[idx]);
+    if (ref_entry == NULL) continue;
+    MotionField *field = av1_find_motion_field(
+        &cpi->motion_field_cache, src_entry->ts_start, ref_entry->ts_start,
+        bsize, pframe_qindex, tpl_ctx.mb_rows, mb_cols);
+    if (field == NULL) {
+      field = av1_add_motion_field(
+          &cpi->motion_field_cache, src_entry->ts_start, ref_entry->ts_start,
+          bsize, pframe_qindex, tpl_ctx.mb_rows, mb_cols);
+    }
+    tpl_ctx.motion_field[idx] = field;
+  }
 
   const int base_qindex = pframe_qindex;
   // Get rd multiplier set up.
@@ -661,31 +763,26 @@ static AOM_INLINE void mc_flow_dispenser(AV1_COMP *cpi, int frame_idx,
   tpl_frame->base_rdmult =
       av1_compute_rd_mult_based_on_qindex(cpi, pframe_qindex) / 6;
 
-  for (mi_row = 0; mi_row < cm->mi_rows; mi_row += mi_height) {
-    // Motion estimation row boundary
-    x->mv_limits.row_min = -((mi_row * MI_SIZE) + (17 - 2 * AOM_INTERP_EXTEND));
-    x->mv_limits.row_max = (cm->mi_rows - mi_height - mi_row) * MI_SIZE +
-                           (17 - 2 * AOM_INTERP_EXTEND);
-    xd->mb_to_top_edge = -((mi_row * MI_SIZE) * 8);
-    xd->mb_to_bottom_edge = ((cm->mi_rows - mi_height - mi_row) * MI_SIZE) * 8;
-    for (mi_col = 0; mi_col < cm->mi_cols; mi_col += mi_width) {
-      TplDepStats tpl_stats;
-
-      // Motion estimation column boundary
-      x->mv_limits.col_min =
-          -((mi_col * MI_SIZE) + (17 - 2 * AOM_INTERP_EXTEND));
-      x->mv_limits.col_max = ((cm->mi_cols - mi_width - mi_col) * MI_SIZE) +
-                             (17 - 2 * AOM_INTERP_EXTEND);
-      xd->mb_to_left_edge = -((mi_col * MI_SIZE) * 8);
-      xd->mb_to_right_edge = ((cm->mi_cols - mi_width - mi_col) * MI_SIZE) * 8;
-      mode_estimation(cpi, x, xd, &sf, frame_idx, src_diff, coeff, qcoeff,
-                      dqcoeff, mi_row, mi_col, bsize, tx_size, ref_frame,
-                      src_frame, predictor, &recon_error, &sse, &tpl_stats);
-
-      // Motion flow dependency dispenser.
-      tpl_model_store(cpi, tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize,
-                      tpl_frame->stride, &tpl_stats);
+  // The motion search counters are shared by the blocks of a tile.
+  x->m_search_count_ptr = NULL;
+  x->ex_search_count_ptr = NULL;
+  if (cpi->oxcf.max_threads > 1 && tpl_ctx.mb_rows > 1) {
+    AV1RowMTSync *const row_mt_sync = &cpi->tpl_row_mt_sync;
+    if (row_mt_sync->rows != tpl_ctx.mb_rows) {
+      av1_row_mt_sync_mem_dealloc(row_mt_sync);
+      av1_row_mt_sync_mem_alloc(row_mt_sync, cm, tpl_ctx.mb_rows);
     }
+    memset(row_mt_sync->cur_col, -1,
+           sizeof(*row_mt_sync->cur_col) * tpl_ctx.mb_rows);
+    tpl_ctx.row_mt_sync = row_mt_sync;
+    tpl_ctx.sync_read = av1_row_mt_sync_read;
+    tpl_ctx.sync_write = av1_row_mt_sync_write;
+    av1_tpl_mc_flow_mt(cpi, &tpl_ctx);
+  } else {
+    tpl_ctx.row_mt_sync = NULL;
+    tpl_ctx.sync_read = av1_row_mt_sync_read_dummy;
+    tpl_ctx.sync_write = av1_row_mt_sync_write_dummy;
+    av1_tpl_mc_flow_rows(cpi, &cpi->td, &tpl_ctx);
   }
 }
 
@@ -877,6 +974,28 @@ static AOM_INLINE void init_tpl_stats(AV1_COMP *cpi) {
   }
 }
 
+// Returns 1 if a buffer of the lookahead holds the frame with time stamp 'ts'.
+static int lookahead_has_frame(const struct lookahead_ctx *ctx, int64_t ts) {
+  for (int i = 0; i < ctx->max_sz; ++i) {
+    if (ctx->buf[i].ts_start == ts) return 1;
+  }
+  return 0;
+}
+
+// Frees the motion fields of the frames that have left the lookahead, which
+// cannot be searched again.
+static void free_departed_motion_fields(AV1_COMP *cpi) {
+  for (int i = 0; i < MOTION_FIELD_CACHE_SIZE; ++i) {
+    MotionField *const field = &cpi->motion_field_cache.fields[i];
+    if (field->alloc_size == 0) continue;
+    if (!field->in_use ||
+        !lookahead_has_frame(cpi->lookahead, field->src_ts) ||
+        !lookahead_has_frame(cpi->lookahead, field->ref_ts)) {
+      av1_free_motion_field(field);
+    }
+  }
+}
+
 void av1_tpl_setup_stats(AV1_COMP *cpi,
                          const EncodeFrameParams *const frame_params,
                          const EncodeFrameInput *const frame_input) {
@@ -912,6 +1031,8 @@ void av1_tpl_setup_stats(AV1_COMP *cpi,
   init_tpl_stats(cpi);
 
   if (cpi->oxcf.enable_tpl_model == 1) {
+    free_departed_motion_fields(cpi);
+
     // Backward propagation from tpl_group_frames to 1.
     for (int frame_idx = gf_group->index; frame_idx < cpi->tpl_gf_group_frames;
          ++frame_idx) {
@@ -1053,7 +1174,7 @@ static AOM_INLINE void get_tpl_forward_stats(AV1_COMP *cpi, MACROBLOCK *x,
           mi_row * MI_SIZE * ref->y_stride + mi_col * MI_SIZE;
       motion_estimation(cpi, x, src->y_buffer + mb_y_offset,
                         ref->y_buffer + mb_y_offset_ref, src->y_stride,
-                        ref->y_stride, bsize, mi_row, mi_col);
+                        ref->y_stride, bsize, mi_row, mi_col, NULL);
 
       av1_build_inter_predictor(
           ref->y_buffer + mb_y_offset_ref, ref->y_stride, predictor, bw,
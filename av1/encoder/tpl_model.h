@@ -12,6 +12,9 @@
 #ifndef AOM_AV1_ENCODER_TPL_MODEL_H_
 #define AOM_AV1_ENCODER_TPL_MODEL_H_
 
+#include "aom_util/aom_atomics.h"
+#include "av1/encoder/motion_field.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -29,12 +32,36 @@ static INLINE BLOCK_SIZE convert_length_to_bsize(int length) {
   }
 }
 
+// The TPL model of a frame. The threads computing it claim its block rows
+// one at a time, and a row waits for the blocks above and above right of
+// each of its blocks, which its intra prediction uses.
+typedef struct TplFrameCtx {
+  int frame_idx;
+  struct scale_factors sf;
+  const YV12_BUFFER_CONFIG *ref_frame[INTER_REFS_PER_FRAME];
+  const YV12_BUFFER_CONFIG *src_frame[INTER_REFS_PER_FRAME];
+  // The cached motion field of the frame in each source reference frame, or
+  // NULL.
+  MotionField *motion_field[INTER_REFS_PER_FRAME];
+  int mb_rows;
+  // The next block row to compute.
+  aom_atomic_int next_mb_row;
+  AV1RowMTSync *row_mt_sync;
+  void (*sync_read)(AV1RowMTSync *const, int, int);
+  void (*sync_write)(AV1RowMTSync *const, int, int, const int);
+} TplFrameCtx;
+
 void av1_tpl_setup_stats(AV1_COMP *cpi,
                          const EncodeFrameParams *const frame_params,
                          const EncodeFrameInput *const frame_input);
 
 void av1_tpl_setup_forward_stats(AV1_COMP *cpi);
 
+// Computes the block rows of 'tpl_ctx' not claimed by another thread, using
+// the MACROBLOCK of 'td'.
+void av1_tpl_mc_flow_rows(AV1_COMP *cpi, ThreadData *td,
+                          TplFrameCtx *tpl_ctx);
+
 int av1_tpl_ptr_pos(AV1_COMP *cpi, int mi_row, int mi_col, int stride);
 
 void av1_tpl_rdmult_setup(AV1_COMP *cpi);
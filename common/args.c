@@ -11,6 +11,7 @@
 
 #include "common/args.h"
 
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
@@ -209,6 +210,22 @@ int arg_parse_int(const struct arg *arg) {
   return 0;
 }
 
+int64_t arg_parse_int64(const struct arg *arg) {
+  char *endptr;
+  errno = 0;
+  const long long rawval = strtoll(arg->val, &endptr, 10);  // NOLINT
+
+  if (arg->val[0] != '\0' && endptr[0] == '\0') {
+    if (errno != ERANGE) return (int64_t)rawval;
+
+    die("Option %s: Value %s out of range for signed 64-bit int\n", arg->name,
+        arg->val);
+  }
+
+  die("Option %s: Invalid character '%c'\n", arg->name, *endptr);
+  return 0;
+}
+
 struct aom_rational {
   int num; /**< fraction numerator */
   int den; /**< fraction denominator */
@@ -482,4 +482,33 @@ int obudec_read_temporal_unit(struct ObuDecInputContext *obu_ctx,
   return 0;
 }
 
+int64_t obudec_tell_temporal_unit(struct ObuDecInputContext *obu_ctx) {
+  const int64_t pos = (int64_t)ftello(obu_ctx->avx_ctx->file);
+  if (pos < 0) return -1;
+  // The buffered data, the start of the next Temporal Unit, has been read
+  // from the file.
+  return pos - (int64_t)obu_ctx->bytes_buffered;
+}
+
+int obudec_seek_temporal_unit(struct ObuDecInputContext *obu_ctx,
+                              int64_t offset) {
+  FILE *const f = obu_ctx->avx_ctx->file;
+  if (fseeko(f, (FileOffset)offset, SEEK_SET) != 0) return -1;
+  obu_ctx->bytes_buffered = 0;
+  if (obu_ctx->is_annexb) return 0;
+
+  // obudec_read_temporal_unit() expects the Temporal Delimiter that starts
+  // the Temporal Unit to be buffered.
+  ObuHeader obu_header;
+  size_t obu_size = 0;
+  memset(&obu_header, 0, sizeof(obu_header));
+  if (obudec_read_one_obu(f, &obu_ctx->buffer, 0, &obu_ctx->buffer_capacity,
+                          &obu_size, &obu_header, 0) != 0 ||
+      obu_header.type != OBU_TEMPORAL_DELIMITER) {
+    return -1;
+  }
+  obu_ctx->bytes_buffered = obu_size;
+  return 0;
+}
+
 void obudec_free(struct ObuDecInputContext *obu_ctx) { free(obu_ctx->buffer); }
@@ -39,6 +39,15 @@ int obudec_read_temporal_unit(struct ObuDecInputContext *obu_ctx,
                               uint8_t **buffer, size_t *bytes_read,
                               size_t *buffer_size);
 
+// Returns the offset in the input file of the next Temporal Unit, or -1 on
+// error.
+int64_t obudec_tell_temporal_unit(struct ObuDecInputContext *obu_ctx);
+
+// Makes the Temporal Unit at 'offset', a value returned by
+// obudec_tell_temporal_unit(), the next one read. Returns 0 on success.
+int obudec_seek_temporal_unit(struct ObuDecInputContext *obu_ctx,
+                              int64_t offset);
+
 void obudec_free(struct ObuDecInputContext *obu_ctx);
 
 #ifdef __cplusplus
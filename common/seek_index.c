@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aom_ports/mem_ops.h"
+#include "av1/common/obu_util.h"
+#include "common/seek_index.h"
+
+#define SEEK_INDEX_SIGNATURE "AOMS"
+#define SEEK_INDEX_HEADER_SIZE 32
+#define SEEK_INDEX_ENTRY_SIZE 16
+
+static void put_le64(uint8_t *mem, int64_t value) {
+  mem_put_le32(mem, (MEM_VALUE_T)(value & 0xFFFFFFFF));
+  mem_put_le32(mem + 4, (MEM_VALUE_T)((uint64_t)value >> 32));
+}
+
+static int64_t get_le64(const uint8_t *mem) {
+  return (int64_t)(mem_get_le32(mem) | ((uint64_t)mem_get_le32(mem + 4) << 32));
+}
+
+// Returns 1 if the frame header in 'data' is the one of a shown key frame.
+static int is_shown_key_frame(const uint8_t *data, size_t size,
+                              int reduced_still_picture_header) {
+  if (reduced_still_picture_header) return 1;
+  if (size == 0) return 0;
+  // show_existing_frame f(1), frame_type f(2), show_frame f(1).
+  const int show_existing_frame = (data[0] >> 7) & 1;
+  const int frame_type = (data[0] >> 5) & 3;
+  const int show_frame = (data[0] >> 4) & 1;
+  return !show_existing_frame && frame_type == 0 && show_frame;
+}
+
+int seek_index_is_random_access_point(const uint8_t *data, size_t size,
+                                      int is_annexb) {
+  int seen_sequence_header = 0;
+  int reduced_still_picture_header = 0;
+  size_t pos = 0;
+  size_t end = size;
+
+  if (is_annexb) {
+    uint64_t temporal_unit_size;
+    size_t length;
+    if (aom_uleb_decode(data, size, &temporal_unit_size, &length) != 0 ||
+        temporal_unit_size > size - length) {
+      return 0;
+    }
+    pos = length;
+    end = length + (size_t)temporal_unit_size;
+  }
+
+  while (pos < end) {
+    size_t frame_unit_end = end;
+    if (is_annexb) {
+      uint64_t frame_unit_size;
+      size_t length;
+      if (aom_uleb_decode(data + pos, end - pos, &frame_unit_size, &length) !=
+              0 ||
+          frame_unit_size > end - pos - length) {
+        return 0;
+      }
+      pos += length;
+      frame_unit_end = pos + (size_t)frame_unit_size;
+    }
+
+    while (pos < frame_unit_end) {
+      ObuHeader obu_header;
+      size_t payload_size;
+      size_t header_size;
+      if (aom_read_obu_header_and_size(data + pos, frame_unit_end - pos,
+                                       is_annexb, &obu_header, &payload_size,
+                                       &header_size) != AOM_CODEC_OK ||
+          payload_size > frame_unit_end - pos - header_size) {
+        return 0;
+      }
+      const uint8_t *const payload = data + pos + header_size;
+      switch (obu_header.type) {
+        case OBU_SEQUENCE_HEADER:
+          if (payload_size == 0) return 0;
+          // seq_profile f(3), still_picture f(1),
+          // reduced_still_picture_header f(1).
+          reduced_still_picture_header = (payload[0] >> 3) & 1;
+          seen_sequence_header = 1;
+          break;
+        case OBU_FRAME_HEADER:
+        case OBU_FRAME:
+          // The first frame of the temporal unit is the one decoded first.
+          return seen_sequence_header &&
+                 is_shown_key_frame(payload, payload_size,
+                                    reduced_still_picture_header);
+        default: break;
+      }
+      pos += header_size + payload_size;
+    }
+  }
+  return 0;
+}
+
+int seek_index_add(SeekIndex *index, int64_t pts, int64_t offset) {
+  if (index->num_entries == index->capacity) {
+    const int capacity = index->capacity ? 2 * index->capacity : 64;
+    SeekIndexEntry *const entries = (SeekIndexEntry *)realloc(
+        index->entries, capacity * sizeof(*index->entries));
+    if (!entries) return -1;
+    index->entries = entries;
+    index->capacity = capacity;
+  }
+  index->entries[index->num_entries].pts = pts;
+  index->entries[index->num_entries].offset = offset;
+  ++index->num_entries;
+  return 0;
+}
+
+const SeekIndexEntry *seek_index_find(const SeekIndex *index, int64_t pts) {
+  // Binary search for the first entry with a greater pts.
+  int low = 0;
+  int high = index->num_entries;
+  while (low < high) {
+    const int mid = low + (high - low) / 2;
+    if (index->entries[mid].pts <= pts) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low > 0 ? &index->entries[low - 1] : NULL;
+}
+
+int seek_index_write(const SeekIndex *index, const char *filename) {
+  uint8_t header[SEEK_INDEX_HEADER_SIZE] = { 0 };
+  FILE *const file = fopen(filename, "wb");
+  if (!file) return -1;
+
+  memcpy(header, SEEK_INDEX_SIGNATURE, 4);
+  mem_put_le16(header + 4, 0);
+  mem_put_le16(header + 6, SEEK_INDEX_HEADER_SIZE);
+  mem_put_le32(header + 8, index->num_entries);
+  put_le64(header + 12, index->file_size);
+  int ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+  for (int i = 0; ok && i < index->num_entries; ++i) {
+    uint8_t entry[SEEK_INDEX_ENTRY_SIZE];
+    put_le64(entry, index->entries[i].pts);
+    put_le64(entry + 8, index->entries[i].offset);
+    ok = fwrite(entry, 1, sizeof(entry), file) == sizeof(entry);
+  }
+  ok = !fclose(file) && ok;
+  return ok ? 0 : -1;
+}
+
+int seek_index_read(SeekIndex *index, const char *filename) {
+  uint8_t header[SEEK_INDEX_HEADER_SIZE];
+  FILE *const file = fopen(filename, "rb");
+  if (!file) return -1;
+
+  index->num_entries = 0;
+  if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+      memcmp(header, SEEK_INDEX_SIGNATURE, 4) != 0 ||
+      mem_get_le16(header + 4) != 0 ||
+      mem_get_le16(header + 6) < SEEK_INDEX_HEADER_SIZE ||
+      fseek(file, (long)mem_get_le16(header + 6), SEEK_SET) != 0) {
+    fclose(file);
+    return -1;
+  }
+  const int num_entries = (int)mem_get_le32(header + 8);
+  index->file_size = get_le64(header + 12);
+  for (int i = 0; i < num_entries; ++i) {
+    uint8_t entry[SEEK_INDEX_ENTRY_SIZE];
+    if (fread(entry, 1, sizeof(entry), file) != sizeof(entry) ||
+        seek_index_add(index, get_le64(entry), get_le64(entry + 8)) != 0) {
+      index->num_entries = 0;
+      fclose(file);
+      return -1;
+    }
+  }
+  fclose(file);
+  return 0;
+}
+
+void seek_index_free(SeekIndex *index) {
+  free(index->entries);
+  memset(index, 0, sizeof(*index));
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+#ifndef AOM_COMMON_SEEK_INDEX_H_
+#define AOM_COMMON_SEEK_INDEX_H_
+
+#include <stddef.h>
+
+#include "aom/aom_integer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A seek index lists the temporal units of an IVF or OBU file where decoding
+// can start: the ones with a sequence header and a shown key frame. It is
+// stored in a sidecar file with a 32 byte header:
+//
+//   bytes 0-3    signature: 'AOMS'
+//   bytes 4-5    version (should be 0)
+//   bytes 6-7    length of header in bytes
+//   bytes 8-11   number of entries
+//   bytes 12-19  size of the indexed file in bytes
+//   bytes 20-31  unused
+//
+// followed by 16 byte entries in increasing pts order:
+//
+//   bytes 0-7    pts of the temporal unit
+//   bytes 8-15   offset of the temporal unit in the indexed file
+//
+// The pts is the one of the IVF frame header, or the number of the temporal
+// unit in OBU files, which carry no timestamps. The offset is the one of the
+// IVF frame header, or the first byte of the temporal unit in OBU files. All
+// values are little endian.
+
+typedef struct SeekIndexEntry {
+  int64_t pts;
+  int64_t offset;
+} SeekIndexEntry;
+
+typedef struct SeekIndex {
+  SeekIndexEntry *entries;
+  int num_entries;
+  int capacity;
+  // Size of the indexed file, used to detect a stale index.
+  int64_t file_size;
+} SeekIndex;
+
+// Returns 1 if decoding can start at the temporal unit in 'data': it has a
+// sequence header, and its first frame is a shown key frame. Only the OBU
+// headers and the first bits of the frame header are parsed.
+int seek_index_is_random_access_point(const uint8_t *data, size_t size,
+                                      int is_annexb);
+
+// Appends an entry. Entries must be added in increasing pts order. Returns 0
+// on success.
+int seek_index_add(SeekIndex *index, int64_t pts, int64_t offset);
+
+// Returns the last entry with a pts not greater than 'pts', or NULL if there
+// is none.
+const SeekIndexEntry *seek_index_find(const SeekIndex *index, int64_t pts);
+
+// Writes the index to 'filename'. Returns 0 on success.
+int seek_index_write(const SeekIndex *index, const char *filename);
+
+// Reads the index from 'filename', replacing the entries of 'index'. Returns
+// 0 on success.
+int seek_index_read(SeekIndex *index, const char *filename);
+
+void seek_index_free(SeekIndex *index);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_COMMON_SEEK_INDEX_H_
@@ -8,10 +8,29 @@
  * Media Patent License 1.0 was not distributed with this source code in the
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
+
+// Enable POSIX extensions in glibc so that we can call fileno() and
+// madvise(). This must be before any #include statements.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
+#include "config/aom_config.h"
+
+#if HAVE_UNISTD_H && !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define AOM_VIDEO_READER_MMAP 1
+#else
+#define AOM_VIDEO_READER_MMAP 0
+#endif
+
+#include "aom/aom_integer.h"
 #include "aom_ports/mem_ops.h"
 #include "common/ivfdec.h"
 #include "common/obudec.h"
@@ -19,6 +38,10 @@
 #include "common/video_reader.h"
 #include "common/webmdec.h"
 
+// Number of bytes past the current frame that the kernel is asked to read
+// ahead of a mapped file.
+#define READAHEAD_SIZE (4 << 20)
+
 struct AvxVideoReaderStruct {
   AvxVideoInfo info;
   struct AvxInputContext input_ctx;
@@ -28,8 +51,112 @@ struct AvxVideoReaderStruct {
   size_t buffer_size;
   size_t frame_size;
   aom_codec_pts_t pts;
+  // The IVF or OBU file mapped into memory, or NULL if frames are read into
+  // 'buffer' with fread().
+  const uint8_t *map;
+  size_t map_size;
+  // Offset in 'map' of the next frame, and of the end of the range the kernel
+  // was last asked to read ahead.
+  size_t map_offset;
+  size_t readahead_end;
+  // Frame returned by aom_video_reader_get_frame().
+  const uint8_t *frame;
 };
 
+// Maps the file of 'reader' into memory so that frames are returned as
+// pointers into the file instead of being copied into 'buffer'. 'offset' is
+// the offset of the first frame. Frames keep being read with fread() if the
+// file cannot be mapped.
+static void map_file(AvxVideoReader *reader, size_t offset) {
+#if AOM_VIDEO_READER_MMAP
+  // ivf_read_frame() hands the frames to the packetizer or reads them from
+  // its packets.
+  if (gPacketizerMode != PACKETIZER_MODE_NONE) return;
+
+  const int fd = fileno(reader->input_ctx.file);
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+      (uint64_t)st.st_size > SIZE_MAX || (size_t)st.st_size < offset) {
+    return;
+  }
+  void *const map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd,
+                         0);
+  if (map == MAP_FAILED) return;
+  madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+  reader->map = (const uint8_t *)map;
+  reader->map_size = (size_t)st.st_size;
+  reader->map_offset = offset;
+  reader->readahead_end = 0;
+#else
+  (void)reader;
+  (void)offset;
+#endif
+}
+
+// Asks the kernel to read the part of the mapped file that follows the
+// current frame ahead of time.
+static void readahead_map(AvxVideoReader *reader) {
+#if AOM_VIDEO_READER_MMAP
+  if (reader->map_offset + READAHEAD_SIZE / 2 <= reader->readahead_end ||
+      reader->readahead_end >= reader->map_size) {
+    return;
+  }
+  const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+  const size_t start = reader->map_offset & ~(page_size - 1);
+  const size_t end = AOMMIN(reader->map_offset + READAHEAD_SIZE,
+                            reader->map_size);
+  madvise((void *)(reader->map + start), end - start, MADV_WILLNEED);
+  reader->readahead_end = end;
+#else
+  (void)reader;
+#endif
+}
+
+// Reads the IVF frame at the current offset of the mapped file. Returns 1 on
+// success and 0 at the end of the file or on error.
+static int read_mapped_ivf_frame(AvxVideoReader *reader) {
+  const uint8_t *const data = reader->map + reader->map_offset;
+  const size_t remaining = reader->map_size - reader->map_offset;
+  if (remaining < IVF_FRAME_HDR_SZ) return 0;
+
+  const size_t frame_size = mem_get_le32(data);
+  if (frame_size > 256 * 1024 * 1024 ||
+      frame_size > remaining - IVF_FRAME_HDR_SZ) {
+    fprintf(stderr, "Read invalid frame size (%u)\n",
+            (unsigned int)frame_size);
+    return 0;
+  }
+  reader->pts = mem_get_le32(data + 4);
+  reader->pts += ((aom_codec_pts_t)mem_get_le32(data + 8) << 32);
+  reader->frame = data + IVF_FRAME_HDR_SZ;
+  reader->frame_size = frame_size;
+  reader->map_offset += IVF_FRAME_HDR_SZ + frame_size;
+  return 1;
+}
+
+// Reads the Annex B temporal unit at the current offset of the mapped OBU
+// file. Returns 1 on success and 0 at the end of the file or on error.
+static int read_mapped_temporal_unit(AvxVideoReader *reader) {
+  const uint8_t *const data = reader->map + reader->map_offset;
+  const size_t remaining = reader->map_size - reader->map_offset;
+  if (remaining == 0) return 0;
+
+  // Like obudec_read_temporal_unit(), returns the temporal unit with its size.
+  uint64_t size;
+  size_t length_of_size;
+  if (aom_uleb_decode(data, remaining, &size, &length_of_size) != 0 ||
+      size > remaining - length_of_size) {
+    fprintf(stderr, "obudec: Failure reading temporal unit header\n");
+    return 0;
+  }
+  const size_t tu_size = length_of_size + (size_t)size;
+  reader->frame = data;
+  reader->frame_size = tu_size;
+  reader->map_offset += tu_size;
+  return 1;
+}
+
 AvxVideoReader *aom_video_reader_open(const char *filename) {
   AvxVideoReader *reader = NULL;
   FILE *const file = fopen(filename, "rb");
@@ -69,11 +196,23 @@ AvxVideoReader *aom_video_reader_open(const char *filename) {
     return NULL;  // Unknown file type
   }
 
+  // file_is_obu() has buffered the first OBU, so the mapped OBU file is read
+  // from its start.
+  if (reader->input_ctx.file_type == FILE_TYPE_IVF) {
+    map_file(reader, IVF_FILE_HDR_SZ);
+  } else if (reader->input_ctx.file_type == FILE_TYPE_OBU &&
+             reader->obu_ctx.is_annexb) {
+    map_file(reader, 0);
+  }
+
   return reader;
 }
 
 void aom_video_reader_close(AvxVideoReader *reader) {
   if (reader) {
+#if AOM_VIDEO_READER_MMAP
+    if (reader->map != NULL) munmap((void *)reader->map, reader->map_size);
+#endif
     fclose(reader->input_ctx.file);
     if (reader->input_ctx.file_type == FILE_TYPE_OBU) {
       obudec_free(&reader->obu_ctx);
@@ -84,30 +223,41 @@ void aom_video_reader_close(AvxVideoReader *reader) {
 }
 
 int aom_video_reader_read_frame(AvxVideoReader *reader) {
-  if (reader->input_ctx.file_type == FILE_TYPE_IVF) {
-    return !ivf_read_frame(reader->input_ctx.file, &reader->buffer,
-                           &reader->frame_size, &reader->buffer_size,
-                           &reader->pts);
+  int ret;
+  if (reader->map != NULL) {
+    readahead_map(reader);
+    if (reader->input_ctx.file_type == FILE_TYPE_IVF)
+      return read_mapped_ivf_frame(reader);
+    return read_mapped_temporal_unit(reader);
+  } else if (reader->input_ctx.file_type == FILE_TYPE_IVF) {
+    ret = !ivf_read_frame(reader->input_ctx.file, &reader->buffer,
+                          &reader->frame_size, &reader->buffer_size,
+                          &reader->pts);
   } else if (reader->input_ctx.file_type == FILE_TYPE_OBU) {
-    return !obudec_read_temporal_unit(&reader->obu_ctx, &reader->buffer,
-                                      &reader->frame_size,
-                                      &reader->buffer_size);
+    ret = !obudec_read_temporal_unit(&reader->obu_ctx, &reader->buffer,
+                                     &reader->frame_size, &reader->buffer_size);
 #if CONFIG_WEBM_IO
   } else if (reader->input_ctx.file_type == FILE_TYPE_WEBM) {
-    return !webm_read_frame(&reader->webm_ctx, &reader->buffer,
-                            &reader->frame_size, &reader->buffer_size);
+    ret = !webm_read_frame(&reader->webm_ctx, &reader->buffer,
+                           &reader->frame_size, &reader->buffer_size);
 #endif
   } else {
     assert(0);
     return 0;
   }
+  reader->frame = reader->buffer;
+  return ret;
 }
 
 const uint8_t *aom_video_reader_get_frame(AvxVideoReader *reader,
                                           size_t *size) {
   if (size) *size = reader->frame_size;
 
-  return reader->buffer;
+  return reader->frame;
+}
+
+int aom_video_reader_is_mapped(const AvxVideoReader *reader) {
+  return reader->map != NULL;
 }
 
 int64_t aom_video_reader_get_frame_pts(AvxVideoReader *reader) {
@@ -118,6 +268,21 @@ FILE *aom_video_reader_get_file(AvxVideoReader *reader) {
   return reader->input_ctx.file;
 }
 
+int64_t aom_video_reader_tell(AvxVideoReader *reader) {
+  if (reader->map != NULL) return (int64_t)reader->map_offset;
+  return (int64_t)ftello(reader->input_ctx.file);
+}
+
+int aom_video_reader_seek(AvxVideoReader *reader, int64_t offset) {
+  if (reader->map != NULL) {
+    if (offset < 0 || (uint64_t)offset > reader->map_size) return -1;
+    reader->map_offset = (size_t)offset;
+    reader->readahead_end = 0;
+    return 0;
+  }
+  return fseeko(reader->input_ctx.file, (FileOffset)offset, SEEK_SET);
+}
+
 const AvxVideoInfo *aom_video_reader_get_info(AvxVideoReader *reader) {
   return &reader->info;
 }
@@ -39,14 +39,31 @@ void aom_video_reader_close(AvxVideoReader *reader);
 int aom_video_reader_read_frame(AvxVideoReader *reader);
 
 // Returns the pointer to memory buffer with frame data read by last call to
-// aom_video_reader_read_frame().
+// aom_video_reader_read_frame(). IVF and OBU files are memory mapped where
+// possible, in which case this points into the mapped file. The data stays
+// valid until the next call to aom_video_reader_read_frame() or
+// aom_video_reader_close().
 const uint8_t *aom_video_reader_get_frame(AvxVideoReader *reader, size_t *size);
 
+// Returns 1 if the frames are read from the file mapped into memory, and 0 if
+// they are copied into an internal buffer.
+int aom_video_reader_is_mapped(const AvxVideoReader *reader);
+
 // Returns the pts of the frame.
 int64_t aom_video_reader_get_frame_pts(AvxVideoReader *reader);
 // Return the reader file.
 FILE *aom_video_reader_get_file(AvxVideoReader *reader);
 
+// Returns the offset of the next frame in the file. The file itself may not
+// be at this offset when it is memory mapped, so this and
+// aom_video_reader_seek() are used instead of ftello() and fseeko() on the
+// reader file.
+int64_t aom_video_reader_tell(AvxVideoReader *reader);
+
+// Makes 'offset', a value returned by aom_video_reader_tell(), the offset of
+// the next frame read. Returns 0 on success.
+int aom_video_reader_seek(AvxVideoReader *reader, int64_t offset);
+
 // Fills AvxVideoInfo with information from opened video file.
 const AvxVideoInfo *aom_video_reader_get_info(AvxVideoReader *reader);
 
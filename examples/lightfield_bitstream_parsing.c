@@ -251,9 +251,8 @@ int main(int argc, char **argv) {
   aom_codec_control_(&codec, AV1_SET_TILE_MODE, 1);
   aom_codec_control_(&codec, AV1D_EXT_TILE_DEBUG, 1);
 
-  FILE *infile = aom_video_reader_get_file(reader);
   // Record the offset of the first camera image.
-  const FileOffset camera_frame_pos = ftello(infile);
+  const int64_t camera_frame_pos = aom_video_reader_tell(reader);
 
   printf("Loading compressed frames into memory.\n");
 
@@ -269,7 +268,7 @@ int main(int argc, char **argv) {
       (unsigned char **)malloc(num_frames * sizeof(unsigned char *));
   size_t *frame_sizes = (size_t *)malloc(num_frames * sizeof(size_t));
   // Seek to the first camera image.
-  fseeko(infile, camera_frame_pos, SEEK_SET);
+  aom_video_reader_seek(reader, camera_frame_pos);
   for (int f = 0; f < num_frames; ++f) {
     aom_video_reader_read_frame(reader);
     size_t frame_size = 0;
@@ -246,9 +246,8 @@ int main(int argc, char **argv) {
     }
   }
 
-  FILE *infile = aom_video_reader_get_file(reader);
   // Record the offset of the first camera image.
-  const FileOffset camera_frame_pos = ftello(infile);
+  const int64_t camera_frame_pos = aom_video_reader_tell(reader);
 
   printf("Loading compressed frames into memory.\n");
 
@@ -264,7 +263,7 @@ int main(int argc, char **argv) {
       (unsigned char **)malloc(num_frames * sizeof(unsigned char *));
   size_t *frame_sizes = (size_t *)malloc(num_frames * sizeof(size_t));
   // Seek to the first camera image.
-  fseeko(infile, camera_frame_pos, SEEK_SET);
+  aom_video_reader_seek(reader, camera_frame_pos);
   for (int f = 0; f < num_frames; ++f) {
     aom_video_reader_read_frame(reader);
     frame = aom_video_reader_get_frame(reader, &frame_size);
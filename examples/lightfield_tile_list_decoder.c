@@ -20,16 +20,19 @@
 // the number of anchor frames coded at the beginning of the light field file.
 // num_tile_lists is the number of tile lists need to be decoded. There is an
 // optional parameter allowing to choose the output format, and the supported
-// formats are YUV1D(default), YUV, and NV12.
+// formats are YUV1D(default), YUV, and NV12. A second optional parameter sets
+// the number of threads used to decode the tiles of each tile list.
 // Run lightfield tile list decoder to decode an AV1 tile list file:
 // examples/lightfield_tile_list_decoder vase_tile_list.ivf vase_tile_list.yuv
-// 4 2 0(optional)
+// 4 2 0(optional) 4(optional)
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
+#include "config/aom_config.h"
+
 #include "aom/aom_decoder.h"
 #include "aom/aomdx.h"
 #include "aom_scale/yv12config.h"
@@ -42,7 +45,7 @@ static const char *exec_name;
 void usage_exit(void) {
   fprintf(stderr,
           "Usage: %s <infile> <outfile> <num_references> <num_tile_lists> "
-          "<output format(optional)>\n",
+          "<output format(optional)> <num_threads(optional)>\n",
           exec_name);
   exit(EXIT_FAILURE);
 }
@@ -108,6 +111,7 @@ int main(int argc, char **argv) {
   size_t frame_size = 0;
   const unsigned char *frame = NULL;
   int output_format = YUV1D;
+  aom_codec_dec_cfg_t cfg = { 0, 0, 0, !FORCE_HIGHBITDEPTH_DECODING, { 1 } };
   int i, j, n;
 
   exec_name = argv[0];
@@ -126,6 +130,7 @@ int main(int argc, char **argv) {
   if (argc > 5) output_format = (int)strtol(argv[5], NULL, 0);
   if (output_format < YUV1D || output_format > NV12)
     die("Output format out of range [0, 2]");
+  if (argc > 6) cfg.threads = (unsigned int)strtoul(argv[6], NULL, 0);
 
   info = aom_video_reader_get_info(reader);
 
@@ -133,7 +138,7 @@ int main(int argc, char **argv) {
   if (!decoder) die("Unknown input codec.");
   printf("Using %s\n", aom_codec_iface_name(decoder->codec_interface()));
 
-  if (aom_codec_dec_init(&codec, decoder->codec_interface(), NULL, 0))
+  if (aom_codec_dec_init(&codec, decoder->codec_interface(), &cfg, 0))
     die_codec(&codec, "Failed to initialize decoder.");
 
   if (aom_codec_control(&codec, AV1D_SET_IS_ANNEXB, info->is_annexb)) {
@@ -57,6 +57,15 @@ aomdec() {
   eval "${AOM_TEST_PREFIX}" "${decoder}" "$input" "$@" ${devnull}
 }
 
+# Runs aomdec like aomdec() and prints the MD5 of the decoded frames.
+aomdec_md5() {
+  local decoder="$(aom_tool_path aomdec)"
+  local input="$1"
+  shift
+  eval "${AOM_TEST_PREFIX}" "${decoder}" "$input" --md5 "$@" 2> /dev/null \
+    | awk '{print $1}'
+}
+
 aomdec_can_decode_av1() {
   if [ "$(av1_decode_available)" = "yes" ]; then
     echo yes
@@ -95,6 +104,73 @@ aomdec_av1_ivf_multithread() {
   fi
 }
 
+aomdec_av1_ivf_pipeline() {
+  if [ "$(aomdec_can_decode_av1)" = "yes" ]; then
+    local file="${AV1_IVF_FILE}"
+    if [ ! -e "${file}" ]; then
+      encode_yuv_raw_input_av1 "${file}" --ivf
+    fi
+    local expected_md5="$(aomdec_md5 "${file}")"
+    if [ -z "${expected_md5}" ]; then
+      elog "Failed to decode ${file}."
+      return 1
+    fi
+    for args in "--pipeline=1" \
+                "--pipeline=4" \
+                "--pipeline=4 --threads=4" \
+                "--pipeline=2 --frame-buffers=12" \
+                "--pipeline=4 --frame-buffers=16 --threads=2"; do
+      local actual_md5="$(aomdec_md5 "${file}" ${args})"
+      if [ "${actual_md5}" != "${expected_md5}" ]; then
+        elog "MD5 mismatch with ${args}:"
+        elog "Expected: ${expected_md5}"
+        elog "Actual: ${actual_md5}"
+        return 1
+      fi
+    done
+  fi
+}
+
+# Checks that --seek starts decoding at the last key frame at or before the
+# requested pts, with and without a seek index file.
+aomdec_av1_ivf_seek() {
+  if [ "$(aomdec_can_decode_av1)" = "yes" ] && \
+     [ "$(av1_encode_available)" = "yes" ]; then
+    local file="${AOM_TEST_OUTPUT_DIR}/av1.seek.ivf"
+    local index="${AOM_TEST_OUTPUT_DIR}/av1.seek.index"
+    # Key frames at pts 0 and 3.
+    encode_yuv_raw_input_av1 "${file}" --ivf --kf-min-dist=3 --kf-max-dist=3
+    local start_md5="$(aomdec_md5 "${file}")"
+    local key3_md5="$(aomdec_md5 "${file}" --skip=3)"
+    if [ -z "${start_md5}" ] || [ "${start_md5}" = "${key3_md5}" ]; then
+      elog "Failed to decode ${file}."
+      return 1
+    fi
+    # The first run with --seek-index writes the index, the second reads it.
+    for args in "--seek=2:${start_md5}" \
+                "--seek=3:${key3_md5}" \
+                "--seek=4:${key3_md5}" \
+                "--seek=4 --seek-index=${index}:${key3_md5}" \
+                "--seek=4 --seek-index=${index}:${key3_md5}" \
+                "--seek=2 --seek-index=${index}:${start_md5}" \
+                "--seek=4294967299 --seek-index=${index}:${key3_md5}"; do
+      local expected_md5="${args##*:}"
+      args="${args%:*}"
+      local actual_md5="$(aomdec_md5 "${file}" ${args})"
+      if [ "${actual_md5}" != "${expected_md5}" ]; then
+        elog "MD5 mismatch with ${args}:"
+        elog "Expected: ${expected_md5}"
+        elog "Actual: ${actual_md5}"
+        return 1
+      fi
+    done
+    if [ ! -e "${index}" ]; then
+      elog "Seek index ${index} was not written."
+      return 1
+    fi
+  fi
+}
+
 aomdec_aom_ivf_pipe_input() {
   if [ "$(aomdec_can_decode_av1)" = "yes" ]; then
     local file="${AV1_IVF_FILE}"
@@ -139,6 +215,8 @@ aomdec_av1_webm() {
 aomdec_tests="aomdec_av1_ivf
               aomdec_av1_ivf_error_resilient
               aomdec_av1_ivf_multithread
+              aomdec_av1_ivf_pipeline
+              aomdec_av1_ivf_seek
               aomdec_aom_ivf_pipe_input
               aomdec_av1_obu_annexb
               aomdec_av1_obu_section5
@@ -86,6 +86,50 @@ TEST(AV1, TestBitIO) {
   }
 }
 
+// Round trips adaptive multi-symbol values. The coded sizes range from a few
+// bytes to a few hundred, so the decoder refills its window both a byte and a
+// word at a time, and reads the tail of the buffer a byte at a time.
+TEST(AV1, TestSymbolRoundTrip) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  const int kBufferSize = 10000;
+  const int kMaxSymbols = 16;
+  uint8_t bw_buffer[kBufferSize];
+  for (int num_values = 1; num_values <= 1000; num_values += 7) {
+    aom_cdf_prob enc_cdfs[kMaxSymbols + 1][kMaxSymbols + 1];
+    aom_cdf_prob dec_cdfs[kMaxSymbols + 1][kMaxSymbols + 1];
+    for (int n = 2; n <= kMaxSymbols; ++n) {
+      for (int i = 0; i < n; ++i) {
+        enc_cdfs[n][i] = AOM_ICDF(CDF_PROB_TOP * (i + 1) / n);
+      }
+      enc_cdfs[n][n] = 0;
+      memcpy(dec_cdfs[n], enc_cdfs[n], sizeof(enc_cdfs[n]));
+    }
+
+    int nsymbs[1000];
+    int values[1000];
+    aom_writer bw;
+    aom_start_encode(&bw, bw_buffer);
+    bw.allow_update_cdf = 1;
+    for (int i = 0; i < num_values; ++i) {
+      nsymbs[i] = 2 + rnd.Rand8() % (kMaxSymbols - 1);
+      // Mostly 0, so that the adapted CDFs get skewed.
+      values[i] = rnd.Rand8() < 192 ? 0 : rnd.Rand8() % nsymbs[i];
+      aom_write_symbol(&bw, values[i], enc_cdfs[nsymbs[i]], nsymbs[i]);
+    }
+    aom_stop_encode(&bw);
+
+    aom_reader br;
+    aom_reader_init(&br, bw_buffer, bw.pos);
+    br.allow_update_cdf = 1;
+    for (int i = 0; i < num_values; ++i) {
+      const int value =
+          aom_read_symbol(&br, dec_cdfs[nsymbs[i]], nsymbs[i], NULL);
+      GTEST_ASSERT_EQ(value, values[i]) << "pos: " << i << " / " << num_values;
+    }
+    ASSERT_FALSE(aom_reader_has_overflowed(&br));
+  }
+}
+
 #define FRAC_DIFF_TOTAL_ERROR 0.18
 
 TEST(AV1, TestTell) {
@@ -19,6 +19,7 @@
 #include "test/i420_video_source.h"
 #include "test/md5_helper.h"
 #include "test/util.h"
+#include "test/video_source.h"
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 
 namespace {
@@ -112,7 +113,11 @@ class AV1DecodeMultiThreadedTest
 
     libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 704, 576,
                                        timebase.den, timebase.num, 0, 5);
-    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    DoTest(&video);
+  }
+
+  void DoTest(libaom_test::VideoSource *video) {
+    ASSERT_NO_FATAL_FAILURE(RunLoop(video));
 
     const char *md5_single_thread_str = md5_single_thread_.Get();
 
@@ -166,6 +171,28 @@ AV1_INSTANTIATE_TEST_CASE(AV1DecodeMultiThreadedTestLarge,
                           ::testing::Values(1, 4), ::testing::Values(0),
                           ::testing::Values(0, 1));
 
+// Same as AV1DecodeMultiThreadedTest, on generated frames so that the row
+// based multi-threading of the decoder is checked without test vectors.
+class AV1DecodeRowMTTest : public AV1DecodeMultiThreadedTest {};
+
+TEST_P(AV1DecodeRowMTTest, MD5Match) {
+  cfg_.large_scale_tile = 0;
+  cfg_.rc_target_bitrate = 500;
+  cfg_.g_lag_in_frames = 12;
+  cfg_.rc_end_usage = AOM_VBR;
+  single_thread_dec_->Control(AV1_SET_TILE_MODE, 0);
+  for (int i = 0; i < kNumMultiThreadDecoders; ++i)
+    multi_thread_dec_[i]->Control(AV1_SET_TILE_MODE, 0);
+  libaom_test::RandomVideoSource video;
+  video.SetSize(352, 288);
+  video.set_limit(3);
+  DoTest(&video);
+}
+
+AV1_INSTANTIATE_TEST_CASE(AV1DecodeRowMTTest, ::testing::Values(0, 1),
+                          ::testing::Values(0), ::testing::Values(1),
+                          ::testing::Values(5), ::testing::Values(1));
+
 class AV1DecodeMultiThreadedLSTestLarge
     : public AV1DecodeMultiThreadedTestLarge {};
 
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "aom/aomdx.h"
+
+namespace {
+
+const int kFrames = 4;
+
+// Checks that AV1D_GET_DECODE_TIMING reports the time of the tile decoding
+// stage when timing is enabled, and that timing does not change the output.
+class DecodeTimingTest
+    : public ::libaom_test::CodecTestWith2Params<unsigned int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  DecodeTimingTest()
+      : EncoderTest(GET_PARAM(0)), threads_(GET_PARAM(1)),
+        row_mt_(GET_PARAM(2)), num_frames_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads_;
+    cfg.allow_lowbitdepth = 1;
+    ref_dec_ = codec_->CreateDecoder(cfg, 0);
+    ref_dec_->Control(AV1D_SET_ROW_MT, row_mt_);
+    timed_dec_ = codec_->CreateDecoder(cfg, 0);
+    timed_dec_->Control(AV1D_SET_ROW_MT, row_mt_);
+    timed_dec_->Control(AV1D_SET_DECODE_TIMING, 1);
+  }
+
+  virtual ~DecodeTimingTest() {
+    delete ref_dec_;
+    delete timed_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 5);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+    }
+  }
+
+  static std::string MD5(const aom_image_t *img) {
+    ::libaom_test::MD5 md5;
+    md5.Add(img);
+    return md5.Get();
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    uint8_t *const data = static_cast<uint8_t *>(pkt->data.frame.buf);
+    const size_t size = pkt->data.frame.sz;
+
+    aom_codec_err_t res = ref_dec_->DecodeFrame(data, size);
+    ASSERT_EQ(AOM_CODEC_OK, res) << ref_dec_->DecodeError();
+    res = timed_dec_->DecodeFrame(data, size);
+    ASSERT_EQ(AOM_CODEC_OK, res) << timed_dec_->DecodeError();
+
+    ::libaom_test::DxDataIterator ref_iter = ref_dec_->GetDxData();
+    ::libaom_test::DxDataIterator timed_iter = timed_dec_->GetDxData();
+    const aom_image_t *ref_img;
+    while ((ref_img = ref_iter.Next()) != NULL) {
+      const aom_image_t *const timed_img = timed_iter.Next();
+      ASSERT_TRUE(timed_img != NULL);
+      EXPECT_EQ(MD5(ref_img), MD5(timed_img)) << "frame " << num_frames_;
+      ++num_frames_;
+    }
+    EXPECT_TRUE(timed_iter.Next() == NULL);
+
+    aom_decode_timing_t timing;
+    EXPECT_EQ(AOM_CODEC_ERROR,
+              aom_codec_control(ref_dec_->GetDecoder(), AV1D_GET_DECODE_TIMING,
+                                &timing));
+    ASSERT_EQ(AOM_CODEC_OK,
+              aom_codec_control(timed_dec_->GetDecoder(),
+                                AV1D_GET_DECODE_TIMING, &timing));
+    EXPECT_GT(timing.wall_us[AOM_DECODE_STAGE_TILES], 0);
+    for (int stage = 0; stage < AOM_DECODE_STAGES; ++stage) {
+      EXPECT_GE(timing.wall_us[stage], 0) << "stage " << stage;
+      EXPECT_GE(timing.cpu_us[stage], 0) << "stage " << stage;
+    }
+    EXPECT_GE(timing.worker_idle_us, 0);
+    if (threads_ == 1) {
+      EXPECT_EQ(0, timing.worker_idle_us);
+    }
+  }
+
+  unsigned int threads_;
+  int row_mt_;
+  int num_frames_;
+  ::libaom_test::Decoder *ref_dec_;
+  ::libaom_test::Decoder *timed_dec_;
+};
+
+TEST_P(DecodeTimingTest, ReportsStageTimes) {
+  ::libaom_test::RandomVideoSource video;
+  video.SetSize(352, 288);
+  video.set_limit(kFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kFrames, num_frames_);
+}
+
+AV1_INSTANTIATE_TEST_CASE(DecodeTimingTest, ::testing::Values(1U, 3U),
+                          ::testing::Values(0, 1));
+}  // namespace
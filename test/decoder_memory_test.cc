@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "aom/aomdx.h"
+
+namespace {
+
+const int kFrames = 4;
+const unsigned int kThreads = 4;
+
+// Checks that a multithreaded decoder, whose buffers are sized from the
+// sequence header and allocated for the workers it uses, decodes streams of
+// either superblock size like a single threaded decoder, and that
+// AV1D_GET_MEMORY_USAGE reports the memory it allocates.
+class DecoderMemoryTest
+    : public ::libaom_test::CodecTestWith2Params<aom_superblock_size_t, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  DecoderMemoryTest()
+      : EncoderTest(GET_PARAM(0)), sb_size_(GET_PARAM(1)),
+        row_mt_(GET_PARAM(2)), num_frames_(0), last_usage_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.allow_lowbitdepth = 1;
+    cfg.threads = 1;
+    ref_dec_ = codec_->CreateDecoder(cfg, 0);
+    cfg.threads = kThreads;
+    mt_dec_ = codec_->CreateDecoder(cfg, 0);
+    mt_dec_->Control(AV1D_SET_ROW_MT, row_mt_);
+  }
+
+  virtual ~DecoderMemoryTest() {
+    delete ref_dec_;
+    delete mt_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 5);
+      encoder->Control(AV1E_SET_SUPERBLOCK_SIZE, sb_size_);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+    }
+  }
+
+  static std::string MD5(const aom_image_t *img) {
+    ::libaom_test::MD5 md5;
+    md5.Add(img);
+    return md5.Get();
+  }
+
+  size_t GetMemoryUsage() {
+    size_t usage = 0;
+    EXPECT_EQ(AOM_CODEC_OK, aom_codec_control(mt_dec_->GetDecoder(),
+                                              AV1D_GET_MEMORY_USAGE, &usage));
+    return usage;
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    uint8_t *const data = static_cast<uint8_t *>(pkt->data.frame.buf);
+    const size_t size = pkt->data.frame.sz;
+
+    aom_codec_err_t res = ref_dec_->DecodeFrame(data, size);
+    ASSERT_EQ(AOM_CODEC_OK, res) << ref_dec_->DecodeError();
+    if (num_frames_ == 0) last_usage_ = GetMemoryUsage();
+    res = mt_dec_->DecodeFrame(data, size);
+    ASSERT_EQ(AOM_CODEC_OK, res) << mt_dec_->DecodeError();
+
+    // The buffers are allocated when the first frame is decoded and reused
+    // by the later ones.
+    const size_t usage = GetMemoryUsage();
+    if (num_frames_ == 0) {
+      EXPECT_GT(usage, last_usage_);
+    } else {
+      EXPECT_GE(usage, last_usage_) << "frame " << num_frames_;
+    }
+    last_usage_ = usage;
+
+    ::libaom_test::DxDataIterator ref_iter = ref_dec_->GetDxData();
+    ::libaom_test::DxDataIterator mt_iter = mt_dec_->GetDxData();
+    const aom_image_t *ref_img;
+    while ((ref_img = ref_iter.Next()) != NULL) {
+      const aom_image_t *const mt_img = mt_iter.Next();
+      ASSERT_TRUE(mt_img != NULL);
+      EXPECT_EQ(MD5(ref_img), MD5(mt_img)) << "frame " << num_frames_;
+      ++num_frames_;
+    }
+    EXPECT_TRUE(mt_iter.Next() == NULL);
+  }
+
+  aom_superblock_size_t sb_size_;
+  int row_mt_;
+  int num_frames_;
+  size_t last_usage_;
+  ::libaom_test::Decoder *ref_dec_;
+  ::libaom_test::Decoder *mt_dec_;
+};
+
+TEST_P(DecoderMemoryTest, MatchesSingleThread) {
+  ::libaom_test::RandomVideoSource video;
+  video.SetSize(352, 288);
+  video.set_limit(kFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kFrames, num_frames_);
+}
+
+AV1_INSTANTIATE_TEST_CASE(DecoderMemoryTest,
+                          ::testing::Values(AOM_SUPERBLOCK_SIZE_64X64,
+                                            AOM_SUPERBLOCK_SIZE_128X128),
+                          ::testing::Values(0, 1));
+}  // namespace
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "aom/aomdx.h"
+
+namespace {
+
+const int kFrames = 5;
+
+// Checks that a decoder reset with AV1D_RESET_STREAM between streams of
+// different frame sizes, or in the middle of a stream, decodes each stream
+// like a new decoder.
+class DecoderResetTest : public ::libaom_test::CodecTestWithParam<unsigned int>,
+                         public ::libaom_test::EncoderTest {
+ protected:
+  DecoderResetTest()
+      : EncoderTest(GET_PARAM(0)), threads_(GET_PARAM(1)), packets_(NULL) {}
+
+  virtual ~DecoderResetTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 5);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const char *const data = static_cast<const char *>(pkt->data.frame.buf);
+    packets_->push_back(std::string(data, pkt->data.frame.sz));
+  }
+
+  void Encode(int width, int height, std::vector<std::string> *packets) {
+    ::libaom_test::RandomVideoSource video;
+    video.SetSize(width, height);
+    video.set_limit(kFrames);
+    packets_ = packets;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(static_cast<size_t>(kFrames), packets->size());
+  }
+
+  ::libaom_test::Decoder *CreateDecoder() {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads_;
+    cfg.allow_lowbitdepth = 1;
+    return codec_->CreateDecoder(cfg, 0);
+  }
+
+  // Decodes the first 'count' packets and appends the MD5 of each frame to
+  // 'md5s'.
+  static void Decode(::libaom_test::Decoder *decoder,
+                     const std::vector<std::string> &packets, int count,
+                     std::vector<std::string> *md5s) {
+    for (int i = 0; i < count; ++i) {
+      const aom_codec_err_t res = decoder->DecodeFrame(
+          reinterpret_cast<const uint8_t *>(packets[i].data()),
+          packets[i].size());
+      ASSERT_EQ(AOM_CODEC_OK, res) << decoder->DecodeError();
+      ::libaom_test::DxDataIterator iter = decoder->GetDxData();
+      const aom_image_t *img;
+      while ((img = iter.Next()) != NULL) {
+        ::libaom_test::MD5 md5;
+        md5.Add(img);
+        md5s->push_back(md5.Get());
+      }
+    }
+  }
+
+  void Reset(::libaom_test::Decoder *decoder) {
+    ASSERT_EQ(AOM_CODEC_OK, aom_codec_control(decoder->GetDecoder(),
+                                              AV1D_RESET_STREAM, 0));
+  }
+
+  unsigned int threads_;
+  std::vector<std::string> *packets_;
+};
+
+TEST_P(DecoderResetTest, MatchesNewDecoder) {
+  std::vector<std::string> large;
+  std::vector<std::string> small;
+  ASSERT_NO_FATAL_FAILURE(Encode(352, 288, &large));
+  ASSERT_NO_FATAL_FAILURE(Encode(176, 144, &small));
+
+  std::vector<std::string> large_md5s;
+  std::vector<std::string> small_md5s;
+  ::libaom_test::Decoder *decoder = CreateDecoder();
+  ASSERT_NO_FATAL_FAILURE(Decode(decoder, large, kFrames, &large_md5s));
+  delete decoder;
+  decoder = CreateDecoder();
+  ASSERT_NO_FATAL_FAILURE(Decode(decoder, small, kFrames, &small_md5s));
+  delete decoder;
+  ASSERT_EQ(static_cast<size_t>(kFrames), large_md5s.size());
+  ASSERT_EQ(static_cast<size_t>(kFrames), small_md5s.size());
+
+  // Large stream, then a small one, then the first frames of the large one,
+  // then the small one again from the middle of the large one.
+  std::vector<std::string> md5s;
+  decoder = CreateDecoder();
+  ASSERT_NO_FATAL_FAILURE(Decode(decoder, large, kFrames, &md5s));
+  ASSERT_NO_FATAL_FAILURE(Reset(decoder));
+  ASSERT_NO_FATAL_FAILURE(Decode(decoder, small, kFrames, &md5s));
+  ASSERT_NO_FATAL_FAILURE(Reset(decoder));
+  ASSERT_NO_FATAL_FAILURE(Decode(decoder, large, 2, &md5s));
+  ASSERT_NO_FATAL_FAILURE(Reset(decoder));
+  ASSERT_NO_FATAL_FAILURE(Decode(decoder, small, kFrames, &md5s));
+  delete decoder;
+
+  std::vector<std::string> expected = large_md5s;
+  expected.insert(expected.end(), small_md5s.begin(), small_md5s.end());
+  expected.insert(expected.end(), large_md5s.begin(), large_md5s.begin() + 2);
+  expected.insert(expected.end(), small_md5s.begin(), small_md5s.end());
+  ASSERT_EQ(expected.size(), md5s.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i], md5s[i]) << "frame " << i;
+  }
+}
+
+TEST_P(DecoderResetTest, ResetBeforeFirstFrame) {
+  ::libaom_test::Decoder *decoder = CreateDecoder();
+  // Initializes the codec context without decoding anything.
+  decoder->Control(AV1D_SET_ROW_MT, 1);
+  ASSERT_NO_FATAL_FAILURE(Reset(decoder));
+  delete decoder;
+}
+
+AV1_INSTANTIATE_TEST_CASE(DecoderResetTest, ::testing::Values(1U, 4U));
+}  // namespace
@@ -14,6 +14,7 @@
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 #include "test/codec_factory.h"
 #include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
 #include "test/md5_helper.h"
 #include "test/util.h"
 #include "test/yuv_video_source.h"
@@ -119,12 +120,15 @@ class AVxEncoderThreadTest
     ::libaom_test::YUVVideoSource video(
         "niklas_640_480_30.yuv", AOM_IMG_FMT_I420, 640, 480, 30, 1, 15, 21);
     cfg_.rc_target_bitrate = 1000;
+    DoTest(&video);
+  }
 
+  void DoTest(::libaom_test::VideoSource *video) {
     if (row_mt_ == 0) {
       // Encode using single thread.
       cfg_.g_threads = 1;
       init_flags_ = AOM_CODEC_USE_PSNR;
-      ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+      ASSERT_NO_FATAL_FAILURE(RunLoop(video));
       std::vector<size_t> single_thr_size_enc;
       std::vector<std::string> single_thr_md5_enc;
       std::vector<std::string> single_thr_md5_dec;
@@ -137,7 +141,7 @@ class AVxEncoderThreadTest
 
       // Encode using multiple threads.
       cfg_.g_threads = 4;
-      ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+      ASSERT_NO_FATAL_FAILURE(RunLoop(video));
       std::vector<size_t> multi_thr_size_enc;
       std::vector<std::string> multi_thr_md5_enc;
       std::vector<std::string> multi_thr_md5_dec;
@@ -155,7 +159,7 @@ class AVxEncoderThreadTest
     } else if (row_mt_ == 1) {
       // Encode using multiple threads row-mt enabled.
       cfg_.g_threads = 2;
-      ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+      ASSERT_NO_FATAL_FAILURE(RunLoop(video));
       std::vector<size_t> multi_thr2_row_mt_size_enc;
       std::vector<std::string> multi_thr2_row_mt_md5_enc;
       std::vector<std::string> multi_thr2_row_mt_md5_dec;
@@ -169,7 +173,7 @@ class AVxEncoderThreadTest
       // Disable threads=3 test for now to reduce the time so that the nightly
       // test would not time out.
       // cfg_.g_threads = 3;
-      // ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+      // ASSERT_NO_FATAL_FAILURE(RunLoop(video));
       // std::vector<size_t> multi_thr3_row_mt_size_enc;
       // std::vector<std::string> multi_thr3_row_mt_md5_enc;
       // std::vector<std::string> multi_thr3_row_mt_md5_dec;
@@ -185,7 +189,7 @@ class AVxEncoderThreadTest
       // ASSERT_EQ(multi_thr3_row_mt_md5_dec, multi_thr2_row_mt_md5_dec);
 
       cfg_.g_threads = 4;
-      ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+      ASSERT_NO_FATAL_FAILURE(RunLoop(video));
       std::vector<size_t> multi_thr4_row_mt_size_enc;
       std::vector<std::string> multi_thr4_row_mt_md5_enc;
       std::vector<std::string> multi_thr4_row_mt_md5_dec;
@@ -244,6 +248,26 @@ AV1_INSTANTIATE_TEST_CASE(AVxEncoderThreadTestLarge,
                           ::testing::Values(0, 1, 2, 6),
                           ::testing::Values(0, 1));
 
+// The symbols of the tiles are written on the encoder workers. The largest
+// motion vector they write sets the search step size of the next frame at
+// these speeds, so the encoding only matches the single-threaded one when the
+// workers track it separately.
+class AVxEncoderThreadTilePackTest : public AVxEncoderThreadTest {};
+
+TEST_P(AVxEncoderThreadTilePackTest, EncoderResultTest) {
+  cfg_.large_scale_tile = 0;
+  decoder_->Control(AV1_SET_TILE_MODE, 0);
+  ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                       30, 1, 0, 10);
+  cfg_.rc_target_bitrate = 500;
+  DoTest(&video);
+}
+
+AV1_INSTANTIATE_TEST_CASE(AVxEncoderThreadTilePackTest,
+                          ::testing::Values(::libaom_test::kTwoPassGood),
+                          ::testing::Values(2), ::testing::Values(1, 2),
+                          ::testing::Values(0, 1), ::testing::Values(0));
+
 class AVxEncoderThreadLSTest : public AVxEncoderThreadTest {
   virtual void SetTileSize(libaom_test::Encoder *encoder) {
     encoder->Control(AV1E_SET_TILE_COLUMNS, tile_cols_);
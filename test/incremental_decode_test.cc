@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "aom/aomdx.h"
+#include "av1/common/obu_util.h"
+
+namespace {
+
+// Decodes every temporal unit both in one piece and one OBU at a time with
+// AV1D_SET_INCREMENTAL_DECODE, and checks that the output is identical.
+class IncrementalDecodeTest
+    : public ::libaom_test::CodecTestWith2Params<int, unsigned int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  IncrementalDecodeTest()
+      : EncoderTest(GET_PARAM(0)), n_tile_groups_(GET_PARAM(1)),
+        threads_(GET_PARAM(2)), num_frames_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads_;
+    cfg.allow_lowbitdepth = 1;
+    full_dec_ = codec_->CreateDecoder(cfg, 0);
+    obu_dec_ = codec_->CreateDecoder(cfg, 0);
+    obu_dec_->Control(AV1D_SET_INCREMENTAL_DECODE, 1);
+  }
+
+  virtual ~IncrementalDecodeTest() {
+    delete full_dec_;
+    delete obu_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 5;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 5);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 2);
+      encoder->Control(AV1E_SET_TILE_ROWS, 1);
+      encoder->Control(AV1E_SET_NUM_TG, n_tile_groups_);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const uint8_t *const data = static_cast<uint8_t *>(pkt->data.frame.buf);
+    const size_t size = pkt->data.frame.sz;
+
+    aom_codec_err_t res = full_dec_->DecodeFrame(data, size);
+    ASSERT_EQ(AOM_CODEC_OK, res) << full_dec_->DecodeError();
+    ::libaom_test::DxDataIterator full_iter = full_dec_->GetDxData();
+    const aom_image_t *const full_img = full_iter.Next();
+
+    const aom_image_t *obu_img = NULL;
+    size_t offset = 0;
+    while (offset < size) {
+      ObuHeader obu_header;
+      size_t payload_size = 0;
+      size_t bytes_read = 0;
+      ASSERT_EQ(AOM_CODEC_OK, aom_read_obu_header_and_size(
+                                  data + offset, size - offset, 0, &obu_header,
+                                  &payload_size, &bytes_read));
+      const size_t obu_size = bytes_read + payload_size;
+      res = obu_dec_->DecodeFrame(data + offset, obu_size);
+      ASSERT_EQ(AOM_CODEC_OK, res) << obu_dec_->DecodeError();
+      offset += obu_size;
+      ::libaom_test::DxDataIterator obu_iter = obu_dec_->GetDxData();
+      const aom_image_t *const img = obu_iter.Next();
+      if (img != NULL) {
+        // Only the last tile group of the shown frame produces output.
+        EXPECT_TRUE(obu_img == NULL);
+        obu_img = img;
+        ::libaom_test::MD5 md5;
+        md5.Add(img);
+        obu_md5_ = md5.Get();
+      }
+    }
+
+    ASSERT_EQ(full_img != NULL, obu_img != NULL);
+    if (full_img != NULL) {
+      ::libaom_test::MD5 md5;
+      md5.Add(full_img);
+      EXPECT_EQ(std::string(md5.Get()), obu_md5_);
+      ++num_frames_;
+    }
+  }
+
+  int n_tile_groups_;
+  unsigned int threads_;
+  int num_frames_;
+  std::string obu_md5_;
+  ::libaom_test::Decoder *full_dec_;
+  ::libaom_test::Decoder *obu_dec_;
+};
+
+TEST_P(IncrementalDecodeTest, MatchesFullDecode) {
+  ::libaom_test::RandomVideoSource video;
+  video.SetSize(256, 128);
+  video.set_limit(8);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(8, num_frames_);
+}
+
+AV1_INSTANTIATE_TEST_CASE(IncrementalDecodeTest, ::testing::Values(1, 2, 4),
+                          ::testing::Values(1U, 2U));
+}  // namespace
@@ -92,6 +92,19 @@ lightfield_test() {
   if [ $? -eq 1 ]; then
     return 1
   fi
+
+  # Run lightfield tile list decoder with multiple threads, which decodes the
+  # tiles of each tile list concurrently.
+  local tl_mt_outfile="${AOM_TEST_OUTPUT_DIR}/vase_tile_list_mt.yuv"
+  eval "${AOM_TEST_PREFIX}" "${tl_decoder}" "${tl_file}" "${tl_mt_outfile}" \
+      "${num_references}" "${num_tile_lists}" 0 4 ${devnull}
+
+  [ -e "${tl_mt_outfile}" ] || return 1
+
+  diff ${tl_mt_outfile} ${tl_reffile} > /dev/null
+  if [ $? -eq 1 ]; then
+    return 1
+  fi
 }
 
 lightfield_test_tests="lightfield_test"
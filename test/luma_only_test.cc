@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "aom/aomdx.h"
+
+namespace {
+
+const int kFrames = 6;
+
+// Checks that the luma plane decoded with AV1D_SET_LUMA_ONLY matches the luma
+// plane of a regular decode.
+class LumaOnlyTest
+    : public ::libaom_test::CodecTestWith2Params<int, unsigned int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  LumaOnlyTest()
+      : EncoderTest(GET_PARAM(0)), lag_in_frames_(GET_PARAM(1)),
+        threads_(GET_PARAM(2)), num_frames_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads_;
+    cfg.allow_lowbitdepth = 1;
+    full_dec_ = codec_->CreateDecoder(cfg, 0);
+    luma_dec_ = codec_->CreateDecoder(cfg, 0);
+    luma_dec_->Control(AV1D_SET_LUMA_ONLY, 1);
+  }
+
+  virtual ~LumaOnlyTest() {
+    delete full_dec_;
+    delete luma_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = lag_in_frames_;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 5);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+    }
+  }
+
+  static std::string LumaMD5(const aom_image_t *img) {
+    const int bytes_per_sample = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+    ::libaom_test::MD5 md5;
+    const uint8_t *buf = img->planes[AOM_PLANE_Y];
+    for (unsigned int y = 0; y < img->d_h; ++y) {
+      md5.Add(buf, img->d_w * bytes_per_sample);
+      buf += img->stride[AOM_PLANE_Y];
+    }
+    return md5.Get();
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    uint8_t *const data = static_cast<uint8_t *>(pkt->data.frame.buf);
+    const size_t size = pkt->data.frame.sz;
+
+    aom_codec_err_t res = full_dec_->DecodeFrame(data, size);
+    ASSERT_EQ(AOM_CODEC_OK, res) << full_dec_->DecodeError();
+    res = luma_dec_->DecodeFrame(data, size);
+    ASSERT_EQ(AOM_CODEC_OK, res) << luma_dec_->DecodeError();
+
+    ::libaom_test::DxDataIterator full_iter = full_dec_->GetDxData();
+    ::libaom_test::DxDataIterator luma_iter = luma_dec_->GetDxData();
+    const aom_image_t *full_img;
+    while ((full_img = full_iter.Next()) != NULL) {
+      const aom_image_t *const luma_img = luma_iter.Next();
+      ASSERT_TRUE(luma_img != NULL);
+      EXPECT_FALSE(full_img->monochrome);
+      EXPECT_TRUE(luma_img->monochrome);
+      EXPECT_EQ(LumaMD5(full_img), LumaMD5(luma_img))
+          << "frame " << num_frames_;
+      ++num_frames_;
+    }
+    EXPECT_TRUE(luma_iter.Next() == NULL);
+  }
+
+  int lag_in_frames_;
+  unsigned int threads_;
+  int num_frames_;
+  ::libaom_test::Decoder *full_dec_;
+  ::libaom_test::Decoder *luma_dec_;
+};
+
+TEST_P(LumaOnlyTest, MatchesFullDecodeLuma) {
+  ::libaom_test::RandomVideoSource video;
+  video.SetSize(256, 144);
+  video.set_limit(kFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kFrames, num_frames_);
+}
+
+AV1_INSTANTIATE_TEST_CASE(LumaOnlyTest, ::testing::Values(0, 5),
+                          ::testing::Values(1U, 3U));
+}  // namespace
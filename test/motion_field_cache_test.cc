@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <climits>
+#include <cstring>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "av1/encoder/motion_field.h"
+
+namespace {
+
+class MotionFieldCacheTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() { memset(&cache_, 0, sizeof(cache_)); }
+  virtual void TearDown() { av1_free_motion_field_cache(&cache_); }
+
+  MotionFieldCache cache_;
+};
+
+TEST_F(MotionFieldCacheTest, NewFieldHasNoSearchedBlock) {
+  MotionField *const field =
+      av1_add_motion_field(&cache_, 0, 1, BLOCK_16X16, 100, 4, 6);
+  ASSERT_TRUE(field != NULL);
+  for (int i = 0; i < 4 * 6; ++i) EXPECT_EQ(INT_MAX, field->errs[i]);
+}
+
+TEST_F(MotionFieldCacheTest, KeyedOnFramesBlockSizeAndQindex) {
+  MotionField *const field =
+      av1_add_motion_field(&cache_, 0, 1, BLOCK_16X16, 100, 4, 6);
+  ASSERT_TRUE(field != NULL);
+  EXPECT_EQ(field,
+            av1_find_motion_field(&cache_, 0, 1, BLOCK_16X16, 100, 4, 6));
+  EXPECT_TRUE(av1_find_motion_field(&cache_, 1, 0, BLOCK_16X16, 100, 4, 6) ==
+              NULL);
+  EXPECT_TRUE(av1_find_motion_field(&cache_, 0, 1, BLOCK_8X8, 100, 4, 6) ==
+              NULL);
+  // The search costs of another q index differ, so the field is not reused.
+  EXPECT_TRUE(av1_find_motion_field(&cache_, 0, 1, BLOCK_16X16, 120, 4, 6) ==
+              NULL);
+  EXPECT_TRUE(av1_find_motion_field(&cache_, 0, 1, BLOCK_16X16, 100, 8, 12) ==
+              NULL);
+}
+
+TEST_F(MotionFieldCacheTest, KeepsCostLists) {
+  MotionField *field =
+      av1_add_motion_field(&cache_, 0, 1, BLOCK_16X16, 100, 2, 2);
+  ASSERT_TRUE(field != NULL);
+  for (int i = 0; i < 2 * 2; ++i) {
+    field->mvs[i].row = i;
+    field->mvs[i].col = -i;
+    field->errs[i] = 10 * i;
+    for (int j = 0; j < MOTION_FIELD_COST_LIST_SIZE; ++j) {
+      field->cost_lists[i][j] = 100 * i + j;
+    }
+  }
+  field = av1_find_motion_field(&cache_, 0, 1, BLOCK_16X16, 100, 2, 2);
+  ASSERT_TRUE(field != NULL);
+  for (int i = 0; i < 2 * 2; ++i) {
+    EXPECT_EQ(i, field->mvs[i].row);
+    EXPECT_EQ(-i, field->mvs[i].col);
+    EXPECT_EQ(10 * i, field->errs[i]);
+    for (int j = 0; j < MOTION_FIELD_COST_LIST_SIZE; ++j) {
+      EXPECT_EQ(100 * i + j, field->cost_lists[i][j]);
+    }
+  }
+}
+
+TEST_F(MotionFieldCacheTest, ReplacesOldestField) {
+  ASSERT_TRUE(av1_add_motion_field(&cache_, 0, 1, BLOCK_16X16, 100, 2, 2) !=
+              NULL);
+  for (int i = 1; i < MOTION_FIELD_CACHE_SIZE; ++i) {
+    ASSERT_TRUE(av1_add_motion_field(&cache_, i, i + 1, BLOCK_16X16, 100, 2,
+                                     2) != NULL);
+  }
+  EXPECT_TRUE(av1_find_motion_field(&cache_, 0, 1, BLOCK_16X16, 100, 2, 2) !=
+              NULL);
+
+  // A larger field replaces the oldest one and resets all its blocks.
+  MotionField *const field = av1_add_motion_field(
+      &cache_, MOTION_FIELD_CACHE_SIZE, 0, BLOCK_16X16, 100, 4, 4);
+  ASSERT_TRUE(field != NULL);
+  EXPECT_TRUE(av1_find_motion_field(&cache_, 0, 1, BLOCK_16X16, 100, 2, 2) ==
+              NULL);
+  EXPECT_TRUE(av1_find_motion_field(&cache_, 1, 2, BLOCK_16X16, 100, 2, 2) !=
+              NULL);
+  for (int i = 0; i < 4 * 4; ++i) EXPECT_EQ(INT_MAX, field->errs[i]);
+}
+
+TEST_F(MotionFieldCacheTest, ReusesFreedField) {
+  for (int i = 0; i < MOTION_FIELD_CACHE_SIZE; ++i) {
+    ASSERT_TRUE(av1_add_motion_field(&cache_, i, i + 1, BLOCK_16X16, 100, 2,
+                                     2) != NULL);
+  }
+  MotionField *field =
+      av1_find_motion_field(&cache_, 5, 6, BLOCK_16X16, 100, 2, 2);
+  ASSERT_TRUE(field != NULL);
+  av1_free_motion_field(field);
+  EXPECT_TRUE(av1_find_motion_field(&cache_, 5, 6, BLOCK_16X16, 100, 2, 2) ==
+              NULL);
+
+  // The freed field is taken instead of the oldest one.
+  field = av1_add_motion_field(&cache_, MOTION_FIELD_CACHE_SIZE, 0,
+                               BLOCK_16X16, 100, 2, 2);
+  ASSERT_TRUE(field != NULL);
+  EXPECT_TRUE(av1_find_motion_field(&cache_, 0, 1, BLOCK_16X16, 100, 2, 2) !=
+              NULL);
+  EXPECT_EQ(field, av1_find_motion_field(&cache_, MOTION_FIELD_CACHE_SIZE, 0,
+                                         BLOCK_16X16, 100, 2, 2));
+
+  // The next field replaces the oldest one.
+  ASSERT_TRUE(av1_add_motion_field(&cache_, MOTION_FIELD_CACHE_SIZE + 1, 0,
+                                   BLOCK_16X16, 100, 2, 2) != NULL);
+  EXPECT_TRUE(av1_find_motion_field(&cache_, 0, 1, BLOCK_16X16, 100, 2, 2) ==
+              NULL);
+}
+
+}  // namespace
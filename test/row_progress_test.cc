@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "aom/aomdx.h"
+
+namespace {
+
+const int kWidth = 208;
+const int kHeight = 200;
+const int kFrames = 4;
+
+// Moving luma ramps. A coarse quantizer leaves them blocky, which makes the
+// encoder use the loop filter.
+class RampVideoSource : public ::libaom_test::DummyVideoSource {
+ protected:
+  virtual void FillFrame() {
+    if (img_ == NULL) return;
+    for (unsigned int y = 0; y < img_->d_h; ++y) {
+      uint8_t *const row = img_->planes[AOM_PLANE_Y] + y * img_->stride[0];
+      for (unsigned int x = 0; x < img_->d_w; ++x)
+        row[x] = static_cast<uint8_t>(((x + frame_ * 3) * 5 + y * 3) & 0xff);
+    }
+    for (int plane = AOM_PLANE_U; plane <= AOM_PLANE_V; ++plane) {
+      for (unsigned int y = 0; y < (img_->d_h + 1) / 2; ++y) {
+        memset(img_->planes[plane] + y * img_->stride[plane], 128,
+               (img_->d_w + 1) / 2);
+      }
+    }
+  }
+};
+
+// Decodes with a row progress callback and checks that the reported ranges
+// of every frame are contiguous, cover the whole frame and hold the luma of
+// the output frame when they are reported.
+class RowProgressTest
+    : public ::libaom_test::CodecTestWith3Params<int, int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  RowProgressTest()
+      : EncoderTest(GET_PARAM(0)), lossless_(GET_PARAM(1)),
+        n_tile_cols_(GET_PARAM(2)), threads_(GET_PARAM(3)), enable_cdef_(1),
+        enable_restoration_(1), next_row_(0), num_calls_(0), num_frames_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads_;
+    cfg.allow_lowbitdepth = 1;
+    decoder_ = codec_->CreateDecoder(cfg, 0);
+    aom_row_progress_init init = { RowProgress, this };
+    decoder_->Control(AV1D_SET_ROW_PROGRESS_CALLBACK, &init);
+  }
+
+  virtual ~RowProgressTest() { delete decoder_; }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 5);
+      encoder->Control(AV1E_SET_LOSSLESS, lossless_);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, n_tile_cols_);
+      encoder->Control(AV1E_SET_ENABLE_CDEF, enable_cdef_);
+      encoder->Control(AV1E_SET_ENABLE_RESTORATION, enable_restoration_);
+    }
+  }
+
+  static void RowProgress(void *ctx, const aom_image_t *img, int start_row,
+                          int end_row) {
+    RowProgressTest *const test = static_cast<RowProgressTest *>(ctx);
+    EXPECT_EQ(kHeight, static_cast<int>(img->d_h));
+    EXPECT_EQ(test->next_row_, start_row);
+    EXPECT_LT(start_row, end_row);
+    EXPECT_LE(end_row, kHeight);
+    if (start_row < end_row && end_row <= kHeight) {
+      const int bps = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+      const int row_size = kWidth * bps;
+      test->luma_.resize(kHeight * row_size);
+      for (int r = start_row; r < end_row; ++r) {
+        memcpy(&test->luma_[r * row_size],
+               img->planes[AOM_PLANE_Y] + r * img->stride[AOM_PLANE_Y],
+               row_size);
+      }
+    }
+    test->next_row_ = end_row;
+    ++test->num_calls_;
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    next_row_ = 0;
+    const aom_codec_err_t res = decoder_->DecodeFrame(
+        reinterpret_cast<uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    ASSERT_EQ(AOM_CODEC_OK, res) << decoder_->DecodeError();
+    EXPECT_EQ(kHeight, next_row_);
+    ::libaom_test::DxDataIterator dec_iter = decoder_->GetDxData();
+    const aom_image_t *img = dec_iter.Next();
+    ASSERT_NE(img, nullptr);
+    const int bps = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+    const int row_size = kWidth * bps;
+    for (int r = 0; r < next_row_; ++r) {
+      ASSERT_EQ(0, memcmp(&luma_[r * row_size],
+                          img->planes[AOM_PLANE_Y] +
+                              r * img->stride[AOM_PLANE_Y],
+                          row_size))
+          << "Frame " << num_frames_ << " row " << r;
+    }
+    ++num_frames_;
+  }
+
+  int lossless_;
+  int n_tile_cols_;
+  unsigned int threads_;
+  int enable_cdef_;
+  int enable_restoration_;
+  std::vector<uint8_t> luma_;
+  int next_row_;
+  int num_calls_;
+  int num_frames_;
+  ::libaom_test::Decoder *decoder_;
+};
+
+TEST_P(RowProgressTest, ReportsWholeFrame) {
+  ::libaom_test::RandomVideoSource video;
+  video.SetSize(kWidth, kHeight);
+  video.set_limit(kFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kFrames, num_frames_);
+  if (lossless_) {
+    // Without post-filters, rows are reported superblock row by superblock
+    // row.
+    EXPECT_GT(num_calls_, num_frames_);
+  } else {
+    EXPECT_GE(num_calls_, num_frames_);
+  }
+}
+
+// Without CDEF, the rows are reported by the loop filter or the loop
+// restoration workers as they finish them.
+TEST_P(RowProgressTest, ReportsFilteredRows) {
+  enable_cdef_ = 0;
+  enable_restoration_ = 0;
+  cfg_.rc_min_quantizer = 60;
+  cfg_.rc_max_quantizer = 63;
+  RampVideoSource video;
+  video.SetSize(kWidth, kHeight);
+  video.set_limit(kFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kFrames, num_frames_);
+  if (threads_ > 1) {
+    EXPECT_GT(num_calls_, num_frames_);
+  }
+}
+
+TEST_P(RowProgressTest, ReportsRestoredRows) {
+  enable_cdef_ = 0;
+  cfg_.rc_min_quantizer = 60;
+  cfg_.rc_max_quantizer = 63;
+  RampVideoSource video;
+  video.SetSize(kWidth, kHeight);
+  video.set_limit(kFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kFrames, num_frames_);
+  if (threads_ > 1) {
+    EXPECT_GT(num_calls_, num_frames_);
+  }
+}
+
+AV1_INSTANTIATE_TEST_CASE(RowProgressTest, ::testing::Values(0, 1),
+                          ::testing::Values(0, 1), ::testing::Values(1, 3));
+}  // namespace
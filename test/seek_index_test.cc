@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "common/seek_index.h"
+
+namespace {
+
+TEST(SeekIndexTest, WriteReadFind) {
+  SeekIndex index;
+  memset(&index, 0, sizeof(index));
+  // Enough entries to grow the index more than once.
+  for (int i = 0; i < 200; ++i) {
+    ASSERT_EQ(0, seek_index_add(&index, 10 * i + 5, (1LL << 33) + 1000 * i));
+  }
+  index.file_size = (1LL << 34) + 3;
+
+  ::libaom_test::TempOutFile file;
+  ASSERT_EQ(0, seek_index_write(&index, file.file_name().c_str()));
+  seek_index_free(&index);
+
+  ASSERT_EQ(0, seek_index_read(&index, file.file_name().c_str()));
+  ASSERT_EQ(200, index.num_entries);
+  EXPECT_EQ((1LL << 34) + 3, index.file_size);
+
+  EXPECT_TRUE(seek_index_find(&index, 4) == NULL);
+  const SeekIndexEntry *entry = seek_index_find(&index, 5);
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ(5, entry->pts);
+  EXPECT_EQ(1LL << 33, entry->offset);
+  entry = seek_index_find(&index, 1004);
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ(995, entry->pts);
+  EXPECT_EQ((1LL << 33) + 99000, entry->offset);
+  entry = seek_index_find(&index, 1LL << 40);
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ(1995, entry->pts);
+  seek_index_free(&index);
+}
+
+TEST(SeekIndexTest, RejectsOtherFiles) {
+  SeekIndex index;
+  memset(&index, 0, sizeof(index));
+  ::libaom_test::TempOutFile file;
+  fputs("DKIF not a seek index", file.file());
+  fflush(file.file());
+  EXPECT_NE(0, seek_index_read(&index, file.file_name().c_str()));
+  EXPECT_EQ(0, index.num_entries);
+  seek_index_free(&index);
+}
+
+// Checks that the temporal units the encoder flags as key frames are the
+// random access points, and no others.
+class SeekIndexEncodeTest : public ::libaom_test::CodecTestWithParam<int>,
+                            public ::libaom_test::EncoderTest {
+ protected:
+  SeekIndexEncodeTest()
+      : EncoderTest(GET_PARAM(0)), annexb_(GET_PARAM(1)), key_frames_(0) {}
+
+  virtual ~SeekIndexEncodeTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.kf_min_dist = 0;
+    cfg_.kf_max_dist = 3;
+    cfg_.save_as_annexb = annexb_;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) encoder->Control(AOME_SET_CPUUSED, 5);
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const int is_key = (pkt->data.frame.flags & AOM_FRAME_IS_KEY) != 0;
+    key_frames_ += is_key;
+    EXPECT_EQ(is_key, seek_index_is_random_access_point(
+                          static_cast<const uint8_t *>(pkt->data.frame.buf),
+                          pkt->data.frame.sz, annexb_))
+        << "pts " << pkt->data.frame.pts;
+  }
+
+  // The test decoder is not set up for Annex B.
+  virtual bool DoDecode() const { return false; }
+
+  int annexb_;
+  int key_frames_;
+};
+
+TEST_P(SeekIndexEncodeTest, KeyFramesAreRandomAccessPoints) {
+  ::libaom_test::RandomVideoSource video;
+  video.SetSize(176, 144);
+  video.set_limit(10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_GT(key_frames_, 1);
+}
+
+AV1_INSTANTIATE_TEST_CASE(SeekIndexEncodeTest, ::testing::Values(0, 1));
+}  // namespace
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "aom/aomdx.h"
+
+namespace {
+
+const int kFrames = 10;
+const int kKeyFrameInterval = 6;
+
+// Encodes a stream in which every odd frame is not used as a reference, and
+// checks the output of AV1D_SET_SKIP_FRAMES and
+// AV1D_SET_SKIP_OUTPUT_ONLY_FILTERS against a regular decode.
+class SkipFramesTest
+    : public ::libaom_test::CodecTestWithParam<unsigned int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  SkipFramesTest()
+      : EncoderTest(GET_PARAM(0)), threads_(GET_PARAM(1)), frame_(0),
+        num_skipped_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads_;
+    cfg.allow_lowbitdepth = 1;
+    full_dec_ = codec_->CreateDecoder(cfg, 0);
+    non_ref_dec_ = codec_->CreateDecoder(cfg, 0);
+    non_ref_dec_->Control(AV1D_SET_SKIP_FRAMES, AOM_SKIP_FRAMES_NON_REFERENCE);
+    key_dec_ = codec_->CreateDecoder(cfg, 0);
+    key_dec_->Control(AV1D_SET_SKIP_FRAMES, AOM_SKIP_FRAMES_NON_KEY);
+    filter_dec_ = codec_->CreateDecoder(cfg, 0);
+    filter_dec_->Control(AV1D_SET_SKIP_OUTPUT_ONLY_FILTERS, 1);
+  }
+
+  virtual ~SkipFramesTest() {
+    delete full_dec_;
+    delete non_ref_dec_;
+    delete key_dec_;
+    delete filter_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.kf_mode = AOM_KF_DISABLED;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) encoder->Control(AOME_SET_CPUUSED, 5);
+    frame_flags_ = 0;
+    if (video->frame() % kKeyFrameInterval == 0) {
+      frame_flags_ |= AOM_EFLAG_FORCE_KF;
+    } else if (video->frame() % 2) {
+      frame_flags_ |=
+          AOM_EFLAG_NO_UPD_LAST | AOM_EFLAG_NO_UPD_GF | AOM_EFLAG_NO_UPD_ARF;
+    }
+  }
+
+  std::string Decode(::libaom_test::Decoder *decoder,
+                     const aom_codec_cx_pkt_t *pkt) {
+    const aom_codec_err_t res = decoder->DecodeFrame(
+        static_cast<uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    EXPECT_EQ(AOM_CODEC_OK, res) << decoder->DecodeError();
+    ::libaom_test::DxDataIterator iter = decoder->GetDxData();
+    const aom_image_t *const img = iter.Next();
+    if (img == NULL) return std::string();
+    ::libaom_test::MD5 md5;
+    md5.Add(img);
+    return md5.Get();
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const bool is_key = (pkt->data.frame.flags & AOM_FRAME_IS_KEY) != 0;
+    const bool is_ref = is_key || frame_ % 2 == 0;
+
+    const std::string full_md5 = Decode(full_dec_, pkt);
+    ASSERT_FALSE(full_md5.empty());
+
+    const std::string non_ref_md5 = Decode(non_ref_dec_, pkt);
+    if (is_ref) {
+      EXPECT_EQ(full_md5, non_ref_md5) << "frame " << frame_;
+    } else {
+      EXPECT_TRUE(non_ref_md5.empty()) << "frame " << frame_;
+      ++num_skipped_;
+    }
+
+    const std::string key_md5 = Decode(key_dec_, pkt);
+    if (is_key) {
+      EXPECT_EQ(full_md5, key_md5) << "frame " << frame_;
+    } else {
+      EXPECT_TRUE(key_md5.empty()) << "frame " << frame_;
+    }
+
+    // Skipping the filters of frames that are not referenced must not affect
+    // the frames that are.
+    const std::string filter_md5 = Decode(filter_dec_, pkt);
+    ASSERT_FALSE(filter_md5.empty());
+    if (is_ref) {
+      EXPECT_EQ(full_md5, filter_md5) << "frame " << frame_;
+    }
+
+    ++frame_;
+  }
+
+  unsigned int threads_;
+  int frame_;
+  int num_skipped_;
+  ::libaom_test::Decoder *full_dec_;
+  ::libaom_test::Decoder *non_ref_dec_;
+  ::libaom_test::Decoder *key_dec_;
+  ::libaom_test::Decoder *filter_dec_;
+};
+
+TEST_P(SkipFramesTest, MatchesFullDecode) {
+  ::libaom_test::RandomVideoSource video;
+  video.SetSize(208, 144);
+  video.set_limit(kFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kFrames, frame_);
+  EXPECT_GT(num_skipped_, 0);
+}
+
+AV1_INSTANTIATE_TEST_CASE(SkipFramesTest, ::testing::Values(1U, 2U));
+}  // namespace
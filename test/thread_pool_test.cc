@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "config/aom_config.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "aom/aom_thread_pool.h"
+#include "aom/aomdx.h"
+#include "aom_util/aom_thread.h"
+
+namespace {
+
+const int kFrames = 6;
+const int kPoolThreads = 2;
+const unsigned int kCodecThreads = 4;
+
+struct DecodeJob {
+  ::libaom_test::Decoder *decoder;
+  const uint8_t *data;
+  size_t size;
+  aom_codec_err_t res;
+};
+
+int DecodeJobHook(void *arg1, void * /*arg2*/) {
+  DecodeJob *const job = static_cast<DecodeJob *>(arg1);
+  job->res = job->decoder->DecodeFrame(job->data, job->size);
+  return 1;
+}
+
+// Checks that an encoder and two decoders sharing a pool with fewer threads
+// than each of them is configured with produce the same frames as a decoder
+// with threads of its own. The two decoders decode each frame at the same
+// time, from different threads.
+class ThreadPoolTest : public ::libaom_test::CodecTestWithParam<int>,
+                       public ::libaom_test::EncoderTest {
+ protected:
+  ThreadPoolTest()
+      : EncoderTest(GET_PARAM(0)), row_mt_(GET_PARAM(1)), num_frames_(0) {
+    pool_ = aom_thread_pool_create(kPoolThreads);
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = kCodecThreads;
+    cfg.allow_lowbitdepth = 1;
+    ref_dec_ = codec_->CreateDecoder(cfg, 0);
+    ref_dec_->Control(AV1D_SET_ROW_MT, row_mt_);
+    for (int i = 0; i < 2; ++i) {
+      pool_dec_[i] = codec_->CreateDecoder(cfg, 0);
+      pool_dec_[i]->Control(AV1D_SET_ROW_MT, row_mt_);
+      pool_dec_[i]->Control(AV1D_SET_THREAD_POOL, pool_);
+    }
+    aom_get_worker_interface()->init(&worker_);
+    worker_ok_ = aom_get_worker_interface()->reset(&worker_);
+  }
+
+  virtual ~ThreadPoolTest() {
+    aom_get_worker_interface()->end(&worker_);
+    delete ref_dec_;
+    delete pool_dec_[0];
+    delete pool_dec_[1];
+    aom_thread_pool_destroy(pool_);
+  }
+
+  virtual void SetUp() {
+    ASSERT_TRUE(worker_ok_);
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.g_threads = kCodecThreads;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AV1E_SET_THREAD_POOL, pool_);
+      encoder->Control(AOME_SET_CPUUSED, 5);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 2);
+    }
+  }
+
+  static std::string MD5(const aom_image_t *img) {
+    ::libaom_test::MD5 md5;
+    md5.Add(img);
+    return md5.Get();
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    uint8_t *const data = static_cast<uint8_t *>(pkt->data.frame.buf);
+    const size_t size = pkt->data.frame.sz;
+
+    aom_codec_err_t res = ref_dec_->DecodeFrame(data, size);
+    ASSERT_EQ(AOM_CODEC_OK, res) << ref_dec_->DecodeError();
+
+    // Decode with the second pooled decoder on another thread.
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    DecodeJob job = { pool_dec_[1], data, size, AOM_CODEC_ERROR };
+    worker_.hook = DecodeJobHook;
+    worker_.data1 = &job;
+    worker_.data2 = NULL;
+    winterface->launch(&worker_);
+    res = pool_dec_[0]->DecodeFrame(data, size);
+    ASSERT_TRUE(winterface->sync(&worker_));
+    ASSERT_EQ(AOM_CODEC_OK, res) << pool_dec_[0]->DecodeError();
+    ASSERT_EQ(AOM_CODEC_OK, job.res) << pool_dec_[1]->DecodeError();
+
+    ::libaom_test::DxDataIterator ref_iter = ref_dec_->GetDxData();
+    ::libaom_test::DxDataIterator iter0 = pool_dec_[0]->GetDxData();
+    ::libaom_test::DxDataIterator iter1 = pool_dec_[1]->GetDxData();
+    const aom_image_t *ref_img;
+    while ((ref_img = ref_iter.Next()) != NULL) {
+      const aom_image_t *const img0 = iter0.Next();
+      const aom_image_t *const img1 = iter1.Next();
+      ASSERT_TRUE(img0 != NULL);
+      ASSERT_TRUE(img1 != NULL);
+      const std::string ref_md5 = MD5(ref_img);
+      EXPECT_EQ(ref_md5, MD5(img0)) << "frame " << num_frames_;
+      EXPECT_EQ(ref_md5, MD5(img1)) << "frame " << num_frames_;
+      ++num_frames_;
+    }
+    EXPECT_TRUE(iter0.Next() == NULL);
+    EXPECT_TRUE(iter1.Next() == NULL);
+  }
+
+  int row_mt_;
+  int num_frames_;
+  aom_thread_pool_t *pool_;
+  ::libaom_test::Decoder *ref_dec_;
+  ::libaom_test::Decoder *pool_dec_[2];
+  AVxWorker worker_;
+  int worker_ok_;
+};
+
+TEST_P(ThreadPoolTest, MatchesOwnThreads) {
+#if CONFIG_MULTITHREAD
+  ASSERT_TRUE(pool_ != NULL);
+#endif
+  ::libaom_test::RandomVideoSource video;
+  video.SetSize(352, 288);
+  video.set_limit(kFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kFrames, num_frames_);
+}
+
+AV1_INSTANTIATE_TEST_CASE(ThreadPoolTest, ::testing::Values(0, 1));
+}  // namespace
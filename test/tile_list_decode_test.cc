@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "aom/aom_integer.h"
+#include "aom/aomdx.h"
+#include "aom_dsp/bitwriter_buffer.h"
+#include "aom_scale/yv12config.h"
+
+namespace {
+
+// 3x2 tiles of 64x64 pixels.
+const int kWidth = 192;
+const int kHeight = 128;
+const int kTileSize = 64;
+// One anchor frame followed by the camera frames.
+const int kFrames = 3;
+
+// A tile list entry: the camera frame, and the tile in it.
+struct TileListEntry {
+  int frame;
+  int tile_row;
+  int tile_col;
+};
+
+// The tiles of the 2x2 output frame, in raster order. Most of them are moved
+// to a slot above or to the left of their position in the camera frame.
+const TileListEntry kTileList[] = {
+  { 1, 1, 2 }, { 2, 0, 0 }, { 2, 0, 2 }, { 1, 1, 1 }
+};
+const int kOutputWidthInTiles = 2;
+const int kOutputHeightInTiles = 2;
+
+class PanVideoSource : public ::libaom_test::DummyVideoSource {
+ protected:
+  virtual void FillFrame() {
+    if (img_ == NULL) return;
+    for (int plane = AOM_PLANE_Y; plane <= AOM_PLANE_V; ++plane) {
+      const int shift = plane > AOM_PLANE_Y;
+      const unsigned int w = (img_->d_w + shift) >> shift;
+      const unsigned int h = (img_->d_h + shift) >> shift;
+      for (unsigned int y = 0; y < h; ++y) {
+        uint8_t *const row = img_->planes[plane] + y * img_->stride[plane];
+        for (unsigned int x = 0; x < w; ++x) {
+          const unsigned int u = x + frame_ * 2 + plane * 16;
+          row[x] = static_cast<uint8_t>(((u * u) >> 3) + y * 5);
+        }
+      }
+    }
+  }
+};
+
+// Encodes a small lightfield, turns the camera frames into a tile list and
+// checks that decoding the tile list with several threads, which reconstructs
+// the tiles in place in the output frame, matches the serial decoder.
+class TileListDecodeTest : public ::libaom_test::CodecTestWithParam<int>,
+                           public ::libaom_test::EncoderTest {
+ protected:
+  TileListDecodeTest() : EncoderTest(GET_PARAM(0)), threads_(GET_PARAM(1)) {}
+
+  virtual ~TileListDecodeTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.g_error_resilient = 0;
+    cfg_.kf_mode = AOM_KF_DISABLED;
+    cfg_.rc_end_usage = AOM_Q;
+  }
+
+  virtual bool DoDecode() const { return false; }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 5);
+      encoder->Control(AOME_SET_CQ_LEVEL, 36);
+      encoder->Control(AOME_SET_ENABLEAUTOALTREF, 0);
+      encoder->Control(AV1E_SET_FRAME_PARALLEL_DECODING, 0);
+      encoder->Control(AV1E_SET_SUPERBLOCK_SIZE, AOM_SUPERBLOCK_SIZE_64X64);
+    } else if (video->frame() == 1) {
+      // The camera frames are coded in large scale tiles, and only refer to
+      // the anchor frame.
+      aom_codec_enc_cfg_t cfg = cfg_;
+      cfg.g_w = kWidth;
+      cfg.g_h = kHeight;
+      cfg.large_scale_tile = 1;
+      encoder->Config(&cfg);
+      encoder->Control(AV1E_SET_FRAME_PARALLEL_DECODING, 1);
+      encoder->Control(AV1E_SET_SINGLE_TILE_DECODING, 1);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 6);
+      encoder->Control(AV1E_SET_TILE_ROWS, 6);
+    }
+    frame_flags_ = AOM_EFLAG_NO_REF_LAST2 | AOM_EFLAG_NO_REF_LAST3 |
+                   AOM_EFLAG_NO_REF_GF | AOM_EFLAG_NO_REF_ARF |
+                   AOM_EFLAG_NO_REF_BWD | AOM_EFLAG_NO_REF_ARF2 |
+                   AOM_EFLAG_NO_UPD_LAST | AOM_EFLAG_NO_UPD_GF |
+                   AOM_EFLAG_NO_UPD_ARF | AOM_EFLAG_NO_UPD_ENTROPY;
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frames_.push_back(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+  }
+
+  // Builds the stream of the tile list decoder, as the lightfield examples do:
+  // the anchor frame, the frame header of the camera frames and a tile list
+  // OBU.
+  void BuildTileListStream() {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.allow_lowbitdepth = 1;
+    std::unique_ptr<libaom_test::Decoder> decoder(
+        codec_->CreateDecoder(cfg, 0));
+    aom_codec_ctx_t *const ctx = decoder->GetDecoder();
+
+    decoder->Control(AV1_SET_TILE_MODE, 0);
+    ASSERT_EQ(AOM_CODEC_OK,
+              decoder->DecodeFrame(&frames_[0][0], frames_[0].size()));
+    ASSERT_EQ(AOM_CODEC_OK,
+              aom_codec_control(ctx, AV1_COPY_NEW_FRAME_IMAGE, &anchor_));
+    anchor_frame_ = frames_[0];
+
+    decoder->Control(AV1_SET_TILE_MODE, 1);
+    decoder->Control(AV1D_EXT_TILE_DEBUG, 1);
+    decoder->Control(AV1_SET_DECODE_TILE_ROW, 0);
+    decoder->Control(AV1_SET_DECODE_TILE_COL, 0);
+    ASSERT_EQ(AOM_CODEC_OK,
+              decoder->DecodeFrame(&frames_[1][0], frames_[1].size()));
+    aom_tile_data header = { 0, NULL, 0 };
+    // AV1D_GET_FRAME_HEADER_INFO reports AOM_CODEC_INVALID_PARAM even when it
+    // succeeds, so its result is checked through 'header'.
+    aom_codec_control(ctx, AV1D_GET_FRAME_HEADER_INFO, &header);
+    ASSERT_TRUE(header.coded_tile_data != NULL);
+    // Keep the frame header OBU without the large scale tile info, and fix
+    // its size up.
+    const size_t obu_size_offset =
+        static_cast<const uint8_t *>(header.coded_tile_data) - &frames_[1][0];
+    const size_t length_field_size = header.coded_tile_data_size;
+    const uint32_t frame_header_size = (uint32_t)header.extra_size - 1;
+    frame_header_.assign(frames_[1].begin(),
+                         frames_[1].begin() + obu_size_offset +
+                             length_field_size + frame_header_size);
+    size_t bytes_written = 0;
+    ASSERT_EQ(0, aom_uleb_encode_fixed_size(
+                     frame_header_size, length_field_size, length_field_size,
+                     &frame_header_[obu_size_offset], &bytes_written));
+
+    // The tile list OBU, with a 4-byte size field.
+    const int num_tiles = sizeof(kTileList) / sizeof(kTileList[0]);
+    tile_list_.assign(9, 0);
+    struct aom_write_bit_buffer wb = { &tile_list_[0], 0 };
+    aom_wb_write_literal(&wb, 0, 1);  // forbidden bit.
+    aom_wb_write_literal(&wb, 8, 4);  // tile list OBU: "1000"
+    aom_wb_write_literal(&wb, 0, 1);  // obu_extension = 0
+    aom_wb_write_literal(&wb, 1, 1);  // obu_has_size_field
+    aom_wb_write_literal(&wb, 0, 1);  // reserved
+    wb.bit_buffer = &tile_list_[5];
+    wb.bit_offset = 0;
+    aom_wb_write_literal(&wb, kOutputWidthInTiles - 1, 8);
+    aom_wb_write_literal(&wb, kOutputHeightInTiles - 1, 8);
+    aom_wb_write_literal(&wb, num_tiles - 1, 16);
+    for (int i = 0; i < num_tiles; ++i) {
+      const TileListEntry &entry = kTileList[i];
+      const std::vector<uint8_t> &frame = frames_[entry.frame];
+      decoder->Control(AV1_SET_DECODE_TILE_ROW, entry.tile_row);
+      decoder->Control(AV1_SET_DECODE_TILE_COL, entry.tile_col);
+      ASSERT_EQ(AOM_CODEC_OK, decoder->DecodeFrame(&frame[0], frame.size()));
+      aom_tile_data tile = { 0, NULL, 0 };
+      ASSERT_EQ(AOM_CODEC_OK,
+                aom_codec_control(ctx, AV1D_GET_TILE_DATA, &tile));
+
+      uint8_t info[5];
+      wb.bit_buffer = info;
+      wb.bit_offset = 0;
+      aom_wb_write_literal(&wb, 0, 8);  // anchor_frame_idx
+      aom_wb_write_literal(&wb, entry.tile_row, 8);
+      aom_wb_write_literal(&wb, entry.tile_col, 8);
+      aom_wb_write_literal(&wb, (int)tile.coded_tile_data_size - 1, 16);
+      tile_list_.insert(tile_list_.end(), info, info + sizeof(info));
+      const uint8_t *const tile_data =
+          static_cast<const uint8_t *>(tile.coded_tile_data);
+      tile_list_.insert(tile_list_.end(), tile_data,
+                        tile_data + tile.coded_tile_data_size);
+    }
+    ASSERT_EQ(0, aom_uleb_encode_fixed_size(tile_list_.size() - 5, 4, 4,
+                                            &tile_list_[1], &bytes_written));
+  }
+
+  // Decodes the tile list stream and returns the MD5 of the output frame.
+  std::string DecodeTileList(unsigned int threads) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads;
+    cfg.allow_lowbitdepth = 1;
+    std::unique_ptr<libaom_test::Decoder> decoder(
+        codec_->CreateDecoder(cfg, 0));
+
+    decoder->Control(AV1_SET_TILE_MODE, 0);
+    EXPECT_EQ(AOM_CODEC_OK,
+              decoder->DecodeFrame(&anchor_frame_[0], anchor_frame_.size()));
+    decoder->Control(AV1_SET_TILE_MODE, 1);
+    av1_ext_ref_frame_t ext_refs = { &anchor_, 1 };
+    decoder->Control(AV1D_SET_EXT_REF_PTR, &ext_refs);
+    EXPECT_EQ(AOM_CODEC_OK,
+              decoder->DecodeFrame(&frame_header_[0], frame_header_.size()));
+    EXPECT_EQ(AOM_CODEC_OK,
+              decoder->DecodeFrame(&tile_list_[0], tile_list_.size()))
+        << decoder->DecodeError();
+
+    std::string md5;
+    ::libaom_test::DxDataIterator dec_iter = decoder->GetDxData();
+    const aom_image_t *const img = dec_iter.Next();
+    EXPECT_TRUE(img != NULL);
+    if (img != NULL) {
+      EXPECT_EQ(kOutputWidthInTiles * kTileSize, (int)img->d_w);
+      EXPECT_EQ(kOutputHeightInTiles * kTileSize, (int)img->d_h);
+      ::libaom_test::MD5 md5_res;
+      md5_res.Add(img);
+      md5 = md5_res.Get();
+    }
+    return md5;
+  }
+
+  void DoTest() {
+    PanVideoSource video;
+    video.SetSize(kWidth, kHeight);
+    video.set_limit(kFrames);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(kFrames, (int)frames_.size());
+
+    ASSERT_TRUE(aom_img_alloc_with_border(&anchor_, AOM_IMG_FMT_I420, kWidth,
+                                          kHeight, 32, 8,
+                                          AOM_DEC_BORDER_IN_PIXELS) != NULL);
+    BuildTileListStream();
+    if (!HasFatalFailure()) {
+      const std::string serial_md5 = DecodeTileList(1);
+      const std::string mt_md5 = DecodeTileList(threads_);
+      EXPECT_FALSE(serial_md5.empty());
+      EXPECT_EQ(serial_md5, mt_md5);
+    }
+    aom_img_free(&anchor_);
+  }
+
+  unsigned int threads_;
+  std::vector<std::vector<uint8_t> > frames_;
+  std::vector<uint8_t> anchor_frame_;
+  std::vector<uint8_t> frame_header_;
+  std::vector<uint8_t> tile_list_;
+  aom_image_t anchor_;
+};
+
+TEST_P(TileListDecodeTest, MatchesSerialDecode) { DoTest(); }
+
+AV1_INSTANTIATE_TEST_CASE(TileListDecodeTest, ::testing::Values(2, 4));
+
+}  // namespace
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "aom/aomdx.h"
+
+namespace {
+
+const int kFrames = 4;
+const int kWidth = 256;
+const int kHeight = 256;
+// The frames are coded as 2x2 tiles of kTileSize x kTileSize luma pixels.
+const int kTileSize = 128;
+// Luma pixels near the edge of the selected area that may depend on the
+// tiles that are not decoded.
+const int kMargin = 16;
+
+// Checks that the selected tiles decoded with AV1D_SET_TILE_MASK match a
+// regular decode, and that a mask selecting every tile gives the same frames.
+class TileMaskTest
+    : public ::libaom_test::CodecTestWith2Params<uint32_t, unsigned int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  TileMaskTest()
+      : EncoderTest(GET_PARAM(0)), tile_mask_(GET_PARAM(1)),
+        threads_(GET_PARAM(2)), num_frames_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads_;
+    cfg.allow_lowbitdepth = 1;
+    full_dec_ = codec_->CreateDecoder(cfg, 0);
+    all_dec_ = codec_->CreateDecoder(cfg, 0);
+    mask_dec_ = codec_->CreateDecoder(cfg, 0);
+
+    aom_tile_mask_t mask = aom_tile_mask_t();
+    for (int i = 0; i < AOM_TILE_MASK_WORDS; ++i) mask.mask[i] = ~0u;
+    all_dec_->Control(AV1D_SET_TILE_MASK, &mask);
+    mask.mask[0] = tile_mask_;
+    for (int i = 1; i < AOM_TILE_MASK_WORDS; ++i) mask.mask[i] = 0;
+    mask_dec_->Control(AV1D_SET_TILE_MASK, &mask);
+  }
+
+  virtual ~TileMaskTest() {
+    delete full_dec_;
+    delete all_dec_;
+    delete mask_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    // Intra-only frames do not predict from outside of the selected tiles.
+    cfg_.kf_max_dist = 0;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 5);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+      encoder->Control(AV1E_SET_TILE_ROWS, 1);
+    }
+  }
+
+  static std::string MD5(const aom_image_t *img) {
+    ::libaom_test::MD5 md5;
+    md5.Add(img);
+    return md5.Get();
+  }
+
+  // Compares the pixels of the tile at (tile_row, tile_col) that are at least
+  // kMargin luma pixels away from its edges.
+  static void CompareTileInterior(const aom_image_t *ref,
+                                  const aom_image_t *img, int tile_row,
+                                  int tile_col) {
+    const int bytes_per_sample = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int ss_x = plane ? img->x_chroma_shift : 0;
+      const int ss_y = plane ? img->y_chroma_shift : 0;
+      const int x0 = (tile_col * kTileSize + kMargin) >> ss_x;
+      const int x1 = ((tile_col + 1) * kTileSize - kMargin) >> ss_x;
+      const int y0 = (tile_row * kTileSize + kMargin) >> ss_y;
+      const int y1 = ((tile_row + 1) * kTileSize - kMargin) >> ss_y;
+      for (int y = y0; y < y1; ++y) {
+        const uint8_t *const ref_row = ref->planes[plane] +
+                                       y * ref->stride[plane] +
+                                       x0 * bytes_per_sample;
+        const uint8_t *const row =
+            img->planes[plane] + y * img->stride[plane] + x0 * bytes_per_sample;
+        ASSERT_EQ(0, memcmp(ref_row, row, (x1 - x0) * bytes_per_sample))
+            << "tile " << tile_row << "," << tile_col << " plane " << plane
+            << " row " << y;
+      }
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    uint8_t *const data = static_cast<uint8_t *>(pkt->data.frame.buf);
+    const size_t size = pkt->data.frame.sz;
+
+    aom_codec_err_t res = full_dec_->DecodeFrame(data, size);
+    ASSERT_EQ(AOM_CODEC_OK, res) << full_dec_->DecodeError();
+    res = all_dec_->DecodeFrame(data, size);
+    ASSERT_EQ(AOM_CODEC_OK, res) << all_dec_->DecodeError();
+    res = mask_dec_->DecodeFrame(data, size);
+    ASSERT_EQ(AOM_CODEC_OK, res) << mask_dec_->DecodeError();
+
+    ::libaom_test::DxDataIterator full_iter = full_dec_->GetDxData();
+    ::libaom_test::DxDataIterator all_iter = all_dec_->GetDxData();
+    ::libaom_test::DxDataIterator mask_iter = mask_dec_->GetDxData();
+    const aom_image_t *full_img;
+    while ((full_img = full_iter.Next()) != NULL) {
+      const aom_image_t *const all_img = all_iter.Next();
+      const aom_image_t *const mask_img = mask_iter.Next();
+      ASSERT_TRUE(all_img != NULL);
+      ASSERT_TRUE(mask_img != NULL);
+      EXPECT_EQ(MD5(full_img), MD5(all_img)) << "frame " << num_frames_;
+      for (int tile = 0; tile < 4; ++tile) {
+        if (!((tile_mask_ >> tile) & 1)) continue;
+        ASSERT_NO_FATAL_FAILURE(
+            CompareTileInterior(full_img, mask_img, tile / 2, tile % 2))
+            << "frame " << num_frames_;
+      }
+      ++num_frames_;
+    }
+    EXPECT_TRUE(all_iter.Next() == NULL);
+    EXPECT_TRUE(mask_iter.Next() == NULL);
+  }
+
+  uint32_t tile_mask_;
+  unsigned int threads_;
+  int num_frames_;
+  ::libaom_test::Decoder *full_dec_;
+  ::libaom_test::Decoder *all_dec_;
+  ::libaom_test::Decoder *mask_dec_;
+};
+
+TEST_P(TileMaskTest, SelectedTilesMatchFullDecode) {
+  ::libaom_test::RandomVideoSource video;
+  video.SetSize(kWidth, kHeight);
+  video.set_limit(kFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kFrames, num_frames_);
+}
+
+AV1_INSTANTIATE_TEST_CASE(TileMaskTest, ::testing::Values(0x9u, 0x2u),
+                          ::testing::Values(1U, 3U));
+}  // namespace
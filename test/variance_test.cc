@@ -47,6 +47,9 @@ typedef unsigned int (*DistWtdSubpixAvgVarMxNFunc)(
     const uint8_t *a, int a_stride, int xoffset, int yoffset, const uint8_t *b,
     int b_stride, uint32_t *sse, const uint8_t *second_pred,
     const DIST_WTD_COMP_PARAMS *jcp_param);
+typedef uint64_t (*Mse16bitFunc)(const uint16_t *dst, int dstride,
+                                 const uint16_t *src, int sstride, int w,
+                                 int h);
 typedef uint32_t (*ObmcSubpelVarFunc)(const uint8_t *pre, int pre_stride,
                                       int xoffset, int yoffset,
                                       const int32_t *wsrc, const int32_t *mask,
@@ -366,6 +369,56 @@ void SumOfSquaresTest::RefTest() {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+class Mse16bitTest : public ::testing::TestWithParam<Mse16bitFunc> {
+ public:
+  Mse16bitTest() : func_(GetParam()) {}
+
+  virtual ~Mse16bitTest() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void RefTest();
+  void MaxTest();
+
+  Mse16bitFunc func_;
+  ACMRandom rnd_;
+};
+
+void Mse16bitTest::RefTest() {
+  uint16_t dst[16 * 8];
+  uint16_t src[8 * 8];
+  for (int i = 0; i < 100; ++i) {
+    const int mask = (1 << (8 + 2 * (i % 3))) - 1;
+    for (int j = 0; j < 16 * 8; ++j) dst[j] = rnd_.Rand16() & mask;
+    for (int j = 0; j < 8 * 8; ++j) src[j] = rnd_.Rand16() & mask;
+    for (int w = 4; w <= 8; w += 4) {
+      for (int h = 4; h <= 8; h += 4) {
+        const uint64_t expected = aom_mse_wxh_16bit_c(dst, 16, src, w, w, h);
+        uint64_t res;
+        ASM_REGISTER_STATE_CHECK(res = func_(dst, 16, src, w, w, h));
+        EXPECT_EQ(expected, res) << "w " << w << " h " << h;
+      }
+    }
+  }
+}
+
+void Mse16bitTest::MaxTest() {
+  uint16_t dst[8 * 8];
+  uint16_t src[8 * 8];
+  for (int j = 0; j < 8 * 8; ++j) {
+    dst[j] = (j & 1) ? 4095 : 0;
+    src[j] = (j & 1) ? 0 : 4095;
+  }
+  for (int w = 4; w <= 8; w += 4) {
+    for (int h = 4; h <= 8; h += 4) {
+      uint64_t res;
+      ASM_REGISTER_STATE_CHECK(res = func_(dst, 8, src, 8, w, h));
+      EXPECT_EQ(static_cast<uint64_t>(w * h) * 4095 * 4095, res);
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Encapsulating struct to store the function to test along with
 // some testing context.
@@ -1073,6 +1126,8 @@ TEST_P(AvxVarianceTest, OneQuarter) { OneQuarterTest(); }
 TEST_P(AvxVarianceTest, DISABLED_Speed) { SpeedTest(); }
 TEST_P(SumOfSquaresTest, Const) { ConstTest(); }
 TEST_P(SumOfSquaresTest, Ref) { RefTest(); }
+TEST_P(Mse16bitTest, Ref) { RefTest(); }
+TEST_P(Mse16bitTest, Max) { MaxTest(); }
 TEST_P(AvxSubpelVarianceTest, Ref) { RefTest(); }
 TEST_P(AvxSubpelVarianceTest, ExtremeRef) { ExtremeRefTest(); }
 TEST_P(AvxSubpelAvgVarianceTest, Ref) { RefTest(); }
@@ -1084,6 +1139,9 @@ TEST_P(AvxObmcSubpelVarianceTest, DISABLED_Speed) { SpeedTest(); }
 INSTANTIATE_TEST_CASE_P(C, SumOfSquaresTest,
                         ::testing::Values(aom_get_mb_ss_c));
 
+INSTANTIATE_TEST_CASE_P(C, Mse16bitTest,
+                        ::testing::Values(aom_mse_wxh_16bit_c));
+
 typedef TestParams<Get4x4SseFunc> SseParams;
 INSTANTIATE_TEST_CASE_P(C, AvxSseTest,
                         ::testing::Values(SseParams(2, 2,
@@ -1675,6 +1733,9 @@ INSTANTIATE_TEST_CASE_P(C, AvxHBDObmcSubpelVarianceTest,
 INSTANTIATE_TEST_CASE_P(SSE2, SumOfSquaresTest,
                         ::testing::Values(aom_get_mb_ss_sse2));
 
+INSTANTIATE_TEST_CASE_P(SSE2, Mse16bitTest,
+                        ::testing::Values(aom_mse_wxh_16bit_sse2));
+
 INSTANTIATE_TEST_CASE_P(SSE2, AvxMseTest,
                         ::testing::Values(MseParams(4, 4, &aom_mse16x16_sse2),
                                           MseParams(4, 3, &aom_mse16x8_sse2),
@@ -2242,6 +2303,9 @@ INSTANTIATE_TEST_CASE_P(
 INSTANTIATE_TEST_CASE_P(AVX2, AvxMseTest,
                         ::testing::Values(MseParams(4, 4, &aom_mse16x16_avx2)));
 
+INSTANTIATE_TEST_CASE_P(AVX2, Mse16bitTest,
+                        ::testing::Values(aom_mse_wxh_16bit_avx2));
+
 INSTANTIATE_TEST_CASE_P(
     AVX2, AvxVarianceTest,
     ::testing::Values(VarianceParams(7, 7, &aom_variance128x128_avx2),
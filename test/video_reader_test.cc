@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "config/aom_config.h"
+
+#if HAVE_UNISTD_H && !defined(_WIN32)
+#include <unistd.h>
+#define MMAP_AVAILABLE 1
+#else
+#define MMAP_AVAILABLE 0
+#endif
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/video_source.h"
+#include "aom_ports/mem_ops.h"
+#include "common/video_reader.h"
+
+namespace {
+
+// Checks that AvxVideoReader returns the frames of IVF and Annex B OBU files,
+// mapped into memory where possible, and that aom_video_reader_seek() returns
+// to an offset from aom_video_reader_tell().
+class VideoReaderTest : public ::testing::Test {
+ protected:
+  void Write(const std::string &data) {
+    ASSERT_EQ(data.size(), fwrite(data.data(), 1, data.size(), file_.file()));
+  }
+
+  void WriteIvfFileHeader() {
+    char header[32] = { 'D', 'K', 'I', 'F' };
+    mem_put_le16(header + 6, 32);
+    mem_put_le32(header + 8, 0x31305641);  // AV01
+    mem_put_le16(header + 12, 352);
+    mem_put_le16(header + 14, 288);
+    mem_put_le32(header + 16, 30);
+    mem_put_le32(header + 20, 1);
+    Write(std::string(header, sizeof(header)));
+  }
+
+  void WriteIvfFrame(const std::string &frame, int64_t pts) {
+    char header[12];
+    mem_put_le32(header, static_cast<int>(frame.size()));
+    mem_put_le32(header + 4, static_cast<int>(pts & 0xFFFFFFFF));
+    mem_put_le32(header + 8, static_cast<int>(pts >> 32));
+    Write(std::string(header, sizeof(header)));
+    Write(frame);
+  }
+
+  // Writes an IVF file of 'frames', whose pts are (i << 32) + 7.
+  void WriteIvfFile(const std::vector<std::string> &frames) {
+    ASSERT_NO_FATAL_FAILURE(WriteIvfFileHeader());
+    for (size_t i = 0; i < frames.size(); ++i) {
+      const int64_t pts = (static_cast<int64_t>(i) << 32) + 7;
+      ASSERT_NO_FATAL_FAILURE(WriteIvfFrame(frames[i], pts));
+    }
+  }
+
+  AvxVideoReader *Open() {
+    fflush(file_.file());
+    return aom_video_reader_open(file_.file_name().c_str());
+  }
+
+  static std::string Frame(AvxVideoReader *reader) {
+    size_t size = 0;
+    const uint8_t *const frame = aom_video_reader_get_frame(reader, &size);
+    return std::string(reinterpret_cast<const char *>(frame), size);
+  }
+
+  ::libaom_test::TempOutFile file_;
+};
+
+TEST_F(VideoReaderTest, ReadsIvfFrames) {
+  std::vector<std::string> frames;
+  frames.push_back(std::string("\x12\x00\x0a\x0b", 4));
+  frames.push_back(std::string(1000, 'a'));
+  frames.push_back(std::string("\x32", 1));
+  ASSERT_NO_FATAL_FAILURE(WriteIvfFile(frames));
+  // A truncated frame ends the file.
+  ASSERT_NO_FATAL_FAILURE(Write(std::string("\x10\x00\x00\x00", 4)));
+
+  AvxVideoReader *const reader = Open();
+  ASSERT_TRUE(reader != NULL);
+  EXPECT_EQ(MMAP_AVAILABLE, aom_video_reader_is_mapped(reader));
+  EXPECT_EQ(352, aom_video_reader_get_info(reader)->frame_width);
+  EXPECT_EQ(288, aom_video_reader_get_info(reader)->frame_height);
+
+  int64_t second_frame_pos = 0;
+  for (size_t i = 0; i < frames.size(); ++i) {
+    if (i == 1) second_frame_pos = aom_video_reader_tell(reader);
+    ASSERT_TRUE(aom_video_reader_read_frame(reader)) << "frame " << i;
+    EXPECT_EQ(frames[i], Frame(reader)) << "frame " << i;
+    EXPECT_EQ((static_cast<int64_t>(i) << 32) + 7,
+              aom_video_reader_get_frame_pts(reader));
+  }
+  EXPECT_FALSE(aom_video_reader_read_frame(reader));
+
+  ASSERT_EQ(0, aom_video_reader_seek(reader, second_frame_pos));
+  for (size_t i = 1; i < frames.size(); ++i) {
+    ASSERT_TRUE(aom_video_reader_read_frame(reader)) << "frame " << i;
+    EXPECT_EQ(frames[i], Frame(reader)) << "frame " << i;
+  }
+  aom_video_reader_close(reader);
+}
+
+TEST_F(VideoReaderTest, ReadsAnnexBTemporalUnits) {
+  // Each temporal unit has its size, then a frame unit with a temporal
+  // delimiter, and the second one a padding OBU.
+  std::vector<std::string> units;
+  units.push_back(std::string("\x03\x02\x01\x10", 4));
+  units.push_back(std::string("\x08\x07\x01\x10\x04\x78\x01\x02\x03", 9));
+  units.push_back(std::string("\x03\x02\x01\x10", 4));
+  for (size_t i = 0; i < units.size(); ++i) {
+    ASSERT_NO_FATAL_FAILURE(Write(units[i]));
+  }
+
+  AvxVideoReader *const reader = Open();
+  ASSERT_TRUE(reader != NULL);
+  EXPECT_EQ(1, aom_video_reader_get_info(reader)->is_annexb);
+  EXPECT_EQ(MMAP_AVAILABLE, aom_video_reader_is_mapped(reader));
+
+  for (size_t i = 0; i < units.size(); ++i) {
+    ASSERT_TRUE(aom_video_reader_read_frame(reader)) << "unit " << i;
+    EXPECT_EQ(units[i], Frame(reader)) << "unit " << i;
+  }
+  EXPECT_FALSE(aom_video_reader_read_frame(reader));
+  aom_video_reader_close(reader);
+}
+
+#if MMAP_AVAILABLE
+// A pipe cannot be mapped, so its frames are read into the buffer instead.
+TEST_F(VideoReaderTest, ReadsIvfFramesFromPipe) {
+  std::vector<std::string> frames;
+  frames.push_back(std::string("\x12\x00\x0a\x0b", 4));
+  frames.push_back(std::string(1000, 'a'));
+  ASSERT_NO_FATAL_FAILURE(WriteIvfFile(frames));
+  fflush(file_.file());
+  std::string contents;
+  FILE *const file = fopen(file_.file_name().c_str(), "rb");
+  ASSERT_TRUE(file != NULL);
+  char buf[256];
+  size_t size;
+  while ((size = fread(buf, 1, sizeof(buf), file)) > 0) {
+    contents.append(buf, size);
+  }
+  fclose(file);
+
+  // The file is smaller than the pipe buffer, so it is written at once.
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  ASSERT_EQ(static_cast<ssize_t>(contents.size()),
+            write(fds[1], contents.data(), contents.size()));
+  close(fds[1]);
+  char pipe_name[32];
+  snprintf(pipe_name, sizeof(pipe_name), "/dev/fd/%d", fds[0]);
+  AvxVideoReader *const reader = aom_video_reader_open(pipe_name);
+  close(fds[0]);
+  ASSERT_TRUE(reader != NULL);
+  EXPECT_EQ(0, aom_video_reader_is_mapped(reader));
+
+  for (size_t i = 0; i < frames.size(); ++i) {
+    ASSERT_TRUE(aom_video_reader_read_frame(reader)) << "frame " << i;
+    EXPECT_EQ(frames[i], Frame(reader)) << "frame " << i;
+    EXPECT_EQ((static_cast<int64_t>(i) << 32) + 7,
+              aom_video_reader_get_frame_pts(reader));
+  }
+  EXPECT_FALSE(aom_video_reader_read_frame(reader));
+  aom_video_reader_close(reader);
+}
+#endif  // MMAP_AVAILABLE
+
+}  // namespace